@@ -288,15 +288,15 @@ void AutoType::performGlobalAutoType(const QList<Database*>& dbList)
     QList<AutoTypeMatch> matchList;
 
     for (Database* db : dbList) {
-        const QList<Entry*> dbEntries = db->rootGroup()->entriesRecursive();
-        for (Entry* entry : dbEntries) {
+        db->rootGroup()->walkEntries([this, &matchList, &windowTitle](Entry* entry) {
             const QSet<QString> sequences = autoTypeSequences(entry, windowTitle).toSet();
             for (const QString& sequence : sequences) {
                 if (!sequence.isEmpty()) {
                     matchList << AutoTypeMatch(entry, sequence);
                 }
             }
-        }
+            return false;
+        });
     }
 
     if (matchList.isEmpty()) {
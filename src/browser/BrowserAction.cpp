@@ -29,8 +29,20 @@
 BrowserAction::BrowserAction(BrowserService& browserService)
     : m_mutex(QMutex::Recursive)
     , m_browserService(browserService)
-    , m_associated(false)
 {
+    m_associated.store(false);
+}
+
+/**
+ * Actions that only read the database. They don't need the GUI thread
+ * unless the user has to confirm access to entries.
+ */
+bool BrowserAction::isReadOnlyAction(const QString& action)
+{
+    return action.compare("get-logins", Qt::CaseSensitive) == 0
+           || action.compare("get-logins-batch", Qt::CaseSensitive) == 0
+           || action.compare("test-associate", Qt::CaseSensitive) == 0
+           || action.compare("get-databasehash", Qt::CaseSensitive) == 0;
 }
 
 QJsonObject BrowserAction::readResponse(const QJsonObject& json)
@@ -50,9 +62,8 @@ QJsonObject BrowserAction::readResponse(const QJsonObject& json)
         return QJsonObject();
     }
 
-    QMutexLocker locker(&m_mutex);
     if (action.compare("change-public-keys", Qt::CaseSensitive) != 0 && !m_browserService.isDatabaseOpened()) {
-        if (m_clientPublicKey.isEmpty()) {
+        if (clientPublicKey().isEmpty()) {
             return getErrorReply(action, ERROR_KEEPASS_CLIENT_PUBLIC_KEY_NOT_RECEIVED);
         } else if (!m_browserService.openDatabase(triggerUnlock)) {
             return getErrorReply(action, ERROR_KEEPASS_DATABASE_NOT_OPENED);
@@ -82,6 +93,8 @@ QJsonObject BrowserAction::handleAction(const QJsonObject& json)
         return handleTestAssociate(json, action);
     } else if (action.compare("get-logins", Qt::CaseSensitive) == 0) {
         return handleGetLogins(json, action);
+    } else if (action.compare("get-logins-batch", Qt::CaseSensitive) == 0) {
+        return handleGetLoginsBatch(json, action);
     } else if (action.compare("generate-password", Qt::CaseSensitive) == 0) {
         return handleGeneratePassword(json, action);
     } else if (action.compare("set-login", Qt::CaseSensitive) == 0) {
@@ -104,7 +117,7 @@ QJsonObject BrowserAction::handleChangePublicKeys(const QJsonObject& json, const
         return getErrorReply(action, ERROR_KEEPASS_CLIENT_PUBLIC_KEY_NOT_RECEIVED);
     }
 
-    m_associated = false;
+    m_associated.store(false);
     unsigned char pk[crypto_box_PUBLICKEYBYTES];
     unsigned char sk[crypto_box_SECRETKEYBYTES];
     crypto_box_keypair(pk, sk);
@@ -172,7 +185,7 @@ QJsonObject BrowserAction::handleAssociate(const QJsonObject& json, const QStrin
             return getErrorReply(action, ERROR_KEEPASS_ACTION_CANCELLED_OR_DENIED);
         }
 
-        m_associated = true;
+        m_associated.store(true);
         const QString newNonce = incrementNonce(nonce);
 
         QJsonObject message = buildMessage(newNonce);
@@ -201,13 +214,12 @@ QJsonObject BrowserAction::handleTestAssociate(const QJsonObject& json, const QS
         return getErrorReply(action, ERROR_KEEPASS_DATABASE_NOT_OPENED);
     }
 
-    QMutexLocker locker(&m_mutex);
     const QString key = m_browserService.getKey(id);
     if (key.isEmpty() || key.compare(responseKey, Qt::CaseSensitive) != 0) {
         return getErrorReply(action, ERROR_KEEPASS_ASSOCIATION_FAILED);
     }
 
-    m_associated = true;
+    m_associated.store(true);
     const QString newNonce = incrementNonce(nonce);
 
     QJsonObject message = buildMessage(newNonce);
@@ -223,8 +235,7 @@ QJsonObject BrowserAction::handleGetLogins(const QJsonObject& json, const QStrin
     const QString nonce = json.value("nonce").toString();
     const QString encrypted = json.value("message").toString();
 
-    QMutexLocker locker(&m_mutex);
-    if (!m_associated) {
+    if (!m_associated.load()) {
         return getErrorReply(action, ERROR_KEEPASS_ASSOCIATION_FAILED);
     }
 
@@ -238,17 +249,9 @@ QJsonObject BrowserAction::handleGetLogins(const QJsonObject& json, const QStrin
         return getErrorReply(action, ERROR_KEEPASS_NO_URL_PROVIDED);
     }
 
-    const QJsonArray keys = decrypted.value("keys").toArray();
-
-    StringPairList keyList;
-    for (const QJsonValue val : keys) {
-        const QJsonObject keyObject = val.toObject();
-        keyList.push_back(qMakePair(keyObject.value("id").toString(), keyObject.value("key").toString()));
-    }
-
     const QString id = decrypted.value("id").toString();
     const QString submit = decrypted.value("submitUrl").toString();
-    const QJsonArray users = m_browserService.findMatchingEntries(id, url, submit, "", keyList);
+    const QJsonArray users = m_browserService.findMatchingEntries(id, url, submit, "", getKeyList(decrypted));
 
     if (users.isEmpty()) {
         return getErrorReply(action, ERROR_KEEPASS_NO_LOGINS_FOUND);
@@ -265,6 +268,43 @@ QJsonObject BrowserAction::handleGetLogins(const QJsonObject& json, const QStrin
     return buildResponse(action, message, newNonce);
 }
 
+QJsonObject BrowserAction::handleGetLoginsBatch(const QJsonObject& json, const QString& action)
+{
+    const QString hash = getDatabaseHash();
+    const QString nonce = json.value("nonce").toString();
+    const QString encrypted = json.value("message").toString();
+
+    if (!m_associated.load()) {
+        return getErrorReply(action, ERROR_KEEPASS_ASSOCIATION_FAILED);
+    }
+
+    const QJsonObject decrypted = decryptMessage(encrypted, nonce, action);
+    if (decrypted.isEmpty()) {
+        return getErrorReply(action, ERROR_KEEPASS_CANNOT_DECRYPT_MESSAGE);
+    }
+
+    const QJsonArray requests = decrypted.value("requests").toArray();
+    if (requests.isEmpty()) {
+        return getErrorReply(action, ERROR_KEEPASS_NO_URL_PROVIDED);
+    }
+
+    const QString id = decrypted.value("id").toString();
+    const QJsonObject batch = m_browserService.findMatchingEntriesBatch(id, requests, getKeyList(decrypted));
+    const QJsonArray results = batch.value("results").toArray();
+
+    const QString newNonce = incrementNonce(nonce);
+
+    QJsonObject message = buildMessage(newNonce);
+    message["count"] = results.count();
+    message["results"] = results;
+    message["truncated"] = batch.value("truncated");
+    message["limit"] = batch.value("limit");
+    message["hash"] = hash;
+    message["id"] = id;
+
+    return buildResponse(action, message, newNonce);
+}
+
 QJsonObject BrowserAction::handleGeneratePassword(const QJsonObject& json, const QString& action)
 {
     const QString nonce = json.value("nonce").toString();
@@ -296,7 +336,7 @@ QJsonObject BrowserAction::handleSetLogin(const QJsonObject& json, const QString
     const QString encrypted = json.value("message").toString();
 
     QMutexLocker locker(&m_mutex);
-    if (!m_associated) {
+    if (!m_associated.load()) {
         return getErrorReply(action, ERROR_KEEPASS_ASSOCIATION_FAILED);
     }
 
@@ -430,7 +470,6 @@ QString BrowserAction::getErrorMessage(const int errorCode) const
 
 QString BrowserAction::getDatabaseHash()
 {
-    QMutexLocker locker(&m_mutex);
     QByteArray hash =
         QCryptographicHash::hash(
             (m_browserService.getDatabaseRootUuid() + m_browserService.getDatabaseRecycleBinUuid()).toUtf8(),
@@ -439,6 +478,22 @@ QString BrowserAction::getDatabaseHash()
     return QString(hash);
 }
 
+QString BrowserAction::clientPublicKey()
+{
+    QMutexLocker locker(&m_mutex);
+    return m_clientPublicKey;
+}
+
+StringPairList BrowserAction::getKeyList(const QJsonObject& decrypted) const
+{
+    StringPairList keyList;
+    for (const QJsonValue val : decrypted.value("keys").toArray()) {
+        const QJsonObject keyObject = val.toObject();
+        keyList.push_back(qMakePair(keyObject.value("id").toString(), keyObject.value("key").toString()));
+    }
+    return keyList;
+}
+
 QString BrowserAction::encryptMessage(const QJsonObject& message, const QString& nonce)
 {
     if (message.isEmpty() || nonce.isEmpty()) {
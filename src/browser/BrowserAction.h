@@ -54,6 +54,8 @@ public:
 
     QJsonObject readResponse(const QJsonObject& json);
 
+    static bool isReadOnlyAction(const QString& action);
+
 public slots:
     void removeSharedEncryptionKeys();
     void removeStoredPermissions();
@@ -65,6 +67,7 @@ private:
     QJsonObject handleAssociate(const QJsonObject& json, const QString& action);
     QJsonObject handleTestAssociate(const QJsonObject& json, const QString& action);
     QJsonObject handleGetLogins(const QJsonObject& json, const QString& action);
+    QJsonObject handleGetLoginsBatch(const QJsonObject& json, const QString& action);
     QJsonObject handleGeneratePassword(const QJsonObject& json, const QString& action);
     QJsonObject handleSetLogin(const QJsonObject& json, const QString& action);
     QJsonObject handleLockDatabase(const QJsonObject& json, const QString& action);
@@ -74,6 +77,8 @@ private:
     QJsonObject getErrorReply(const QString& action, const int errorCode) const;
     QString getErrorMessage(const int errorCode) const;
     QString getDatabaseHash();
+    QString clientPublicKey();
+    StringPairList getKeyList(const QJsonObject& decrypted) const;
 
     QString encryptMessage(const QJsonObject& message, const QString& nonce);
     QJsonObject decryptMessage(const QString& message, const QString& nonce, const QString& action = QString());
@@ -93,7 +98,7 @@ private:
     QString m_clientPublicKey;
     QString m_publicKey;
     QString m_secretKey;
-    bool m_associated;
+    QAtomicInteger<quint8> m_associated;
 };
 
 #endif // BROWSERACTION_H
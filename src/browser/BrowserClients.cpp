@@ -20,17 +20,17 @@
 #include <QJsonParseError>
 #include <QJsonValue>
 
-BrowserClients::BrowserClients(BrowserService& browserService)
-    : m_mutex(QMutex::Recursive)
+BrowserClients::BrowserClients(BrowserService& browserService, int maxClients, qint64 idleTimeout)
+    : m_maxClients(qMax(maxClients, 1))
+    , m_idleTimeout(idleTimeout)
     , m_browserService(browserService)
 {
-    m_clients.reserve(1000);
+    m_clock.start();
 }
 
-QJsonObject BrowserClients::readResponse(const QByteArray& arr)
+QJsonObject BrowserClients::readResponse(const QJsonObject& message)
 {
     QJsonObject json;
-    const QJsonObject message = byteArrayToJson(arr);
     const QString clientID = getClientID(message);
 
     if (!clientID.isEmpty()) {
@@ -43,7 +43,7 @@ QJsonObject BrowserClients::readResponse(const QByteArray& arr)
     return json;
 }
 
-QJsonObject BrowserClients::byteArrayToJson(const QByteArray& arr) const
+QJsonObject BrowserClients::byteArrayToJson(const QByteArray& arr)
 {
     QJsonObject json;
     QJsonParseError err;
@@ -60,18 +60,51 @@ QString BrowserClients::getClientID(const QJsonObject& json) const
     return json["clientID"].toString();
 }
 
+int BrowserClients::clientCount() const
+{
+    QMutexLocker locker(&m_mutex);
+    return m_clientIndex.size();
+}
+
+bool BrowserClients::hasClient(const QString& clientID) const
+{
+    QMutexLocker locker(&m_mutex);
+    return m_clientIndex.contains(clientID);
+}
+
 BrowserClients::ClientPtr BrowserClients::getClient(const QString& clientID)
 {
     QMutexLocker locker(&m_mutex);
-    for (const auto& i : m_clients) {
-        if (i->clientID.compare(clientID, Qt::CaseSensitive) == 0) {
-            return i;
-        }
+    const qint64 now = m_clock.elapsed();
+
+    auto it = m_clientIndex.constFind(clientID);
+    if (it != m_clientIndex.constEnd()) {
+        // splice keeps the iterator in the index valid
+        m_clients.splice(m_clients.begin(), m_clients, it.value());
+    } else {
+        // clientID not found, create a new client
+        QSharedPointer<BrowserAction> ba = QSharedPointer<BrowserAction>::create(m_browserService);
+        m_clients.push_front(ClientPtr::create(clientID, ba));
+        m_clientIndex.insert(clientID, m_clients.begin());
     }
 
-    // clientID not found, create a new client
-    QSharedPointer<BrowserAction> ba = QSharedPointer<BrowserAction>::create(m_browserService);
-    ClientPtr client = ClientPtr::create(clientID, ba);
-    m_clients.push_back(client);
-    return m_clients.back();
+    ClientPtr client = m_clients.front();
+    client->lastUsed = now;
+    evictClients(now);
+    return client;
+}
+
+void BrowserClients::evictClients(qint64 now)
+{
+    // the least recently used client is at the back, stop at the first one
+    // that is still in use; the front is the client of the current message
+    while (m_clients.size() > 1) {
+        const ClientPtr& client = m_clients.back();
+        if (static_cast<int>(m_clients.size()) <= m_maxClients && now - client->lastUsed <= m_idleTimeout) {
+            break;
+        }
+        // requests of this client that are still running keep its BrowserAction alive
+        m_clientIndex.remove(client->clientID);
+        m_clients.pop_back();
+    }
 }
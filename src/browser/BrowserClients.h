@@ -20,12 +20,24 @@
 #define BROWSERCLIENTS_H
 
 #include "BrowserAction.h"
+#include <QElapsedTimer>
+#include <QHash>
 #include <QJsonObject>
-#include <QLocalSocket>
 #include <QMutex>
 #include <QSharedPointer>
-#include <QVector>
+#include <list>
 
+/**
+ * Registry of the browser extensions talking to this instance.
+ *
+ * Every clientID keeps its own BrowserAction with the negotiated keys.
+ * Clients are looked up by id and kept in least recently used order, so
+ * that a lookup is constant time no matter how many clients connected
+ * during a session. When there are more than maxClients clients, or a
+ * client has not sent anything for idleTimeout milliseconds, it is
+ * dropped; the extension has to exchange its public key again on its
+ * next message.
+ */
 class BrowserClients
 {
     struct Client
@@ -33,28 +45,46 @@ class BrowserClients
         Client(const QString& id, QSharedPointer<BrowserAction> ba)
             : clientID(id)
             , browserAction(ba)
+            , lastUsed(0)
         {
         }
         QString clientID;
         QSharedPointer<BrowserAction> browserAction;
+        qint64 lastUsed;
     };
 
     typedef QSharedPointer<Client> ClientPtr;
+    typedef std::list<ClientPtr> ClientList;
 
 public:
-    BrowserClients(BrowserService& browserService);
+    static const int DefaultMaxClients = 100;
+    static const qint64 DefaultIdleTimeout = 24 * 60 * 60 * 1000;
+
+    explicit BrowserClients(BrowserService& browserService,
+                            int maxClients = DefaultMaxClients,
+                            qint64 idleTimeout = DefaultIdleTimeout);
     ~BrowserClients() = default;
 
-    QJsonObject readResponse(const QByteArray& arr);
+    QJsonObject readResponse(const QJsonObject& message);
+
+    int clientCount() const;
+    bool hasClient(const QString& clientID) const;
+
+    static QJsonObject byteArrayToJson(const QByteArray& arr);
 
 private:
-    QJsonObject byteArrayToJson(const QByteArray& arr) const;
     QString getClientID(const QJsonObject& json) const;
     ClientPtr getClient(const QString& clientID);
+    void evictClients(qint64 now);
 
 private:
-    QMutex m_mutex;
-    QVector<ClientPtr> m_clients;
+    mutable QMutex m_mutex;
+    // most recently used first
+    ClientList m_clients;
+    QHash<QString, ClientList::iterator> m_clientIndex;
+    QElapsedTimer m_clock;
+    const int m_maxClients;
+    const qint64 m_idleTimeout;
     BrowserService& m_browserService;
 };
 
@@ -22,16 +22,20 @@
 #include "BrowserEntryConfig.h"
 #include "BrowserSettings.h"
 #include "core/Database.h"
-#include "core/EntrySearcher.h"
+#include "core/DatabaseAccess.h"
 #include "core/Group.h"
+#include "core/HostIndex.h"
 #include "core/Metadata.h"
 #include "core/PasswordGenerator.h"
 #include "core/Uuid.h"
 #include "gui/MainWindow.h"
+#include <QCollator>
 #include <QInputDialog>
 #include <QJsonArray>
 #include <QMessageBox>
 #include <QProgressDialog>
+#include <utility>
+#include <vector>
 
 // de887cc3-0363-43b8-974b-5911b8816224
 static const unsigned char KEEPASSXCBROWSER_UUID_DATA[] =
@@ -44,27 +48,31 @@ static const char ASSOCIATE_KEY_PREFIX[] = "Public Key: ";
 static const char KEEPASSXCBROWSER_GROUP_NAME[] = "KeePassXC-Browser Passwords";
 static int KEEPASSXCBROWSER_DEFAULT_ICON = 1;
 
+const int BrowserService::MaxCachedEntryUrls;
+const int BrowserService::MaxBatchRequests;
+
 BrowserService::BrowserService(DatabaseTabWidget* parent)
     : m_dbTabWidget(parent)
     , m_dialogActive(false)
     , m_bringToFrontRequested(false)
 {
+    // the key list is passed along when a request moves to the GUI thread
+    qRegisterMetaType<StringPairList>("StringPairList");
+
     connect(m_dbTabWidget, SIGNAL(databaseLocked(DatabaseWidget*)), this, SLOT(databaseLocked(DatabaseWidget*)));
     connect(m_dbTabWidget, SIGNAL(databaseUnlocked(DatabaseWidget*)), this, SLOT(databaseUnlocked(DatabaseWidget*)));
     connect(m_dbTabWidget,
             SIGNAL(activateDatabaseChanged(DatabaseWidget*)),
             this,
             SLOT(activateDatabaseChanged(DatabaseWidget*)));
+    connect(m_dbTabWidget, SIGNAL(databaseReplaced(DatabaseWidget*)), this, SLOT(updateDatabases()));
+    updateDatabases();
 }
 
 bool BrowserService::isDatabaseOpened() const
 {
-    DatabaseWidget* dbWidget = m_dbTabWidget->currentDatabaseWidget();
-    if (!dbWidget) {
-        return false;
-    }
-
-    return dbWidget->currentMode() == DatabaseWidget::ViewMode || dbWidget->currentMode() == DatabaseWidget::EditMode;
+    DatabaseAccess::ReadLocker locker;
+    return !m_currentDatabase.isNull();
 }
 
 bool BrowserService::openDatabase(bool triggerUnlock)
@@ -73,6 +81,13 @@ bool BrowserService::openDatabase(bool triggerUnlock)
         return false;
     }
 
+    if (thread() != QThread::currentThread()) {
+        bool result = false;
+        QMetaObject::invokeMethod(
+            this, "openDatabase", Qt::BlockingQueuedConnection, Q_RETURN_ARG(bool, result), Q_ARG(bool, triggerUnlock));
+        return result;
+    }
+
     DatabaseWidget* dbWidget = m_dbTabWidget->currentDatabaseWidget();
     if (!dbWidget) {
         return false;
@@ -94,6 +109,7 @@ void BrowserService::lockDatabase()
 {
     if (thread() != QThread::currentThread()) {
         QMetaObject::invokeMethod(this, "lockDatabase", Qt::BlockingQueuedConnection);
+        return;
     }
 
     DatabaseWidget* dbWidget = m_dbTabWidget->currentDatabaseWidget();
@@ -108,6 +124,7 @@ void BrowserService::lockDatabase()
 
 QString BrowserService::getDatabaseRootUuid()
 {
+    DatabaseAccess::ReadLocker locker;
     Database* db = getDatabase();
     if (!db) {
         return QString();
@@ -123,6 +140,7 @@ QString BrowserService::getDatabaseRootUuid()
 
 QString BrowserService::getDatabaseRecycleBinUuid()
 {
+    DatabaseAccess::ReadLocker locker;
     Database* db = getDatabase();
     if (!db) {
         return QString();
@@ -175,8 +193,7 @@ QString BrowserService::storeKey(const QString& key)
         return id;
     }
 
-    Entry* config = getConfigEntry(true);
-    if (!config) {
+    if (!getDatabase()) {
         return {};
     }
 
@@ -194,7 +211,7 @@ QString BrowserService::storeKey(const QString& key)
         keyDialog.show();
         keyDialog.activateWindow();
         keyDialog.raise();
-        auto ok = keyDialog.exec();
+        int ok = keyDialog.exec();
 
         id = keyDialog.textValue();
 
@@ -202,7 +219,9 @@ QString BrowserService::storeKey(const QString& key)
             return {};
         }
 
-        contains = config->attributes()->contains(QLatin1String(ASSOCIATE_KEY_PREFIX) + id);
+        // the database may have been locked or replaced while the dialog was open
+        Entry* config = getConfigEntry();
+        contains = config && config->attributes()->contains(QLatin1String(ASSOCIATE_KEY_PREFIX) + id);
         if (contains) {
             dialogResult = QMessageBox::warning(nullptr,
                                                 tr("KeePassXC: Overwrite existing key?"),
@@ -213,12 +232,19 @@ QString BrowserService::storeKey(const QString& key)
         }
     } while (contains && dialogResult == QMessageBox::No);
 
+    DatabaseAccess::WriteLocker locker;
+    Entry* config = getConfigEntry(true);
+    if (!config) {
+        return {};
+    }
+
     config->attributes()->set(QLatin1String(ASSOCIATE_KEY_PREFIX) + id, key, true);
     return id;
 }
 
 QString BrowserService::getKey(const QString& id)
 {
+    DatabaseAccess::ReadLocker locker;
     Entry* config = getConfigEntry();
     if (!config) {
         return QString();
@@ -233,8 +259,22 @@ QJsonArray BrowserService::findMatchingEntries(const QString& id,
                                                const QString& realm,
                                                const StringPairList& keyList)
 {
+    const QString host = QUrl(url).host();
+    QList<Entry*> pwEntriesToConfirm;
+    QList<Entry*> pwEntries;
+
     QJsonArray result;
     if (thread() != QThread::currentThread()) {
+        // Entries that are already allowed can be returned right away,
+        // only asking the user for the others needs the GUI thread
+        {
+            DatabaseAccess::ReadLocker locker;
+            collectEntries(url, submitUrl, realm, searchDatabases(keyList), pwEntries, pwEntriesToConfirm);
+            if (pwEntriesToConfirm.isEmpty()) {
+                return prepareEntries(pwEntries, host, submitUrl);
+            }
+        }
+
         QMetaObject::invokeMethod(this,
                                   "findMatchingEntries",
                                   Qt::BlockingQueuedConnection,
@@ -247,14 +287,68 @@ QJsonArray BrowserService::findMatchingEntries(const QString& id,
         return result;
     }
 
+    collectEntries(url, submitUrl, realm, searchDatabases(keyList), pwEntries, pwEntriesToConfirm);
+
+    // Confirm entries
+    if (confirmEntries(pwEntriesToConfirm, url, host, QUrl(submitUrl).host(), realm)) {
+        pwEntries.append(pwEntriesToConfirm);
+    }
+
+    return prepareEntries(pwEntries, host, submitUrl);
+}
+
+QJsonObject BrowserService::findMatchingEntriesBatch(const QString& id,
+                                                     const QJsonArray& requests,
+                                                     const StringPairList& keyList)
+{
+    QVector<BatchRequest> batch;
+    bool truncated = false;
+
+    QJsonObject result;
+    if (thread() != QThread::currentThread()) {
+        {
+            DatabaseAccess::ReadLocker locker;
+            if (!collectBatch(requests, keyList, batch, truncated)) {
+                return prepareBatch(batch, truncated);
+            }
+        }
+
+        QMetaObject::invokeMethod(this,
+                                  "findMatchingEntriesBatch",
+                                  Qt::BlockingQueuedConnection,
+                                  Q_RETURN_ARG(QJsonObject, result),
+                                  Q_ARG(const QString&, id),
+                                  Q_ARG(const QJsonArray&, requests),
+                                  Q_ARG(const StringPairList&, keyList));
+        return result;
+    }
+
+    collectBatch(requests, keyList, batch, truncated);
+
+    // Confirm entries, one dialog per page as for single requests
+    for (BatchRequest& request : batch) {
+        const QString host = QUrl(request.url).host();
+        if (confirmEntries(request.pwEntriesToConfirm, request.url, host, QUrl(request.submitUrl).host(), QString())) {
+            request.pwEntries.append(request.pwEntriesToConfirm);
+        }
+    }
+
+    return prepareBatch(batch, truncated);
+}
+
+void BrowserService::collectEntries(const QString& url,
+                                    const QString& submitUrl,
+                                    const QString& realm,
+                                    const QList<Database*>& databases,
+                                    QList<Entry*>& pwEntries,
+                                    QList<Entry*>& pwEntriesToConfirm)
+{
     const bool alwaysAllowAccess = BrowserSettings::alwaysAllowAccess();
     const QString host = QUrl(url).host();
     const QString submitHost = QUrl(submitUrl).host();
 
     // Check entries for authorization
-    QList<Entry*> pwEntriesToConfirm;
-    QList<Entry*> pwEntries;
-    for (Entry* entry : searchEntries(url, keyList)) {
+    for (Entry* entry : searchEntries(databases, url)) {
         switch (checkAccess(entry, host, submitHost, realm)) {
         case Denied:
             continue;
@@ -272,14 +366,82 @@ QJsonArray BrowserService::findMatchingEntries(const QString& id,
             break;
         }
     }
+}
 
-    // Confirm entries
-    if (confirmEntries(pwEntriesToConfirm, url, host, submitHost, realm)) {
-        pwEntries.append(pwEntriesToConfirm);
+bool BrowserService::collectBatch(const QJsonArray& requests,
+                                  const StringPairList& keyList,
+                                  QVector<BatchRequest>& batch,
+                                  bool& truncated)
+{
+    // the databases are the same for every page of the batch
+    const QList<Database*> databases = searchDatabases(keyList);
+
+    bool needsConfirmation = false;
+    truncated = false;
+    QHash<QPair<QString, QString>, int> pages;
+    for (int i = 0; i < requests.size(); ++i) {
+        const QJsonObject requestObject = requests.at(i).toObject();
+        BatchRequest request;
+        request.url = requestObject.value("url").toString();
+        request.submitUrl = requestObject.value("submitUrl").toString();
+        if (request.url.isEmpty()) {
+            continue;
+        }
+
+        // duplicates are answered by the page of the first request
+        const QPair<QString, QString> key(request.url, request.submitUrl);
+        const auto page = pages.constFind(key);
+        if (page != pages.constEnd()) {
+            batch[page.value()].indices.append(i);
+            continue;
+        }
+        if (batch.size() >= MaxBatchRequests) {
+            truncated = true;
+            continue;
+        }
+        pages.insert(key, batch.size());
+        request.indices.append(i);
+
+        collectEntries(request.url, request.submitUrl, QString(), databases, request.pwEntries, request.pwEntriesToConfirm);
+        needsConfirmation = needsConfirmation || !request.pwEntriesToConfirm.isEmpty();
+        batch.append(request);
     }
 
+    return needsConfirmation;
+}
+
+QJsonObject BrowserService::prepareBatch(QVector<BatchRequest>& batch, bool truncated)
+{
+    QJsonArray results;
+    for (BatchRequest& request : batch) {
+        const QJsonArray entries = prepareEntries(request.pwEntries, QUrl(request.url).host(), request.submitUrl);
+
+        QJsonArray indices;
+        for (int index : request.indices) {
+            indices << index;
+        }
+
+        QJsonObject page;
+        page["url"] = request.url;
+        page["submitUrl"] = request.submitUrl;
+        page["requests"] = indices;
+        page["count"] = entries.count();
+        page["entries"] = entries;
+        results << page;
+    }
+
+    QJsonObject result;
+    result["results"] = results;
+    result["truncated"] = truncated;
+    result["limit"] = MaxBatchRequests;
+    return result;
+}
+
+QJsonArray BrowserService::prepareEntries(QList<Entry*>& pwEntries, const QString& host, const QString& submitUrl)
+{
+    QJsonArray result;
     if (pwEntries.isEmpty()) {
-        return QJsonArray();
+        return result;
     }
 
     // Sort results
@@ -293,13 +455,27 @@ QJsonArray BrowserService::findMatchingEntries(const QString& id,
     return result;
 }
 
-void BrowserService::addEntry(const QString&,
+void BrowserService::addEntry(const QString& id,
                               const QString& login,
                               const QString& password,
                               const QString& url,
                               const QString& submitUrl,
                               const QString& realm)
 {
+    if (thread() != QThread::currentThread()) {
+        QMetaObject::invokeMethod(this,
+                                  "addEntry",
+                                  Qt::BlockingQueuedConnection,
+                                  Q_ARG(const QString&, id),
+                                  Q_ARG(const QString&, login),
+                                  Q_ARG(const QString&, password),
+                                  Q_ARG(const QString&, url),
+                                  Q_ARG(const QString&, submitUrl),
+                                  Q_ARG(const QString&, realm));
+        return;
+    }
+
+    DatabaseAccess::WriteLocker locker;
     Group* group = findCreateAddEntryGroup();
     if (!group) {
         return;
@@ -343,6 +519,7 @@ void BrowserService::updateEntry(const QString& id,
                                   Q_ARG(const QString&, login),
                                   Q_ARG(const QString&, password),
                                   Q_ARG(const QString&, url));
+        return;
     }
 
     Database* db = getDatabase();
@@ -376,6 +553,7 @@ void BrowserService::updateEntry(const QString& id,
         }
 
         if (BrowserSettings::alwaysAllowUpdate() || dialogResult == QMessageBox::Yes) {
+            DatabaseAccess::WriteLocker locker;
             entry->beginUpdate();
             entry->setUsername(login);
             entry->setPassword(password);
@@ -386,45 +564,35 @@ void BrowserService::updateEntry(const QString& id,
 
 QList<Entry*> BrowserService::searchEntries(Database* db, const QString& hostname)
 {
-    QList<Entry*> entries;
-    Group* rootGroup = db->rootGroup();
-    if (!rootGroup) {
-        return entries;
-    }
-
-    for (Entry* entry : EntrySearcher().search(hostname, rootGroup, Qt::CaseInsensitive)) {
-        QString title = entry->title();
-        QString url = entry->url();
-
-        // Filter to match hostname in Title and Url fields
-        if ((!title.isEmpty() && hostname.contains(title)) || (!url.isEmpty() && hostname.contains(url))
-            || (matchUrlScheme(title) && hostname.endsWith(QUrl(title).host()))
-            || (matchUrlScheme(url) && hostname.endsWith(QUrl(url).host()))) {
-            entries.append(entry);
-        }
+    if (!db->rootGroup()) {
+        return QList<Entry*>();
     }
 
-    return entries;
+    // Entries a search for the host name finds and whose Title or URL match it
+    return db->hostIndex()->entries(hostname);
 }
 
 QList<Entry*> BrowserService::searchEntries(const QString& text, const StringPairList& keyList)
+{
+    return searchEntries(searchDatabases(keyList), text);
+}
+
+QList<Database*> BrowserService::searchDatabases(const StringPairList& keyList)
 {
     // Get the list of databases to search
     QList<Database*> databases;
     if (BrowserSettings::searchInAllDatabases()) {
-        const int count = m_dbTabWidget->count();
-        for (int i = 0; i < count; ++i) {
-            if (DatabaseWidget* dbWidget = qobject_cast<DatabaseWidget*>(m_dbTabWidget->widget(i))) {
-                if (Database* db = dbWidget->database()) {
-                     // Check if database is connected with KeePassXC-Browser
-                    for (const StringPair keyPair : keyList) {
-                        Entry* entry = db->resolveEntry(KEEPASSXCBROWSER_UUID);
-                        if (entry) {
-                            QString key = entry->attributes()->value(QLatin1String(ASSOCIATE_KEY_PREFIX) + keyPair.first);
-                            if (!key.isEmpty() && keyPair.second == key) {
-                                databases << db;
-                            }
-                        }
+        for (const QPointer<Database>& db : m_databases) {
+            if (!db) {
+                continue;
+            }
+            // Check if database is connected with KeePassXC-Browser
+            for (const StringPair keyPair : keyList) {
+                Entry* entry = db->resolveEntry(KEEPASSXCBROWSER_UUID);
+                if (entry) {
+                    QString key = entry->attributes()->value(QLatin1String(ASSOCIATE_KEY_PREFIX) + keyPair.first);
+                    if (!key.isEmpty() && keyPair.second == key) {
+                        databases << db;
                     }
                 }
             }
@@ -433,6 +601,11 @@ QList<Entry*> BrowserService::searchEntries(const QString& text, const StringPai
         databases << db;
     }
 
+    return databases;
+}
+
+QList<Entry*> BrowserService::searchEntries(const QList<Database*>& databases, const QString& text)
+{
     // Search entries matching the hostname
     QString hostname = QUrl(text).host();
     QList<Entry*> entries;
@@ -480,11 +653,14 @@ void BrowserService::removeSharedEncryptionKeys()
         return;
     }
 
-    entry->beginUpdate();
-    for (const QString& key : keysToRemove) {
-        entry->attributes()->remove(key);
+    {
+        DatabaseAccess::WriteLocker locker;
+        entry->beginUpdate();
+        for (const QString& key : keysToRemove) {
+            entry->attributes()->remove(key);
+        }
+        entry->endUpdate();
     }
-    entry->endUpdate();
 
     const int count = keysToRemove.count();
     QMessageBox::information(0,
@@ -504,12 +680,13 @@ void BrowserService::removeStoredPermissions()
         return;
     }
 
-    Database* db = m_dbTabWidget->currentDatabaseWidget()->database();
+    Database* db = getDatabase();
     if (!db) {
         return;
     }
 
-    QList<Entry*> entries = db->rootGroup()->entriesRecursive();
+    // the progress dialog processes events, don't walk the live tree
+    const QList<Entry*> entries = db->rootGroup()->entriesRecursive();
 
     QProgressDialog progress(tr("Removing stored permissions…"), tr("Abort"), 0, entries.count());
     progress.setWindowModality(Qt::WindowModal);
@@ -521,6 +698,7 @@ void BrowserService::removeStoredPermissions()
         }
 
         if (entry->attributes()->contains(KEEPASSXCBROWSER_NAME)) {
+            DatabaseAccess::WriteLocker locker;
             entry->beginUpdate();
             entry->attributes()->remove(KEEPASSXCBROWSER_NAME);
             entry->endUpdate();
@@ -545,31 +723,36 @@ void BrowserService::removeStoredPermissions()
 
 QList<Entry*> BrowserService::sortEntries(QList<Entry*>& pwEntries, const QString& host, const QString& entryUrl)
 {
-    QUrl url(entryUrl);
-    if (url.scheme().isEmpty()) {
-        url.setScheme("http");
-    }
-
-    const QString submitUrl = url.toString(QUrl::StripTrailingSlash);
-    const QString baseSubmitUrl =
-        url.toString(QUrl::StripTrailingSlash | QUrl::RemovePath | QUrl::RemoveQuery | QUrl::RemoveFragment);
+    const EntryUrl submit = parseUrl(entryUrl);
 
     // Build map of prioritized entries
     QMultiMap<int, Entry*> priorities;
     for (Entry* entry : pwEntries) {
-        priorities.insert(sortPriority(entry, host, submitUrl, baseSubmitUrl), entry);
+        priorities.insert(sortPriority(entry, host, submit.url, submit.baseUrl), entry);
     }
 
+    QCollator collator;
     QList<Entry*> results;
     QString field = BrowserSettings::sortByTitle() ? "Title" : "UserName";
     for (int i = 100; i >= 0; i -= 5) {
         if (priorities.count(i) > 0) {
-            // Sort same priority entries by Title or UserName
-            auto entries = priorities.values(i);
-            std::sort(entries.begin(), entries.end(), [&priorities, &field](Entry* left, Entry* right) {
-                return QString::localeAwareCompare(left->attributes()->value(field), right->attributes()->value(field)) < 0;
-            });
-            results << entries;
+            // Sort same priority entries by Title or UserName, comparing
+            // precomputed collation keys instead of collating on every comparison
+            std::vector<std::pair<QCollatorSortKey, Entry*>> keyedEntries;
+            const QList<Entry*> entries = priorities.values(i);
+            keyedEntries.reserve(static_cast<size_t>(entries.size()));
+            for (Entry* entry : entries) {
+                keyedEntries.emplace_back(collator.sortKey(entry->attributes()->value(field)), entry);
+            }
+            std::stable_sort(keyedEntries.begin(),
+                             keyedEntries.end(),
+                             [](const std::pair<QCollatorSortKey, Entry*>& left,
+                                const std::pair<QCollatorSortKey, Entry*>& right) {
+                                 return left.first.compare(right.first) < 0;
+                             });
+            for (const auto& keyedEntry : keyedEntries) {
+                results << keyedEntry.second;
+            }
             if (BrowserSettings::bestMatchOnly() && !pwEntries.isEmpty()) {
                 // Early out once we find the highest batch of matches
                 break;
@@ -597,6 +780,7 @@ bool BrowserService::confirmEntries(QList<Entry*>& pwEntriesToConfirm,
 
     int res = accessControlDialog.exec();
     if (accessControlDialog.remember()) {
+        DatabaseAccess::WriteLocker locker;
         for (Entry* entry : pwEntriesToConfirm) {
             BrowserEntryConfig config;
             config.load(entry);
@@ -705,13 +889,9 @@ int BrowserService::sortPriority(const Entry* entry,
                                  const QString& submitUrl,
                                  const QString& baseSubmitUrl) const
 {
-    QUrl url(entry->url());
-    if (url.scheme().isEmpty()) {
-        url.setScheme("http");
-    }
-    const QString entryURL = url.toString(QUrl::StripTrailingSlash);
-    const QString baseEntryURL =
-        url.toString(QUrl::StripTrailingSlash | QUrl::RemovePath | QUrl::RemoveQuery | QUrl::RemoveFragment);
+    const EntryUrl url = entryUrl(entry);
+    const QString& entryURL = url.url;
+    const QString& baseEntryURL = url.baseUrl;
 
     if (submitUrl == entryURL) {
         return 100;
@@ -749,10 +929,40 @@ int BrowserService::sortPriority(const Entry* entry,
     return 0;
 }
 
-bool BrowserService::matchUrlScheme(const QString& url)
+BrowserService::EntryUrl BrowserService::entryUrl(const Entry* entry) const
+{
+    // requests may be sorted on several worker threads at once
+    QMutexLocker locker(&m_entryUrlsMutex);
+
+    // the revision changes with every modification of the entry, including its URL
+    auto it = m_entryUrls.find(entry);
+    if (it == m_entryUrls.end() || it->revision != entry->revision()) {
+        if (it == m_entryUrls.end() && m_entryUrls.size() >= MaxCachedEntryUrls) {
+            m_entryUrls.clear();
+        }
+        EntryUrl url = parseUrl(entry->url());
+        url.revision = entry->revision();
+        it = m_entryUrls.insert(entry, url);
+    }
+    return it.value();
+}
+
+BrowserService::EntryUrl BrowserService::parseUrl(const QString& url)
 {
-    QUrl address(url);
-    return !address.scheme().isEmpty();
+    QUrl qurl(url);
+    if (qurl.scheme().isEmpty()) {
+        qurl.setScheme("http");
+    }
+
+    EntryUrl result;
+    result.revision = 0;
+    result.scheme = qurl.scheme();
+    result.host = qurl.host();
+    result.path = qurl.path();
+    result.url = qurl.toString(QUrl::StripTrailingSlash);
+    result.baseUrl =
+        qurl.toString(QUrl::StripTrailingSlash | QUrl::RemovePath | QUrl::RemoveQuery | QUrl::RemoveFragment);
+    return result;
 }
 
 bool BrowserService::removeFirstDomain(QString& hostname)
@@ -774,16 +984,46 @@ bool BrowserService::removeFirstDomain(QString& hostname)
 
 Database* BrowserService::getDatabase()
 {
-    if (DatabaseWidget* dbWidget = m_dbTabWidget->currentDatabaseWidget()) {
-        if (Database* db = dbWidget->database()) {
-            return db;
+    return m_currentDatabase.data();
+}
+
+void BrowserService::updateDatabases()
+{
+    // worker threads don't touch the widgets, they only see this snapshot
+    DatabaseAccess::WriteLocker locker;
+    m_databases.clear();
+    m_currentDatabase = nullptr;
+    if (!m_dbTabWidget) {
+        return;
+    }
+
+    const int count = m_dbTabWidget->count();
+    for (int i = 0; i < count; ++i) {
+        if (DatabaseWidget* dbWidget = qobject_cast<DatabaseWidget*>(m_dbTabWidget->widget(i))) {
+            if (Database* db = dbWidget->database()) {
+                m_databases << db;
+            }
         }
     }
-    return nullptr;
+
+    DatabaseWidget* dbWidget = m_dbTabWidget->currentDatabaseWidget();
+    if (dbWidget
+        && (dbWidget->currentMode() == DatabaseWidget::ViewMode
+            || dbWidget->currentMode() == DatabaseWidget::EditMode)) {
+        m_currentDatabase = dbWidget->database();
+    }
 }
 
 void BrowserService::databaseLocked(DatabaseWidget* dbWidget)
 {
+    updateDatabases();
+
+    // locking deletes the entries, don't keep their URLs around
+    {
+        QMutexLocker locker(&m_entryUrlsMutex);
+        m_entryUrls.clear();
+    }
+
     if (dbWidget) {
         emit databaseLocked();
     }
@@ -791,6 +1031,8 @@ void BrowserService::databaseLocked(DatabaseWidget* dbWidget)
 
 void BrowserService::databaseUnlocked(DatabaseWidget* dbWidget)
 {
+    updateDatabases();
+
     if (dbWidget) {
         if (m_bringToFrontRequested) {
             KEEPASSXC_MAIN_WINDOW->lower();
@@ -802,6 +1044,8 @@ void BrowserService::databaseUnlocked(DatabaseWidget* dbWidget)
 
 void BrowserService::activateDatabaseChanged(DatabaseWidget* dbWidget)
 {
+    updateDatabases();
+
     if (dbWidget) {
         auto currentMode = dbWidget->currentMode();
         if (currentMode == DatabaseWidget::ViewMode || currentMode == DatabaseWidget::EditMode) {
@@ -41,29 +41,40 @@ public:
     explicit BrowserService(DatabaseTabWidget* parent);
 
     bool isDatabaseOpened() const;
-    bool openDatabase(bool triggerUnlock);
     QString getDatabaseRootUuid();
     QString getDatabaseRecycleBinUuid();
     Entry* getConfigEntry(bool create = false);
     QString getKey(const QString& id);
-    void addEntry(const QString& id,
-                  const QString& login,
-                  const QString& password,
-                  const QString& url,
-                  const QString& submitUrl,
-                  const QString& realm);
     QList<Entry*> searchEntries(Database* db, const QString& hostname);
     QList<Entry*> searchEntries(const QString& text, const StringPairList& keyList);
     void removeSharedEncryptionKeys();
     void removeStoredPermissions();
 
 public slots:
+    bool openDatabase(bool triggerUnlock);
     QJsonArray findMatchingEntries(const QString& id,
                                    const QString& url,
                                    const QString& submitUrl,
                                    const QString& realm,
                                    const StringPairList& keyList);
+    /**
+     * Resolves the logins of several pages at once. Each request is an
+     * object with "url" and optional "submitUrl". The "results" of the
+     * returned object hold one page with "url", "submitUrl", "requests",
+     * "count" and "entries" per distinct (url, submitUrl) pair, in order;
+     * "requests" lists the indices of all requests the page answers, since
+     * duplicates are collapsed. Entries that need confirmation are confirmed
+     * per URL, just like findMatchingEntries() does. Only the first "limit"
+     * pages are answered, "truncated" tells whether requests were left out.
+     */
+    QJsonObject findMatchingEntriesBatch(const QString& id, const QJsonArray& requests, const StringPairList& keyList);
     QString storeKey(const QString& key);
+    void addEntry(const QString& id,
+                  const QString& login,
+                  const QString& password,
+                  const QString& url,
+                  const QString& submitUrl,
+                  const QString& realm);
     void updateEntry(const QString& id,
                      const QString& uuid,
                      const QString& login,
@@ -79,6 +90,9 @@ signals:
     void databaseUnlocked();
     void databaseChanged();
 
+private slots:
+    void updateDatabases();
+
 private:
     enum Access
     {
@@ -87,7 +101,49 @@ private:
         Allowed
     };
 
+    /**
+     * Normalized form of an entry URL as used by sortPriority(), cached
+     * until the entry is modified.
+     */
+    struct EntryUrl
+    {
+        quint64 revision;
+        QString scheme;
+        QString host;
+        QString path;
+        // with a default scheme and without trailing slash
+        QString url;
+        // url without path, query and fragment
+        QString baseUrl;
+    };
+
+    /**
+     * One page of a findMatchingEntriesBatch() call.
+     */
+    struct BatchRequest
+    {
+        QString url;
+        QString submitUrl;
+        QList<int> indices;
+        QList<Entry*> pwEntries;
+        QList<Entry*> pwEntriesToConfirm;
+    };
+
 private:
+    QList<Database*> searchDatabases(const StringPairList& keyList);
+    QList<Entry*> searchEntries(const QList<Database*>& databases, const QString& text);
+    void collectEntries(const QString& url,
+                        const QString& submitUrl,
+                        const QString& realm,
+                        const QList<Database*>& databases,
+                        QList<Entry*>& pwEntries,
+                        QList<Entry*>& pwEntriesToConfirm);
+    bool collectBatch(const QJsonArray& requests,
+                      const StringPairList& keyList,
+                      QVector<BatchRequest>& batch,
+                      bool& truncated);
+    QJsonObject prepareBatch(QVector<BatchRequest>& batch, bool truncated);
+    QJsonArray prepareEntries(QList<Entry*>& pwEntries, const QString& host, const QString& submitUrl);
     QList<Entry*> sortEntries(QList<Entry*>& pwEntries, const QString& host, const QString& submitUrl);
     bool confirmEntries(QList<Entry*>& pwEntriesToConfirm,
                         const QString& url,
@@ -99,7 +155,8 @@ private:
     Group* findCreateAddEntryGroup();
     int
     sortPriority(const Entry* entry, const QString& host, const QString& submitUrl, const QString& baseSubmitUrl) const;
-    bool matchUrlScheme(const QString& url);
+    EntryUrl entryUrl(const Entry* entry) const;
+    static EntryUrl parseUrl(const QString& url);
     bool removeFirstDomain(QString& hostname);
     Database* getDatabase();
 
@@ -107,6 +164,18 @@ private:
     DatabaseTabWidget* const m_dbTabWidget;
     bool m_dialogActive;
     bool m_bringToFrontRequested;
+    // the open databases and the current one if it is unlocked, worker
+    // threads use these instead of the widgets, see updateDatabases()
+    QList<QPointer<Database>> m_databases;
+    QPointer<Database> m_currentDatabase;
+    // deleted entries are never removed individually, the cache is dropped when it gets this large
+    static const int MaxCachedEntryUrls = 16384;
+    // every page may need its own confirmation dialog
+    static const int MaxBatchRequests = 64;
+    mutable QMutex m_entryUrlsMutex;
+    mutable QHash<const Entry*, EntryUrl> m_entryUrls;
+
+    friend class TestBrowser;
 };
 
 #endif // BROWSERSERVICE_H
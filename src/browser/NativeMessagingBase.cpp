@@ -18,6 +18,7 @@
 
 #include "NativeMessagingBase.h"
 #include <QStandardPaths>
+#include <cstring>
 
 #if defined(Q_OS_UNIX) && !defined(Q_OS_LINUX)
 #include <sys/event.h>
@@ -90,22 +91,74 @@ void NativeMessagingBase::newNativeMessage()
         return;
     }
 #endif
-    readLength();
+    readStdIn();
 #ifndef Q_OS_WIN
     ::close(fd);
 #endif
 }
 
+/**
+ * Reads everything that is available on stdin at once and handles all
+ * complete messages in it. Partial messages are kept for the next call.
+ */
+void NativeMessagingBase::readStdIn()
+{
+#ifndef Q_OS_WIN
+    char buffer[16 * 1024];
+    const ssize_t bytesRead = ::read(fileno(stdin), buffer, sizeof(buffer));
+    if (bytesRead <= 0) {
+        nativeInputClosed();
+        return;
+    }
+    m_stdinBuffer.append(buffer, static_cast<int>(bytesRead));
+
+    int offset = 0;
+    while (m_stdinBuffer.size() - offset >= 4) {
+        // browsers use the native byte order for the length
+        quint32 length;
+        memcpy(&length, m_stdinBuffer.constData() + offset, sizeof(length));
+        if (length == 0 || length > static_cast<quint32>(NATIVE_MSG_MAX_LENGTH)) {
+            // the stream can't be resynchronized
+            m_stdinBuffer.clear();
+            nativeInputClosed();
+            return;
+        }
+        if (m_stdinBuffer.size() - offset - 4 < static_cast<int>(length)) {
+            break;
+        }
+
+        readNativeMessage(m_stdinBuffer.mid(offset + 4, static_cast<int>(length)));
+        offset += 4 + static_cast<int>(length);
+    }
+    m_stdinBuffer.remove(0, offset);
+#endif
+}
+
+void NativeMessagingBase::nativeInputClosed()
+{
+    if (m_notifier) {
+        m_notifier->setEnabled(false);
+    }
+}
+
 void NativeMessagingBase::readNativeMessages()
 {
 #ifdef Q_OS_WIN
-    quint32 length = 0;
     while (m_running.load() && !std::cin.eof()) {
-        length = 0;
+        quint32 length = 0;
         std::cin.read(reinterpret_cast<char*>(&length), 4);
-        readStdIn(length);
-        QThread::msleep(1);
+        if (std::cin.eof() || length == 0 || length > static_cast<quint32>(NATIVE_MSG_MAX_LENGTH)) {
+            break;
+        }
+
+        QByteArray message(static_cast<int>(length), Qt::Uninitialized);
+        std::cin.read(message.data(), length);
+        if (std::cin.gcount() != static_cast<std::streamsize>(length)) {
+            break;
+        }
+        readNativeMessage(message);
     }
+    nativeInputClosed();
 #endif
 }
 
@@ -122,13 +175,20 @@ void NativeMessagingBase::sendReply(const QJsonObject& json)
 }
 
 void NativeMessagingBase::sendReply(const QString& reply)
+{
+    sendReply(reply.toUtf8());
+}
+
+void NativeMessagingBase::sendReply(const QByteArray& reply)
 {
     if (!reply.isEmpty()) {
-        QByteArray bytes = reply.toUtf8();
-        uint len = bytes.size();
-        std::cout << char(((len >> 0) & 0xFF)) << char(((len >> 8) & 0xFF)) << char(((len >> 16) & 0xFF))
-                  << char(((len >> 24) & 0xFF));
-        std::cout << reply.toStdString() << std::flush;
+        // length prefix and message in a single write
+        const quint32 length = static_cast<quint32>(reply.size());
+        QByteArray message(4 + reply.size(), Qt::Uninitialized);
+        memcpy(message.data(), &length, sizeof(length));
+        memcpy(message.data() + 4, reply.constData(), static_cast<size_t>(reply.size()));
+        std::cout.write(message.constData(), message.size());
+        std::cout.flush();
     }
 }
 
@@ -51,18 +51,31 @@ protected slots:
     void newNativeMessage();
 
 protected:
-    virtual void readLength() = 0;
-    virtual void readStdIn(const quint32 length) = 0;
+    /**
+     * Handles one message received on stdin, without the length prefix.
+     */
+    virtual void readNativeMessage(const QByteArray& message) = 0;
+    /**
+     * Called once stdin was closed by the browser.
+     */
+    virtual void nativeInputClosed();
     void readNativeMessages();
     QString jsonToString(const QJsonObject& json) const;
     void sendReply(const QJsonObject& json);
     void sendReply(const QString& reply);
+    void sendReply(const QByteArray& reply);
     QString getLocalServerPath() const;
 
+private:
+    void readStdIn();
+
 protected:
     QAtomicInteger<quint8> m_running;
     QSharedPointer<QSocketNotifier> m_notifier;
     QFuture<void> m_future;
+
+private:
+    QByteArray m_stdinBuffer;
 };
 
 #endif // NATIVEMESSAGINGBASE_H
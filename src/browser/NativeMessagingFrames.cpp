@@ -0,0 +1,87 @@
+/*
+ *  Copyright (C) 2018 KeePassXC Team <team@keepassxc.org>
+ *
+ *  This program is free software: you can redistribute it and/or modify
+ *  it under the terms of the GNU General Public License as published by
+ *  the Free Software Foundation, either version 3 of the License, or
+ *  (at your option) any later version.
+ *
+ *  This program is distributed in the hope that it will be useful,
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *  GNU General Public License for more details.
+ *
+ *  You should have received a copy of the GNU General Public License
+ *  along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#include "NativeMessagingFrames.h"
+#include "NativeMessagingBase.h"
+
+#include <QtEndian>
+#include <cstring>
+
+namespace
+{
+    // the first byte differs from the '{' an unframed JSON message starts with
+    const char FrameHandshake[] = "KPXC-IPC-1\n";
+    const int FrameHeaderSize = 8;
+} // namespace
+
+NativeMessagingFrames::NativeMessagingFrames()
+    : m_offset(0)
+    , m_error(false)
+{
+}
+
+QByteArray NativeMessagingFrames::handshake()
+{
+    return QByteArray::fromRawData(FrameHandshake, sizeof(FrameHandshake) - 1);
+}
+
+QByteArray NativeMessagingFrames::encode(quint32 requestId, const QByteArray& payload)
+{
+    QByteArray frame(FrameHeaderSize + payload.size(), Qt::Uninitialized);
+    uchar* data = reinterpret_cast<uchar*>(frame.data());
+    qToLittleEndian<quint32>(static_cast<quint32>(payload.size()), data);
+    qToLittleEndian<quint32>(requestId, data + 4);
+    memcpy(data + FrameHeaderSize, payload.constData(), static_cast<size_t>(payload.size()));
+    return frame;
+}
+
+void NativeMessagingFrames::append(const QByteArray& data)
+{
+    // drop consumed frames before growing the buffer
+    if (m_offset > 0) {
+        m_buffer.remove(0, m_offset);
+        m_offset = 0;
+    }
+    m_buffer.append(data);
+}
+
+bool NativeMessagingFrames::takeFrame(quint32& requestId, QByteArray& payload)
+{
+    if (m_error || m_buffer.size() - m_offset < FrameHeaderSize) {
+        return false;
+    }
+
+    const uchar* header = reinterpret_cast<const uchar*>(m_buffer.constData() + m_offset);
+    const quint32 length = qFromLittleEndian<quint32>(header);
+    if (length > static_cast<quint32>(NATIVE_MSG_MAX_LENGTH)) {
+        m_error = true;
+        return false;
+    }
+    if (m_buffer.size() - m_offset - FrameHeaderSize < static_cast<int>(length)) {
+        return false;
+    }
+
+    requestId = qFromLittleEndian<quint32>(header + 4);
+    payload = m_buffer.mid(m_offset + FrameHeaderSize, static_cast<int>(length));
+    m_offset += FrameHeaderSize + static_cast<int>(length);
+    return true;
+}
+
+bool NativeMessagingFrames::hasError() const
+{
+    return m_error;
+}
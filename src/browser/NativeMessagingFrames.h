@@ -0,0 +1,67 @@
+/*
+ *  Copyright (C) 2018 KeePassXC Team <team@keepassxc.org>
+ *
+ *  This program is free software: you can redistribute it and/or modify
+ *  it under the terms of the GNU General Public License as published by
+ *  the Free Software Foundation, either version 3 of the License, or
+ *  (at your option) any later version.
+ *
+ *  This program is distributed in the hope that it will be useful,
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *  GNU General Public License for more details.
+ *
+ *  You should have received a copy of the GNU General Public License
+ *  along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#ifndef NATIVEMESSAGINGFRAMES_H
+#define NATIVEMESSAGINGFRAMES_H
+
+#include <QByteArray>
+
+/**
+ * Framing of the messages exchanged between keepassxc-proxy and KeePassXC
+ * over the local socket.
+ *
+ * A framed connection starts with the handshake() bytes sent by the proxy.
+ * Every message after that is sent as
+ *
+ *     quint32 payload length | quint32 request id | payload
+ *
+ * with both integers in little endian. A connection can have several
+ * requests in flight. Replies carry the id of their request and are sent
+ * in request order, because the browser matches them by order. Messages
+ * the server sends on its own, e.g. database-locked, use id 0.
+ *
+ * Connections that don't start with the handshake are served unframed,
+ * one message per read, as older proxies expect.
+ */
+class NativeMessagingFrames
+{
+public:
+    NativeMessagingFrames();
+
+    static QByteArray handshake();
+    static QByteArray encode(quint32 requestId, const QByteArray& payload);
+
+    /**
+     * Appends data read from the socket. Frames are split or coalesced
+     * arbitrarily by the socket, takeFrame() returns them once complete.
+     */
+    void append(const QByteArray& data);
+    bool takeFrame(quint32& requestId, QByteArray& payload);
+
+    /**
+     * Returns true if the peer announced a frame larger than
+     * NATIVE_MSG_MAX_LENGTH. The stream can't be resynchronized then.
+     */
+    bool hasError() const;
+
+private:
+    QByteArray m_buffer;
+    int m_offset;
+    bool m_error;
+};
+
+#endif // NATIVEMESSAGINGFRAMES_H
@@ -19,7 +19,9 @@
 #include "NativeMessagingHost.h"
 #include "BrowserSettings.h"
 #include "sodium.h"
+#include <QFutureWatcher>
 #include <QMutexLocker>
+#include <QPointer>
 #include <QtNetwork>
 #include <iostream>
 
@@ -100,56 +102,32 @@ void NativeMessagingHost::stop()
     databaseLocked();
     QMutexLocker locker(&m_mutex);
     m_socketList.clear();
+    m_clients.clear();
     m_running.testAndSetOrdered(true, false);
     m_future.waitForFinished();
     m_localServer->close();
 }
 
-void NativeMessagingHost::readLength()
+void NativeMessagingHost::readNativeMessage(const QByteArray& message)
 {
-    quint32 length = 0;
-    std::cin.read(reinterpret_cast<char*>(&length), 4);
-    if (!std::cin.eof() && length > 0) {
-        readStdIn(length);
-    } else {
-        m_notifier->setEnabled(false);
-    }
-}
-
-void NativeMessagingHost::readStdIn(const quint32 length)
-{
-    if (length <= 0) {
-        return;
-    }
-
-    QByteArray arr;
-    arr.reserve(length);
-
     QMutexLocker locker(&m_mutex);
-
-    for (quint32 i = 0; i < length; ++i) {
-        int c = std::getchar();
-        if (c == EOF) {
-            // message ended prematurely, ignore it and return
-            return;
-        }
-        arr.append(static_cast<char>(c));
-    }
-
-    if (arr.length() > 0) {
-        sendReply(m_browserClients.readResponse(arr));
-    }
+    sendReply(m_browserClients.readResponse(BrowserClients::byteArrayToJson(message)));
 }
 
 void NativeMessagingHost::newLocalConnection()
 {
     QLocalSocket* socket = m_localServer->nextPendingConnection();
     if (socket) {
-        connect(socket, SIGNAL(readyRead()), this, SLOT(newLocalMessage()));
-        connect(socket, SIGNAL(disconnected()), this, SLOT(disconnectSocket()));
+        addLocalConnection(socket);
     }
 }
 
+void NativeMessagingHost::addLocalConnection(QLocalSocket* socket)
+{
+    connect(socket, SIGNAL(readyRead()), this, SLOT(newLocalMessage()));
+    connect(socket, SIGNAL(disconnected()), this, SLOT(disconnectSocket()));
+}
+
 void NativeMessagingHost::newLocalMessage()
 {
     QLocalSocket* socket = qobject_cast<QLocalSocket*>(QObject::sender());
@@ -174,27 +152,117 @@ void NativeMessagingHost::newLocalMessage()
         m_socketList.push_back(socket);
     }
 
-    QString reply = jsonToString(m_browserClients.readResponse(arr));
-    if (socket && socket->isValid() && socket->state() == QLocalSocket::ConnectedState) {
-        QByteArray arr = reply.toUtf8();
-        socket->write(arr.constData(), arr.length());
-        socket->flush();
+    Client& client = m_clients[socket];
+    if (!client.detected) {
+        // the handshake may be split across reads, wait until it is complete or ruled out
+        client.handshake.append(arr);
+        const QByteArray handshake = NativeMessagingFrames::handshake();
+        if (client.handshake.size() < handshake.size() && handshake.startsWith(client.handshake)) {
+            return;
+        }
+
+        client.detected = true;
+        arr = client.handshake;
+        client.handshake.clear();
+        if (arr.startsWith(handshake)) {
+            client.frames = QSharedPointer<NativeMessagingFrames>::create();
+            arr.remove(0, handshake.size());
+        }
+    }
+
+    const QSharedPointer<NativeMessagingFrames> frames = client.frames;
+    if (!frames) {
+        // unframed connection of an older proxy
+        handleLocalMessage(socket, 0, arr);
+        return;
+    }
+
+    frames->append(arr);
+    quint32 requestId;
+    QByteArray payload;
+    while (frames->takeFrame(requestId, payload)) {
+        handleLocalMessage(socket, requestId, payload);
+    }
+    if (frames->hasError()) {
+        socket->disconnectFromServer();
+    }
+}
+
+void NativeMessagingHost::handleLocalMessage(QLocalSocket* socket, quint32 requestId, const QByteArray& arr)
+{
+    // the position of the request on its connection, replies are written in this order
+    const quint64 sequence = m_clients[socket].nextRequest++;
+
+    const QJsonObject message = BrowserClients::byteArrayToJson(arr);
+    if (BrowserAction::isReadOnlyAction(message.value("action").toString())) {
+        // Handled on the thread pool, concurrently with other requests and
+        // without waiting for the GUI. The reply is written on this thread.
+        QPointer<QLocalSocket> client(socket);
+        auto watcher = new QFutureWatcher<QJsonObject>(this);
+        connect(watcher, &QFutureWatcher<QJsonObject>::finished, this, [this, watcher, client, requestId, sequence]() {
+            sendReplyToClient(client, requestId, sequence, watcher->result());
+            watcher->deleteLater();
+        });
+        watcher->setFuture(QtConcurrent::run(
+            &m_threadPool, [this, message]() { return m_browserClients.readResponse(message); }));
+        return;
+    }
+
+    sendReplyToClient(socket, requestId, sequence, m_browserClients.readResponse(message));
+}
+
+void NativeMessagingHost::sendReplyToClient(QLocalSocket* socket,
+                                            quint32 requestId,
+                                            quint64 sequence,
+                                            const QJsonObject& json)
+{
+    QMutexLocker locker(&m_mutex);
+    if (!socket) {
+        return;
+    }
+    auto client = m_clients.find(socket);
+    if (client == m_clients.end()) {
+        return;
+    }
+
+    // The browser matches replies to requests by their order, so replies
+    // of requests that finished early wait for the ones before them
+    client->replies.insert(sequence, encodeReply(*client, requestId, json));
+    while (!client->replies.isEmpty() && client->replies.firstKey() == client->nextReply) {
+        writeToClient(socket, client->replies.take(client->nextReply));
+        ++client->nextReply;
     }
 }
 
 void NativeMessagingHost::sendReplyToAllClients(const QJsonObject& json)
 {
-    QString reply = jsonToString(json);
     QMutexLocker locker(&m_mutex);
     for (const auto socket : m_socketList) {
-        if (socket && socket->isValid() && socket->state() == QLocalSocket::ConnectedState) {
-            QByteArray arr = reply.toUtf8();
-            socket->write(arr.constData(), arr.length());
-            socket->flush();
+        // a connection still sending its handshake can't be answered yet
+        auto client = m_clients.find(socket);
+        if (client != m_clients.end() && client->detected) {
+            writeToClient(socket, encodeReply(*client, 0, json));
         }
     }
 }
 
+QByteArray NativeMessagingHost::encodeReply(const Client& client, quint32 requestId, const QJsonObject& json) const
+{
+    const QByteArray arr = jsonToString(json).toUtf8();
+    if (client.frames) {
+        return NativeMessagingFrames::encode(requestId, arr);
+    }
+    return arr;
+}
+
+void NativeMessagingHost::writeToClient(QLocalSocket* socket, const QByteArray& arr)
+{
+    if (socket->isValid() && socket->state() == QLocalSocket::ConnectedState) {
+        socket->write(arr.constData(), arr.length());
+        socket->flush();
+    }
+}
+
 void NativeMessagingHost::disconnectSocket()
 {
     QLocalSocket* socket(qobject_cast<QLocalSocket*>(QObject::sender()));
@@ -204,6 +272,7 @@ void NativeMessagingHost::disconnectSocket()
             m_socketList.removeOne(s);
         }
     }
+    m_clients.remove(socket);
 }
 
 void NativeMessagingHost::removeSharedEncryptionKeys()
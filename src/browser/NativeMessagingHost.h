@@ -22,14 +22,33 @@
 #include "BrowserClients.h"
 #include "BrowserService.h"
 #include "NativeMessagingBase.h"
+#include "NativeMessagingFrames.h"
 #include "gui/DatabaseTabWidget.h"
 
+#include <QThreadPool>
+
 class NativeMessagingHost : public NativeMessagingBase
 {
     Q_OBJECT
 
     typedef QList<QLocalSocket*> SocketList;
 
+    /**
+     * State of a local connection. Read-only requests may finish out of
+     * order, their replies are buffered until all earlier ones are written.
+     */
+    struct Client
+    {
+        // bytes read before it is known whether the connection is framed
+        QByteArray handshake;
+        bool detected = false;
+        // null for unframed connections of older proxies
+        QSharedPointer<NativeMessagingFrames> frames;
+        quint64 nextRequest = 0;
+        quint64 nextReply = 0;
+        QMap<quint64, QByteArray> replies;
+    };
+
 public:
     explicit NativeMessagingHost(DatabaseTabWidget* parent = 0, const bool enabled = false);
     ~NativeMessagingHost();
@@ -45,9 +64,13 @@ signals:
     void quit();
 
 private:
-    void readLength();
-    void readStdIn(const quint32 length);
+    void readNativeMessage(const QByteArray& message) override;
+    void addLocalConnection(QLocalSocket* socket);
+    void handleLocalMessage(QLocalSocket* socket, quint32 requestId, const QByteArray& arr);
+    void sendReplyToClient(QLocalSocket* socket, quint32 requestId, quint64 sequence, const QJsonObject& json);
     void sendReplyToAllClients(const QJsonObject& json);
+    QByteArray encodeReply(const Client& client, quint32 requestId, const QJsonObject& json) const;
+    void writeToClient(QLocalSocket* socket, const QByteArray& arr);
 
 private slots:
     void databaseLocked();
@@ -62,6 +85,11 @@ private:
     BrowserService m_browserService;
     QSharedPointer<QLocalServer> m_localServer;
     SocketList m_socketList;
+    QHash<QLocalSocket*, Client> m_clients;
+    // destroyed first, waits for running requests
+    QThreadPool m_threadPool;
+
+    friend class TestBrowser;
 };
 
 #endif // NATIVEMESSAGINGHOST_H
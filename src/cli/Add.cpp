@@ -39,13 +39,8 @@ Add::~Add()
 {
 }
 
-int Add::execute(const QStringList& arguments)
+void Add::setupParser(QCommandLineParser& parser)
 {
-
-    QTextStream inputTextStream(stdin, QIODevice::ReadOnly);
-    QTextStream outputTextStream(stdout, QIODevice::WriteOnly);
-
-    QCommandLineParser parser;
     parser.setApplicationDescription(this->description);
     parser.addPositionalArgument("database", QObject::tr("Path of the database."));
 
@@ -81,7 +76,28 @@ int Add::execute(const QStringList& arguments)
     parser.addOption(length);
 
     parser.addPositionalArgument("entry", QObject::tr("Path of the entry to add."));
-    parser.process(arguments);
+}
+
+bool Add::canRunInSession(const QStringList& arguments)
+{
+    QCommandLineParser parser;
+    setupParser(parser);
+
+    // prompting for the password needs the terminal of the client
+    return parser.parse(arguments) && !parser.isSet("password-prompt");
+}
+
+int Add::execute(const QStringList& arguments)
+{
+
+    QTextStream inputTextStream(stdin, QIODevice::ReadOnly);
+    QTextStream outputTextStream(Utils::STDOUT);
+
+    QCommandLineParser parser;
+    setupParser(parser);
+    if (!parseArguments(parser, arguments)) {
+        return EXIT_FAILURE;
+    }
 
     const QStringList args = parser.positionalArguments();
     if (args.size() != 2) {
@@ -92,14 +108,14 @@ int Add::execute(const QStringList& arguments)
     QString databasePath = args.at(0);
     QString entryPath = args.at(1);
 
-    Database* db = Database::unlockFromStdin(databasePath, parser.value(keyFile));
+    Database* db = unlockDatabase(databasePath, parser.value("key-file"));
     if (db == nullptr) {
         return EXIT_FAILURE;
     }
 
     // Validating the password length here, before we actually create
     // the entry.
-    QString passwordLength = parser.value(length);
+    QString passwordLength = parser.value("password-length");
     if (!passwordLength.isEmpty() && !passwordLength.toInt()) {
         qCritical("Invalid value for password length %s.", qPrintable(passwordLength));
         return EXIT_FAILURE;
@@ -119,12 +135,12 @@ int Add::execute(const QStringList& arguments)
         entry->setUrl(parser.value("url"));
     }
 
-    if (parser.isSet(prompt)) {
+    if (parser.isSet("password-prompt")) {
         outputTextStream << "Enter password for new entry: ";
         outputTextStream.flush();
         QString password = Utils::getPassword();
         entry->setPassword(password);
-    } else if (parser.isSet(generate)) {
+    } else if (parser.isSet("generate")) {
         PasswordGenerator passwordGenerator;
 
         if (passwordLength.isEmpty()) {
@@ -139,7 +155,7 @@ int Add::execute(const QStringList& arguments)
         entry->setPassword(password);
     }
 
-    QString errorMessage = db->saveToFile(databasePath);
+    QString errorMessage = saveDatabase(db, databasePath);
     if (!errorMessage.isEmpty()) {
         qCritical("Writing the database failed %s.", qPrintable(errorMessage));
         return EXIT_FAILURE;
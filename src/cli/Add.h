@@ -26,6 +26,10 @@ public:
     Add();
     ~Add();
     int execute(const QStringList& arguments);
+    bool canRunInSession(const QStringList& arguments);
+
+private:
+    void setupParser(QCommandLineParser& parser);
 };
 
 #endif // KEEPASSXC_ADD_H
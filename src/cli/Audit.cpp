@@ -0,0 +1,124 @@
+/*
+ *  Copyright (C) 2018 KeePassXC Team <team@keepassxc.org>
+ *
+ *  This program is free software: you can redistribute it and/or modify
+ *  it under the terms of the GNU General Public License as published by
+ *  the Free Software Foundation, either version 2 or (at your option)
+ *  version 3 of the License.
+ *
+ *  This program is distributed in the hope that it will be useful,
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *  GNU General Public License for more details.
+ *
+ *  You should have received a copy of the GNU General Public License
+ *  along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#include <cstdlib>
+#include <stdio.h>
+
+#include "Audit.h"
+
+#include <QCommandLineParser>
+#include <QElapsedTimer>
+#include <QStringList>
+#include <QTextStream>
+
+#include "cli/EntryJsonWriter.h"
+#include "cli/Utils.h"
+#include "core/Database.h"
+#include "core/Entry.h"
+#include "core/Group.h"
+#include "core/PasswordAudit.h"
+
+Audit::Audit()
+{
+    name = QString("audit");
+    description = QObject::tr("Find weak, reused and expired passwords.");
+}
+
+Audit::~Audit()
+{
+}
+
+int Audit::execute(const QStringList& arguments)
+{
+    QTextStream out(Utils::STDOUT);
+
+    QCommandLineParser parser;
+    parser.setApplicationDescription(this->description);
+    parser.addPositionalArgument("database", QObject::tr("Path of the database."));
+    QCommandLineOption keyFile(QStringList() << "k"
+                                             << "key-file",
+                               QObject::tr("Key file of the database."),
+                               QObject::tr("path"));
+    parser.addOption(keyFile);
+    QCommandLineOption history("history", QObject::tr("Include the passwords of history items."));
+    parser.addOption(history);
+    QCommandLineOption entropy(QStringList() << "e"
+                                             << "entropy",
+                               QObject::tr("Entropy in bits below which a password is weak. Default is %1.")
+                                   .arg(PasswordAudit::DefaultWeakEntropy),
+                               QObject::tr("bits"));
+    parser.addOption(entropy);
+    if (!parseArguments(parser, arguments)) {
+        return EXIT_FAILURE;
+    }
+
+    const QStringList args = parser.positionalArguments();
+    if (args.size() != 1) {
+        out << parser.helpText().replace("keepassxc-cli", "keepassxc-cli audit");
+        return EXIT_FAILURE;
+    }
+
+    double weakEntropy = PasswordAudit::DefaultWeakEntropy;
+    if (parser.isSet(entropy)) {
+        bool ok;
+        weakEntropy = parser.value(entropy).toDouble(&ok);
+        if (!ok || weakEntropy < 0) {
+            qCritical("Invalid value for entropy %s.", qPrintable(parser.value(entropy)));
+            return EXIT_FAILURE;
+        }
+    }
+
+    Database* db = unlockDatabase(args.at(0), parser.value(keyFile));
+    if (db == nullptr) {
+        return EXIT_FAILURE;
+    }
+
+    QElapsedTimer timer;
+    timer.start();
+
+    PasswordAudit audit(weakEntropy);
+    audit.setIncludeHistory(parser.isSet(history));
+    audit.audit(db->rootGroup());
+
+    const qint64 elapsed = timer.elapsed();
+
+    // one line per entry: issues, entropy and path, separated by tabs
+    const QList<PasswordAudit::Result> results = audit.results();
+    for (const PasswordAudit::Result& result : results) {
+        QStringList issues;
+        if (result.weak) {
+            issues << "weak";
+        }
+        if (result.reuseCount > 0) {
+            issues << QString("reused(%1)").arg(result.reuseCount);
+        }
+        if (result.expired) {
+            issues << "expired";
+        }
+
+        QString path = EntryJsonWriter::entryPath(result.owner);
+        if (result.entry != result.owner) {
+            path += QString(" [history %1]").arg(result.entry->timeInfo().lastModificationTime().toString(Qt::ISODate));
+        }
+        out << issues.join(",") << "\t" << QString::number(result.entropy, 'f', 1) << "\t" << path << "\n";
+    }
+
+    out << "Audited " << audit.passwordCount() << " passwords (" << audit.uniquePasswordCount() << " distinct) in "
+        << elapsed << " ms: " << audit.weakCount() << " weak, " << audit.reusedCount() << " reused, "
+        << audit.expiredCount() << " expired." << endl;
+    return EXIT_SUCCESS;
+}
@@ -43,7 +43,7 @@ Clip::~Clip()
 int Clip::execute(const QStringList& arguments)
 {
 
-    QTextStream out(stdout);
+    QTextStream out(Utils::STDOUT);
 
     QCommandLineParser parser;
     parser.setApplicationDescription(this->description);
@@ -56,7 +56,9 @@ int Clip::execute(const QStringList& arguments)
     parser.addPositionalArgument("entry", QObject::tr("Path of the entry to clip.", "clip = copy to clipboard"));
     parser.addPositionalArgument(
         "timeout", QObject::tr("Timeout in seconds before clearing the clipboard."), QString("[timeout]"));
-    parser.process(arguments);
+    if (!parseArguments(parser, arguments)) {
+        return EXIT_FAILURE;
+    }
 
     const QStringList args = parser.positionalArguments();
     if (args.size() != 2 && args.size() != 3) {
@@ -64,7 +66,7 @@ int Clip::execute(const QStringList& arguments)
         return EXIT_FAILURE;
     }
 
-    Database* db = Database::unlockFromStdin(args.at(0), parser.value(keyFile));
+    Database* db = unlockDatabase(args.at(0), parser.value(keyFile));
     if (!db) {
         return EXIT_FAILURE;
     }
@@ -83,7 +85,7 @@ int Clip::clipEntry(Database* database, QString entryPath, QString timeout)
         timeoutSeconds = timeout.toInt();
     }
 
-    QTextStream outputTextStream(stdout, QIODevice::WriteOnly);
+    QTextStream outputTextStream(Utils::STDOUT);
     Entry* entry = database->rootGroup()->findEntry(entryPath);
     if (!entry) {
         qCritical("Entry %s not found.", qPrintable(entryPath));
@@ -18,23 +18,66 @@
 #include <cstdlib>
 #include <stdio.h>
 
+#include <QCommandLineParser>
 #include <QMap>
+#include <QTextStream>
 
 #include "Command.h"
 
 #include "Add.h"
+#include "Audit.h"
 #include "Clip.h"
 #include "Diceware.h"
 #include "Edit.h"
 #include "Estimate.h"
 #include "Extract.h"
 #include "Generate.h"
+#include "Import.h"
 #include "List.h"
 #include "Locate.h"
 #include "Merge.h"
+#include "Open.h"
 #include "Remove.h"
+#include "Session.h"
 #include "Show.h"
 
+#include "cli/DatabaseSession.h"
+#include "cli/Utils.h"
+
+namespace
+{
+    template <class T> Command* createCommand()
+    {
+        return new T();
+    }
+
+    struct CommandFactory
+    {
+        const char* name;
+        Command* (*create)();
+    };
+
+    // sorted by name, commands are only constructed when they are used
+    const CommandFactory CommandFactories[] = {
+        {"add", createCommand<Add>},
+        {"audit", createCommand<Audit>},
+        {"clip", createCommand<Clip>},
+        {"diceware", createCommand<Diceware>},
+        {"edit", createCommand<Edit>},
+        {"estimate", createCommand<Estimate>},
+        {"extract", createCommand<Extract>},
+        {"generate", createCommand<Generate>},
+        {"import", createCommand<Import>},
+        {"locate", createCommand<Locate>},
+        {"ls", createCommand<List>},
+        {"merge", createCommand<Merge>},
+        {"open", createCommand<Open>},
+        {"rm", createCommand<Remove>},
+        {"session", createCommand<Session>},
+        {"show", createCommand<Show>},
+    };
+} // namespace
+
 QMap<QString, Command*> commands;
 
 Command::~Command()
@@ -46,6 +89,11 @@ int Command::execute(const QStringList&)
     return EXIT_FAILURE;
 }
 
+bool Command::canRunInSession(const QStringList&)
+{
+    return false;
+}
+
 QString Command::getDescriptionLine()
 {
 
@@ -58,35 +106,56 @@ QString Command::getDescriptionLine()
     return response;
 }
 
-void populateCommands()
+bool Command::parseArguments(QCommandLineParser& parser, const QStringList& arguments)
+{
+    if (!parser.parse(arguments)) {
+        QTextStream errorTextStream(Utils::STDERR);
+        errorTextStream << parser.errorText() << endl;
+        return false;
+    }
+    return true;
+}
+
+Database* Command::unlockDatabase(const QString& databasePath, const QString& keyFilePath)
+{
+    DatabaseSession* session = DatabaseSession::current();
+    if (session && session->isFor(databasePath)) {
+        return session->database();
+    }
+    return Database::unlockFromStdin(databasePath, keyFilePath);
+}
+
+QString Command::saveDatabase(Database* database, const QString& databasePath)
 {
-    if (commands.isEmpty()) {
-        commands.insert(QString("add"), new Add());
-        commands.insert(QString("clip"), new Clip());
-        commands.insert(QString("diceware"), new Diceware());
-        commands.insert(QString("edit"), new Edit());
-        commands.insert(QString("estimate"), new Estimate());
-        commands.insert(QString("extract"), new Extract());
-        commands.insert(QString("generate"), new Generate());
-        commands.insert(QString("locate"), new Locate());
-        commands.insert(QString("ls"), new List());
-        commands.insert(QString("merge"), new Merge());
-        commands.insert(QString("rm"), new Remove());
-        commands.insert(QString("show"), new Show());
+    DatabaseSession* session = DatabaseSession::current();
+    if (session && session->database() == database) {
+        session->setModified();
+        return QString();
     }
+    return database->saveToFile(databasePath);
 }
 
 Command* Command::getCommand(QString commandName)
 {
-    populateCommands();
     if (commands.contains(commandName)) {
         return commands[commandName];
     }
+
+    for (const CommandFactory& factory : CommandFactories) {
+        if (commandName == QLatin1String(factory.name)) {
+            Command* command = factory.create();
+            commands.insert(commandName, command);
+            return command;
+        }
+    }
     return nullptr;
 }
 
 QList<Command*> Command::getCommands()
 {
-    populateCommands();
-    return commands.values();
+    QList<Command*> commandList;
+    for (const CommandFactory& factory : CommandFactories) {
+        commandList.append(getCommand(QString(factory.name)));
+    }
+    return commandList;
 }
@@ -25,17 +25,63 @@
 
 #include "core/Database.h"
 
+class QCommandLineParser;
+
 class Command
 {
 public:
+    /**
+     * How much of the cryptographic backend a command needs, so that
+     * commands which don't touch a database start without the self-tests.
+     */
+    enum CryptoUsage
+    {
+        NoCrypto,
+        CryptoBackend,
+        CryptoSelfTested
+    };
+
     virtual ~Command();
     virtual int execute(const QStringList& arguments);
+    /**
+     * Whether a session can run the command with these arguments. A
+     * session has neither the terminal nor the clipboard of the client.
+     */
+    virtual bool canRunInSession(const QStringList& arguments);
     QString name;
     QString description;
+    CryptoUsage cryptoUsage = CryptoSelfTested;
     QString getDescriptionLine();
 
+    /**
+     * Returns all commands, sorted by name. Constructs every command,
+     * use getCommand() when the name is known.
+     */
     static QList<Command*> getCommands();
+    /**
+     * Returns the command, constructing only this one on first use, or
+     * nullptr if there is no command with this name.
+     */
     static Command* getCommand(QString commandName);
+
+protected:
+    /**
+     * Parses the arguments, printing the error instead of exiting like
+     * QCommandLineParser::process() does, so that a typo doesn't end a
+     * session.
+     */
+    static bool parseArguments(QCommandLineParser& parser, const QStringList& arguments);
+    /**
+     * Returns the database of the current session if it is for
+     * databasePath, otherwise unlocks the database with a password read
+     * from stdin.
+     */
+    static Database* unlockDatabase(const QString& databasePath, const QString& keyFilePath);
+    /**
+     * Saves the database, or marks it as modified if it belongs to the
+     * current session.
+     */
+    static QString saveDatabase(Database* database, const QString& databasePath);
 };
 
 #endif // KEEPASSXC_COMMAND_H
@@ -0,0 +1,114 @@
+/*
+ *  Copyright (C) 2018 KeePassXC Team <team@keepassxc.org>
+ *
+ *  This program is free software: you can redistribute it and/or modify
+ *  it under the terms of the GNU General Public License as published by
+ *  the Free Software Foundation, either version 2 or (at your option)
+ *  version 3 of the License.
+ *
+ *  This program is distributed in the hope that it will be useful,
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *  GNU General Public License for more details.
+ *
+ *  You should have received a copy of the GNU General Public License
+ *  along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#include "DatabaseSession.h"
+
+#include <QCryptographicHash>
+#include <QFileInfo>
+
+#include "core/Database.h"
+
+namespace
+{
+    DatabaseSession* currentSession = nullptr;
+} // namespace
+
+DatabaseSession::DatabaseSession(Database* database, const QString& filePath)
+    : m_database(database)
+    , m_filePath(canonicalPath(filePath))
+    , m_modified(false)
+{
+}
+
+DatabaseSession::~DatabaseSession()
+{
+    if (currentSession == this) {
+        currentSession = nullptr;
+    }
+    delete m_database;
+}
+
+Database* DatabaseSession::database() const
+{
+    return m_database;
+}
+
+QString DatabaseSession::filePath() const
+{
+    return m_filePath;
+}
+
+bool DatabaseSession::isFor(const QString& databasePath) const
+{
+    return canonicalPath(databasePath) == m_filePath;
+}
+
+bool DatabaseSession::isModified() const
+{
+    return m_modified;
+}
+
+void DatabaseSession::setModified()
+{
+    m_modified = true;
+}
+
+QString DatabaseSession::save()
+{
+    if (!m_modified) {
+        return QString();
+    }
+
+    const QString errorMessage = m_database->saveToFile(m_filePath);
+    if (errorMessage.isEmpty()) {
+        m_modified = false;
+    }
+    return errorMessage;
+}
+
+DatabaseSession* DatabaseSession::current()
+{
+    return currentSession;
+}
+
+void DatabaseSession::setCurrent(DatabaseSession* session)
+{
+    currentSession = session;
+}
+
+QString DatabaseSession::canonicalPath(const QString& databasePath)
+{
+    const QFileInfo fileInfo(databasePath);
+    const QString canonicalFilePath = fileInfo.canonicalFilePath();
+    return canonicalFilePath.isEmpty() ? fileInfo.absoluteFilePath() : canonicalFilePath;
+}
+
+QString DatabaseSession::socketName(const QString& databasePath)
+{
+    QString userName = qgetenv("USER");
+    if (userName.isEmpty()) {
+        userName = qgetenv("USERNAME");
+    }
+    QString identifier = "keepassxc-cli";
+    if (!userName.isEmpty()) {
+        identifier += "-" + userName;
+    }
+
+    const QByteArray pathHash =
+        QCryptographicHash::hash(canonicalPath(databasePath).toUtf8(), QCryptographicHash::Sha256).toHex();
+    return identifier + "-" + pathHash.left(16) + ".socket";
+}
@@ -0,0 +1,68 @@
+/*
+ *  Copyright (C) 2018 KeePassXC Team <team@keepassxc.org>
+ *
+ *  This program is free software: you can redistribute it and/or modify
+ *  it under the terms of the GNU General Public License as published by
+ *  the Free Software Foundation, either version 2 or (at your option)
+ *  version 3 of the License.
+ *
+ *  This program is distributed in the hope that it will be useful,
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *  GNU General Public License for more details.
+ *
+ *  You should have received a copy of the GNU General Public License
+ *  along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#ifndef KEEPASSXC_DATABASESESSION_H
+#define KEEPASSXC_DATABASESESSION_H
+
+#include <QString>
+
+class Database;
+
+/**
+ * A database that stays unlocked while several commands run against it.
+ *
+ * While a session is current, Command::unlockDatabase() hands out its
+ * database instead of prompting for the credentials, and
+ * Command::saveDatabase() only marks it as modified. The owner of the
+ * session decides when the changes are written with save().
+ */
+class DatabaseSession
+{
+public:
+    DatabaseSession(Database* database, const QString& filePath);
+    ~DatabaseSession();
+
+    Database* database() const;
+    QString filePath() const;
+    bool isFor(const QString& databasePath) const;
+
+    bool isModified() const;
+    void setModified();
+    /**
+     * Writes the database if it was modified since the last save.
+     *
+     * @return an error message, empty on success
+     */
+    QString save();
+
+    static DatabaseSession* current();
+    static void setCurrent(DatabaseSession* session);
+
+    static QString canonicalPath(const QString& databasePath);
+    /**
+     * Name of the local socket a session daemon of databasePath listens on.
+     * It only depends on the user and the canonical path of the database.
+     */
+    static QString socketName(const QString& databasePath);
+
+private:
+    Database* const m_database;
+    const QString m_filePath;
+    bool m_modified;
+};
+
+#endif // KEEPASSXC_DATABASESESSION_H
@@ -21,14 +21,19 @@
 #include "Diceware.h"
 
 #include <QCommandLineParser>
+#include <QSaveFile>
 #include <QTextStream>
 
+#include "cli/Utils.h"
+#include "core/FilePath.h"
 #include "core/PassphraseGenerator.h"
+#include "core/WordList.h"
 
 Diceware::Diceware()
 {
     name = QString("diceware");
     description = QObject::tr("Generate a new random diceware passphrase.");
+    cryptoUsage = CryptoBackend;
 }
 
 Diceware::~Diceware()
@@ -38,7 +43,7 @@ Diceware::~Diceware()
 int Diceware::execute(const QStringList& arguments)
 {
     QTextStream inputTextStream(stdin, QIODevice::ReadOnly);
-    QTextStream outputTextStream(stdout, QIODevice::WriteOnly);
+    QTextStream outputTextStream(Utils::STDOUT);
 
     QCommandLineParser parser;
     parser.setApplicationDescription(this->description);
@@ -52,7 +57,19 @@ int Diceware::execute(const QStringList& arguments)
                                     QObject::tr("Wordlist for the diceware generator.\n[Default: EFF English]"),
                                     QObject::tr("path"));
     parser.addOption(wordlistFile);
-    parser.process(arguments);
+    QCommandLineOption count(QStringList() << "c"
+                                           << "count",
+                             QObject::tr("Number of passphrases to generate, one per line."),
+                             QObject::tr("count"));
+    parser.addOption(count);
+    QCommandLineOption compile("compile",
+                               QObject::tr("Write the wordlist in the compiled format, which loads without parsing, "
+                                           "to path instead of generating a passphrase."),
+                               QObject::tr("path"));
+    parser.addOption(compile);
+    if (!parseArguments(parser, arguments)) {
+        return EXIT_FAILURE;
+    }
 
     const QStringList args = parser.positionalArguments();
     if (!args.isEmpty()) {
@@ -69,10 +86,22 @@ int Diceware::execute(const QStringList& arguments)
         dicewareGenerator.setWordCount(wordcount);
     }
 
-    if (!parser.value(wordlistFile).isEmpty()) {
-        dicewareGenerator.setWordList(parser.value(wordlistFile));
-    } else {
-        dicewareGenerator.setDefaultWordList();
+    const QString wordlistPath = parser.value(wordlistFile).isEmpty()
+                                     ? filePath()->wordlistPath(PassphraseGenerator::DefaultWordList)
+                                     : parser.value(wordlistFile);
+    dicewareGenerator.setWordList(wordlistPath);
+
+    if (parser.isSet(compile)) {
+        return compileWordList(wordlistPath, parser.value(compile));
+    }
+
+    int passphraseCount = 1;
+    if (parser.isSet(count)) {
+        passphraseCount = parser.value(count).toInt();
+        if (passphraseCount <= 0) {
+            qCritical("Invalid value for count %s.", qPrintable(parser.value(count)));
+            return EXIT_FAILURE;
+        }
     }
 
     if (!dicewareGenerator.isValid()) {
@@ -80,8 +109,28 @@ int Diceware::execute(const QStringList& arguments)
         return EXIT_FAILURE;
     }
 
-    QString password = dicewareGenerator.generatePassphrase();
-    outputTextStream << password << endl;
+    const QStringList passphrases = dicewareGenerator.generatePassphrases(passphraseCount);
+    for (const QString& passphrase : passphrases) {
+        outputTextStream << passphrase << "\n";
+    }
+    outputTextStream.flush();
+
+    return EXIT_SUCCESS;
+}
+
+int Diceware::compileWordList(const QString& wordlistPath, const QString& outputPath)
+{
+    QSharedPointer<const WordList> wordList = WordList::load(wordlistPath);
+    if (!wordList) {
+        qCritical("Failed to load the wordlist %s.", qPrintable(wordlistPath));
+        return EXIT_FAILURE;
+    }
+
+    QSaveFile file(outputPath);
+    if (!file.open(QIODevice::WriteOnly) || !wordList->writeCompiled(&file) || !file.commit()) {
+        qCritical("Failed to write %s: %s", qPrintable(outputPath), qPrintable(file.errorString()));
+        return EXIT_FAILURE;
+    }
 
     return EXIT_SUCCESS;
 }
@@ -26,6 +26,9 @@ public:
     Diceware();
     ~Diceware();
     int execute(const QStringList& arguments);
+
+private:
+    int compileWordList(const QString& wordlistPath, const QString& outputPath);
 };
 
 #endif // KEEPASSXC_DICEWARE_H
@@ -39,13 +39,8 @@ Edit::~Edit()
 {
 }
 
-int Edit::execute(const QStringList& arguments)
+void Edit::setupParser(QCommandLineParser& parser)
 {
-
-    QTextStream inputTextStream(stdin, QIODevice::ReadOnly);
-    QTextStream outputTextStream(stdout, QIODevice::WriteOnly);
-
-    QCommandLineParser parser;
     parser.setApplicationDescription(this->description);
     parser.addPositionalArgument("database", QObject::tr("Path of the database."));
 
@@ -87,7 +82,28 @@ int Edit::execute(const QStringList& arguments)
     parser.addOption(length);
 
     parser.addPositionalArgument("entry", QObject::tr("Path of the entry to edit."));
-    parser.process(arguments);
+}
+
+bool Edit::canRunInSession(const QStringList& arguments)
+{
+    QCommandLineParser parser;
+    setupParser(parser);
+
+    // prompting for the password needs the terminal of the client
+    return parser.parse(arguments) && !parser.isSet("password-prompt");
+}
+
+int Edit::execute(const QStringList& arguments)
+{
+
+    QTextStream inputTextStream(stdin, QIODevice::ReadOnly);
+    QTextStream outputTextStream(Utils::STDOUT);
+
+    QCommandLineParser parser;
+    setupParser(parser);
+    if (!parseArguments(parser, arguments)) {
+        return EXIT_FAILURE;
+    }
 
     const QStringList args = parser.positionalArguments();
     if (args.size() != 2) {
@@ -98,12 +114,12 @@ int Edit::execute(const QStringList& arguments)
     QString databasePath = args.at(0);
     QString entryPath = args.at(1);
 
-    Database* db = Database::unlockFromStdin(databasePath, parser.value(keyFile));
+    Database* db = unlockDatabase(databasePath, parser.value("key-file"));
     if (db == nullptr) {
         return EXIT_FAILURE;
     }
 
-    QString passwordLength = parser.value(length);
+    QString passwordLength = parser.value("password-length");
     if (!passwordLength.isEmpty() && !passwordLength.toInt()) {
         qCritical("Invalid value for password length %s.", qPrintable(passwordLength));
         return EXIT_FAILURE;
@@ -116,8 +132,8 @@ int Edit::execute(const QStringList& arguments)
     }
 
     if (parser.value("username").isEmpty() && parser.value("url").isEmpty() && parser.value("title").isEmpty()
-        && !parser.isSet(prompt)
-        && !parser.isSet(generate)) {
+        && !parser.isSet("password-prompt")
+        && !parser.isSet("generate")) {
         qCritical("Not changing any field for entry %s.", qPrintable(entryPath));
         return EXIT_FAILURE;
     }
@@ -136,12 +152,12 @@ int Edit::execute(const QStringList& arguments)
         entry->setUrl(parser.value("url"));
     }
 
-    if (parser.isSet(prompt)) {
+    if (parser.isSet("password-prompt")) {
         outputTextStream << "Enter new password for entry: ";
         outputTextStream.flush();
         QString password = Utils::getPassword();
         entry->setPassword(password);
-    } else if (parser.isSet(generate)) {
+    } else if (parser.isSet("generate")) {
         PasswordGenerator passwordGenerator;
 
         if (passwordLength.isEmpty()) {
@@ -158,7 +174,7 @@ int Edit::execute(const QStringList& arguments)
 
     entry->endUpdate();
 
-    QString errorMessage = db->saveToFile(databasePath);
+    QString errorMessage = saveDatabase(db, databasePath);
     if (!errorMessage.isEmpty()) {
         qCritical("Writing the database failed %s.", qPrintable(errorMessage));
         return EXIT_FAILURE;
@@ -0,0 +1,167 @@
+/*
+ *  Copyright (C) 2018 KeePassXC Team <team@keepassxc.org>
+ *
+ *  This program is free software: you can redistribute it and/or modify
+ *  it under the terms of the GNU General Public License as published by
+ *  the Free Software Foundation, either version 2 or (at your option)
+ *  version 3 of the License.
+ *
+ *  This program is distributed in the hope that it will be useful,
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *  GNU General Public License for more details.
+ *
+ *  You should have received a copy of the GNU General Public License
+ *  along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#include "EntryImporter.h"
+
+#include "core/Database.h"
+#include "core/Entry.h"
+#include "core/Group.h"
+#include "core/PasswordGenerator.h"
+#include "core/PathIndex.h"
+
+namespace
+{
+    QString attributeKey(const QString& name)
+    {
+        const QString lowerName = name.toLower();
+        if (lowerName == "title") {
+            return EntryAttributes::TitleKey;
+        } else if (lowerName == "username") {
+            return EntryAttributes::UserNameKey;
+        } else if (lowerName == "password") {
+            return EntryAttributes::PasswordKey;
+        } else if (lowerName == "url") {
+            return EntryAttributes::URLKey;
+        } else if (lowerName == "notes") {
+            return EntryAttributes::NotesKey;
+        }
+        return name;
+    }
+} // namespace
+
+EntryImporter::EntryImporter(Database* db, DedupeMode dedupeMode, PasswordGenerator* passwordGenerator)
+    : m_db(db)
+    , m_dedupeMode(dedupeMode)
+    , m_passwordGenerator(passwordGenerator)
+    , m_importedCount(0)
+    , m_skippedCount(0)
+{
+    // paths are kept in the form of Group::path(), "/group/" and "/group/title"
+    db->rootGroup()->walkGroups([this](Group* group) {
+        const QString groupPath = group->path();
+        // the first group with a path wins, like in Group::findGroupByPath()
+        if (!m_groups.contains(groupPath)) {
+            m_groups.insert(groupPath, group);
+        }
+
+        for (const Entry* entry : group->entries()) {
+            m_entryPaths.insert(groupPath + entry->title());
+            m_uuids.insert(entry->uuid());
+        }
+        return false;
+    });
+}
+
+void EntryImporter::importRecord(const ImportRecord& record)
+{
+    QString title;
+    for (const auto& attribute : record.attributes) {
+        if (attribute.first == EntryAttributes::TitleKey) {
+            title = attribute.second;
+        }
+    }
+
+    const QString entryPath = PathIndex::normalizedGroupPath(record.groupNames.join("/")) + title;
+    Uuid uuid;
+    if (Uuid::isUuid(record.uuid)) {
+        uuid = Uuid::fromHex(record.uuid);
+    }
+
+    if ((m_dedupeMode == DedupePath && m_entryPaths.contains(entryPath))
+        || (m_dedupeMode == DedupeUuid && !uuid.isNull() && m_uuids.contains(uuid))) {
+        ++m_skippedCount;
+        return;
+    }
+    if (uuid.isNull() || m_uuids.contains(uuid)) {
+        uuid = Uuid::random();
+    }
+
+    // fill in the entry before it is added, so it is only announced once
+    Entry* entry = new Entry();
+    entry->setUuid(uuid);
+    EntryAttributes* attributes = entry->attributes();
+    for (const auto& attribute : record.attributes) {
+        attributes->set(attribute.first, attribute.second, attributes->isProtected(attribute.first));
+    }
+    if (m_passwordGenerator && entry->password().isEmpty()) {
+        entry->setPassword(m_passwordGenerator->generatePassword());
+    }
+    entry->setGroup(group(record.groupNames));
+
+    m_entryPaths.insert(entryPath);
+    m_uuids.insert(uuid);
+    ++m_importedCount;
+}
+
+int EntryImporter::importedCount() const
+{
+    return m_importedCount;
+}
+
+int EntryImporter::skippedCount() const
+{
+    return m_skippedCount;
+}
+
+QStringList EntryImporter::splitGroupPath(const QString& groupPath, const QString& rootGroupName)
+{
+    QStringList groupNames = groupPath.split("/", QString::SkipEmptyParts);
+    if (!groupPath.startsWith("/") && !groupNames.isEmpty() && groupNames.first() == rootGroupName) {
+        groupNames.removeFirst();
+    }
+    return groupNames;
+}
+
+void EntryImporter::setField(ImportRecord& record,
+                             const QString& name,
+                             const QString& value,
+                             const QString& rootGroupName)
+{
+    const QString lowerName = name.toLower();
+    if (lowerName == "group") {
+        record.groupNames = splitGroupPath(value, rootGroupName);
+    } else if (lowerName == "path") {
+        // the path written by ls --format json, it includes the title
+        record.groupNames = splitGroupPath(value, rootGroupName);
+        if (!record.groupNames.isEmpty()) {
+            record.attributes.prepend(qMakePair(EntryAttributes::TitleKey, record.groupNames.takeLast()));
+        }
+    } else if (lowerName == "uuid") {
+        record.uuid = value;
+    } else {
+        record.attributes.append(qMakePair(attributeKey(name), value));
+    }
+}
+
+Group* EntryImporter::group(const QStringList& groupNames)
+{
+    Group* parent = m_db->rootGroup();
+    QString groupPath("/");
+    for (const QString& groupName : groupNames) {
+        groupPath += groupName + "/";
+        Group* group = m_groups.value(groupPath);
+        if (!group) {
+            group = new Group();
+            group->setUuid(Uuid::random());
+            group->setName(groupName);
+            group->setParent(parent);
+            m_groups.insert(groupPath, group);
+        }
+        parent = group;
+    }
+    return parent;
+}
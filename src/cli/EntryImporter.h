@@ -0,0 +1,92 @@
+/*
+ *  Copyright (C) 2018 KeePassXC Team <team@keepassxc.org>
+ *
+ *  This program is free software: you can redistribute it and/or modify
+ *  it under the terms of the GNU General Public License as published by
+ *  the Free Software Foundation, either version 2 or (at your option)
+ *  version 3 of the License.
+ *
+ *  This program is distributed in the hope that it will be useful,
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *  GNU General Public License for more details.
+ *
+ *  You should have received a copy of the GNU General Public License
+ *  along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#ifndef KEEPASSXC_ENTRYIMPORTER_H
+#define KEEPASSXC_ENTRYIMPORTER_H
+
+#include <QHash>
+#include <QList>
+#include <QPair>
+#include <QSet>
+#include <QStringList>
+
+#include "core/Uuid.h"
+
+class Database;
+class Group;
+class PasswordGenerator;
+
+/**
+ * One entry read from the input, before it is added to the database.
+ */
+struct ImportRecord
+{
+    QStringList groupNames;
+    QString uuid;
+    QList<QPair<QString, QString>> attributes;
+};
+
+/**
+ * Adds records to a database. Groups are created by path as needed and
+ * looked up in a table, so an import doesn't search the tree per entry.
+ */
+class EntryImporter
+{
+public:
+    enum DedupeMode
+    {
+        DedupeNone,
+        DedupePath,
+        DedupeUuid
+    };
+
+    /**
+     * @param passwordGenerator generates passwords for records without one,
+     *        or nullptr to import them without password
+     */
+    EntryImporter(Database* db, DedupeMode dedupeMode, PasswordGenerator* passwordGenerator);
+
+    void importRecord(const ImportRecord& record);
+    int importedCount() const;
+    int skippedCount() const;
+
+    /**
+     * Splits a group path into group names. Paths written by the CSV export
+     * start with the name of the root group, paths with a leading slash are
+     * relative to the root group.
+     */
+    static QStringList splitGroupPath(const QString& groupPath, const QString& rootGroupName);
+    /**
+     * Adds a column or JSON value to the record. group, path and uuid are
+     * recognized in any case, everything else is an attribute.
+     */
+    static void setField(ImportRecord& record, const QString& name, const QString& value, const QString& rootGroupName);
+
+private:
+    Group* group(const QStringList& groupNames);
+
+    Database* const m_db;
+    const DedupeMode m_dedupeMode;
+    PasswordGenerator* const m_passwordGenerator;
+    QHash<QString, Group*> m_groups;
+    QSet<QString> m_entryPaths;
+    QSet<Uuid> m_uuids;
+    int m_importedCount;
+    int m_skippedCount;
+};
+
+#endif // KEEPASSXC_ENTRYIMPORTER_H
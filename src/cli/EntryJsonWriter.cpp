@@ -0,0 +1,153 @@
+/*
+ *  Copyright (C) 2018 KeePassXC Team <team@keepassxc.org>
+ *
+ *  This program is free software: you can redistribute it and/or modify
+ *  it under the terms of the GNU General Public License as published by
+ *  the Free Software Foundation, either version 2 or (at your option)
+ *  version 3 of the License.
+ *
+ *  This program is distributed in the hope that it will be useful,
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *  GNU General Public License for more details.
+ *
+ *  You should have received a copy of the GNU General Public License
+ *  along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#include "EntryJsonWriter.h"
+
+#include <QIODevice>
+#include <QJsonArray>
+#include <QJsonDocument>
+
+#include "core/Entry.h"
+#include "core/Group.h"
+
+const QStringList EntryJsonWriter::DefaultFields =
+    QStringList() << "uuid" << "path" << "Title" << "UserName" << "URL";
+const QStringList EntryJsonWriter::SpecialFields = QStringList() << "uuid" << "path" << "group";
+
+namespace
+{
+    QStringList uniqueFields(QStringList fields)
+    {
+        fields.removeDuplicates();
+        return fields;
+    }
+
+    // QJsonObject sorts its keys, so objects are written by hand and only
+    // the single values go through QJsonDocument for escaping
+    QByteArray jsonValue(const QJsonValue& value)
+    {
+        const QByteArray array = QJsonDocument(QJsonArray({value})).toJson(QJsonDocument::Compact);
+        return array.mid(1, array.size() - 2);
+    }
+} // namespace
+
+EntryJsonWriter::OutputFormat EntryJsonWriter::formatFromName(const QString& name)
+{
+    if (name == "text") {
+        return TextFormat;
+    }
+    if (name == "json") {
+        return JsonFormat;
+    }
+    if (name == "ndjson") {
+        return NdjsonFormat;
+    }
+    return InvalidFormat;
+}
+
+EntryJsonWriter::EntryJsonWriter(QIODevice* device, OutputFormat format, const QStringList& fields, bool resolve)
+    : m_device(device)
+    , m_format(format)
+    , m_fields(uniqueFields(fields))
+    , m_resolve(resolve)
+    , m_entryCount(0)
+    , m_finished(false)
+{
+    Q_ASSERT(format == JsonFormat || format == NdjsonFormat);
+}
+
+EntryJsonWriter::~EntryJsonWriter()
+{
+    finish();
+}
+
+void EntryJsonWriter::writeEntry(const Entry* entry)
+{
+    Q_ASSERT(!m_finished);
+
+    QByteArray data;
+    if (m_format == JsonFormat) {
+        data = m_entryCount == 0 ? "[\n" : ",\n";
+    }
+    data.append(toJson(entry));
+    if (m_format == NdjsonFormat) {
+        data.append('\n');
+    }
+
+    m_device->write(data);
+    ++m_entryCount;
+}
+
+void EntryJsonWriter::finish()
+{
+    if (m_finished) {
+        return;
+    }
+    m_finished = true;
+
+    if (m_format == JsonFormat) {
+        m_device->write(m_entryCount == 0 ? "[]\n" : "\n]\n");
+    }
+}
+
+int EntryJsonWriter::entryCount() const
+{
+    return m_entryCount;
+}
+
+QString EntryJsonWriter::entryPath(const Entry* entry)
+{
+    const Group* group = entry->group();
+    if (!group) {
+        return entry->title();
+    }
+    return group->path() + entry->title();
+}
+
+QByteArray EntryJsonWriter::toJson(const Entry* entry)
+{
+    const EntryAttributes* attributes = entry->attributes();
+
+    QByteArray object("{");
+    for (const QString& field : m_fields) {
+        QJsonValue value;
+        if (field == "uuid") {
+            value = entry->uuid().toHex();
+        } else if (field == "path") {
+            value = entryPath(entry);
+        } else if (field == "group") {
+            QString path = entry->group() ? entry->group()->path() : QString();
+            if (path.size() > 1) {
+                path.chop(1);
+            }
+            value = path;
+        } else if (attributes->contains(field)) {
+            const QString attribute = attributes->value(field);
+            value = m_resolve ? entry->resolveMultiplePlaceholders(attribute) : attribute;
+        }
+
+        if (object.size() > 1) {
+            object.append(',');
+        }
+        object.append(jsonValue(field));
+        object.append(':');
+        object.append(jsonValue(value));
+    }
+    object.append('}');
+
+    return object;
+}
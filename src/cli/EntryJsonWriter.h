@@ -0,0 +1,87 @@
+/*
+ *  Copyright (C) 2018 KeePassXC Team <team@keepassxc.org>
+ *
+ *  This program is free software: you can redistribute it and/or modify
+ *  it under the terms of the GNU General Public License as published by
+ *  the Free Software Foundation, either version 2 or (at your option)
+ *  version 3 of the License.
+ *
+ *  This program is distributed in the hope that it will be useful,
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *  GNU General Public License for more details.
+ *
+ *  You should have received a copy of the GNU General Public License
+ *  along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#ifndef KEEPASSXC_ENTRYJSONWRITER_H
+#define KEEPASSXC_ENTRYJSONWRITER_H
+
+#include <QByteArray>
+#include <QStringList>
+
+class Entry;
+class QIODevice;
+
+/**
+ * Writes entries as JSON objects while the tree is walked, so the output
+ * of a large database never has to be held in memory.
+ *
+ * The fields are the names of entry attributes, like Title or UserName,
+ * and the special fields uuid, path and group. Attributes an entry doesn't
+ * have are written as null. The keys of an object keep the order of the
+ * fields, repeated fields are written once.
+ */
+class EntryJsonWriter
+{
+public:
+    enum OutputFormat
+    {
+        InvalidFormat,
+        TextFormat,
+        /** One array, with one entry per line. */
+        JsonFormat,
+        /** One object per line, without an enclosing array. */
+        NdjsonFormat
+    };
+
+    static const QStringList DefaultFields;
+    static const QStringList SpecialFields;
+
+    static OutputFormat formatFromName(const QString& name);
+
+    /**
+     * @param fields names of the fields to write, in this order
+     * @param resolve resolve placeholders and references in attribute values
+     */
+    EntryJsonWriter(QIODevice* device,
+                    OutputFormat format,
+                    const QStringList& fields = DefaultFields,
+                    bool resolve = false);
+    ~EntryJsonWriter();
+
+    void writeEntry(const Entry* entry);
+    /**
+     * Closes the array in JSON format. Called by the destructor if needed.
+     */
+    void finish();
+    int entryCount() const;
+
+    /**
+     * Returns the path of the entry like locate prints it, e.g. /Group/Title.
+     */
+    static QString entryPath(const Entry* entry);
+
+private:
+    QByteArray toJson(const Entry* entry);
+
+    QIODevice* const m_device;
+    const OutputFormat m_format;
+    const QStringList m_fields;
+    const bool m_resolve;
+    int m_entryCount;
+    bool m_finished;
+};
+
+#endif // KEEPASSXC_ENTRYJSONWRITER_H
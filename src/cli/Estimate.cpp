@@ -25,6 +25,8 @@
 #include <string.h>
 #include <zxcvbn.h>
 
+#include "cli/Utils.h"
+
 /* For pre-compiled headers under windows */
 #ifdef _WIN32
 #ifndef __MINGW32__
@@ -36,6 +38,7 @@ Estimate::Estimate()
 {
     name = QString("estimate");
     description = QObject::tr("Estimate the entropy of a password.");
+    cryptoUsage = NoCrypto;
 }
 
 Estimate::~Estimate()
@@ -141,7 +144,7 @@ static void estimate(const char* pwd, bool advanced)
 int Estimate::execute(const QStringList& arguments)
 {
     QTextStream inputTextStream(stdin, QIODevice::ReadOnly);
-    QTextStream outputTextStream(stdout, QIODevice::WriteOnly);
+    QTextStream outputTextStream(Utils::STDOUT);
 
     QCommandLineParser parser;
     parser.setApplicationDescription(this->description);
@@ -150,7 +153,9 @@ int Estimate::execute(const QStringList& arguments)
                                                     << "advanced",
                                       QObject::tr("Perform advanced analysis on the password."));
     parser.addOption(advancedOption);
-    parser.process(arguments);
+    if (!parseArguments(parser, arguments)) {
+        return EXIT_FAILURE;
+    }
 
     const QStringList args = parser.positionalArguments();
     if (args.size() > 1) {
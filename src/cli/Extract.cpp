@@ -43,8 +43,8 @@ Extract::~Extract()
 
 int Extract::execute(const QStringList& arguments)
 {
-    QTextStream out(stdout);
-    QTextStream errorTextStream(stderr);
+    QTextStream out(Utils::STDOUT);
+    QTextStream errorTextStream(Utils::STDERR);
 
     QCommandLineParser parser;
     parser.setApplicationDescription(this->description);
@@ -54,7 +54,17 @@ int Extract::execute(const QStringList& arguments)
                                QObject::tr("Key file of the database."),
                                QObject::tr("path"));
     parser.addOption(keyFile);
-    parser.process(arguments);
+    QCommandLineOption stream(QStringList() << "s"
+                                            << "stream",
+                              QObject::tr("Write the XML while it is decrypted, without reading the database."));
+    parser.addOption(stream);
+    QCommandLineOption unprotect(QStringList() << "u"
+                                               << "unprotect",
+                                 QObject::tr("Write protected values in plain text. Implies --stream."));
+    parser.addOption(unprotect);
+    if (!parseArguments(parser, arguments)) {
+        return EXIT_FAILURE;
+    }
 
     const QStringList args = parser.positionalArguments();
     if (args.size() != 1) {
@@ -104,6 +114,18 @@ int Extract::execute(const QStringList& arguments)
     }
 
     KeePass2Reader reader;
+    if (parser.isSet(stream) || parser.isSet(unprotect)) {
+        reader.setXmlOutput(Utils::STDOUT, parser.isSet(unprotect));
+        reader.readDatabase(&dbFile, compositeKey);
+        if (reader.hasError()) {
+            qCritical("Error while reading the database:\n%s", qPrintable(reader.errorString()));
+            return EXIT_FAILURE;
+        }
+
+        out << "\n";
+        return EXIT_SUCCESS;
+    }
+
     reader.setSaveXml(true);
     Database* db = reader.readDatabase(&dbFile, compositeKey);
     delete db;
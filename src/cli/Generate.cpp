@@ -23,12 +23,14 @@
 #include <QCommandLineParser>
 #include <QTextStream>
 
+#include "cli/Utils.h"
 #include "core/PasswordGenerator.h"
 
 Generate::Generate()
 {
     name = QString("generate");
     description = QObject::tr("Generate a new random password.");
+    cryptoUsage = CryptoBackend;
 }
 
 Generate::~Generate()
@@ -38,7 +40,7 @@ Generate::~Generate()
 int Generate::execute(const QStringList& arguments)
 {
     QTextStream inputTextStream(stdin, QIODevice::ReadOnly);
-    QTextStream outputTextStream(stdout, QIODevice::WriteOnly);
+    QTextStream outputTextStream(Utils::STDOUT);
 
     QCommandLineParser parser;
     parser.setApplicationDescription(this->description);
@@ -57,7 +59,14 @@ int Generate::execute(const QStringList& arguments)
     parser.addOption(special);
     QCommandLineOption extended(QStringList() << "e", QObject::tr("Use extended ASCII in the generated password."));
     parser.addOption(extended);
-    parser.process(arguments);
+    QCommandLineOption count(QStringList() << "c"
+                                           << "count",
+                             QObject::tr("Number of passwords to generate."),
+                             QObject::tr("count"));
+    parser.addOption(count);
+    if (!parseArguments(parser, arguments)) {
+        return EXIT_FAILURE;
+    }
 
     const QStringList args = parser.positionalArguments();
     if (!args.isEmpty()) {
@@ -95,13 +104,25 @@ int Generate::execute(const QStringList& arguments)
     passwordGenerator.setCharClasses(classes);
     passwordGenerator.setFlags(PasswordGenerator::DefaultFlags);
 
+    int passwordCount = 1;
+    if (parser.isSet(count)) {
+        passwordCount = parser.value(count).toInt();
+        if (passwordCount <= 0) {
+            qCritical("Invalid value for count %s.", qPrintable(parser.value(count)));
+            return EXIT_FAILURE;
+        }
+    }
+
     if (!passwordGenerator.isValid()) {
         outputTextStream << parser.helpText().replace("keepassxc-cli", "keepassxc-cli generate");
         return EXIT_FAILURE;
     }
 
-    QString password = passwordGenerator.generatePassword();
-    outputTextStream << password << endl;
+    const QStringList passwords = passwordGenerator.generatePasswords(passwordCount);
+    for (const QString& password : passwords) {
+        outputTextStream << password << "\n";
+    }
+    outputTextStream.flush();
 
     return EXIT_SUCCESS;
 }
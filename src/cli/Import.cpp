@@ -0,0 +1,267 @@
+/*
+ *  Copyright (C) 2018 KeePassXC Team <team@keepassxc.org>
+ *
+ *  This program is free software: you can redistribute it and/or modify
+ *  it under the terms of the GNU General Public License as published by
+ *  the Free Software Foundation, either version 2 or (at your option)
+ *  version 3 of the License.
+ *
+ *  This program is distributed in the hope that it will be useful,
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *  GNU General Public License for more details.
+ *
+ *  You should have received a copy of the GNU General Public License
+ *  along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#include <cstdlib>
+#include <stdio.h>
+
+#include "Import.h"
+
+#include <QBuffer>
+#include <QCommandLineParser>
+#include <QElapsedTimer>
+#include <QFile>
+#include <QJsonDocument>
+#include <QJsonObject>
+#include <QTextStream>
+
+#include "cli/EntryImporter.h"
+#include "cli/Utils.h"
+#include "core/CsvParser.h"
+#include "core/Database.h"
+#include "core/Group.h"
+#include "core/PasswordGenerator.h"
+
+namespace
+{
+    /**
+     * Columns of a CSV file without header, as written by the CSV export.
+     */
+    const char* const DefaultCsvColumns[] = {"Group", "Title", "Username", "Password", "URL", "Notes"};
+
+    /**
+     * Imports a CSV file. The first row is a header if it has a Title
+     * column, otherwise the columns of the CSV export are assumed.
+     */
+    bool importCsv(QIODevice* device, EntryImporter& importer, const QString& rootGroupName)
+    {
+        CsvParser parser;
+        if (!parser.parse(device)) {
+            qCritical("Failed to parse the CSV input: %s", qPrintable(parser.getStatus()));
+            return false;
+        }
+
+        const CsvTable table = parser.getCsvTable();
+        QStringList columns;
+        int firstRow = 0;
+        if (!table.isEmpty() && table.first().contains("title", Qt::CaseInsensitive)) {
+            columns = table.first();
+            firstRow = 1;
+        } else {
+            for (const char* column : DefaultCsvColumns) {
+                columns << QString(column);
+            }
+        }
+
+        for (int row = firstRow; row < table.size(); ++row) {
+            const CsvRow& values = table.at(row);
+            ImportRecord record;
+            bool isEmpty = true;
+            for (int column = 0; column < values.size() && column < columns.size(); ++column) {
+                if (!values.at(column).isEmpty()) {
+                    EntryImporter::setField(record, columns.at(column), values.at(column), rootGroupName);
+                    isEmpty = false;
+                }
+            }
+            if (!isEmpty) {
+                importer.importRecord(record);
+            }
+        }
+        return true;
+    }
+
+    /**
+     * Imports one JSON object per line, as written by ls --format ndjson.
+     * Lines are imported as they are read.
+     *
+     * @param inputTextStream stream to read, or nullptr to read stdin
+     */
+    bool importNdjson(QTextStream* inputTextStream, EntryImporter& importer, const QString& rootGroupName)
+    {
+        for (int lineNumber = 1;; ++lineNumber) {
+            // stdin is read through Utils, which also reads the password
+            const QString line = inputTextStream ? inputTextStream->readLine() : Utils::readLine();
+            if (line.isNull()) {
+                return true;
+            }
+            if (line.trimmed().isEmpty()) {
+                continue;
+            }
+
+            QJsonParseError error;
+            const QJsonDocument document = QJsonDocument::fromJson(line.toUtf8(), &error);
+            if (!document.isObject()) {
+                qCritical("Invalid JSON object on line %d: %s",
+                          lineNumber,
+                          qPrintable(error.error != QJsonParseError::NoError ? error.errorString() : line));
+                return false;
+            }
+
+            ImportRecord record;
+            const QJsonObject object = document.object();
+            for (auto it = object.constBegin(); it != object.constEnd(); ++it) {
+                const QJsonValue value = it.value();
+                if (value.isString()) {
+                    EntryImporter::setField(record, it.key(), value.toString(), rootGroupName);
+                } else if (value.isDouble() || value.isBool()) {
+                    EntryImporter::setField(record, it.key(), value.toVariant().toString(), rootGroupName);
+                }
+            }
+            importer.importRecord(record);
+        }
+    }
+} // namespace
+
+Import::Import()
+{
+    name = QString("import");
+    description = QObject::tr("Import entries from a CSV or NDJSON file.");
+}
+
+Import::~Import()
+{
+}
+
+int Import::execute(const QStringList& arguments)
+{
+    QTextStream outputTextStream(Utils::STDOUT);
+
+    QCommandLineParser parser;
+    parser.setApplicationDescription(this->description);
+    parser.addPositionalArgument("database", QObject::tr("Path of the database."));
+    parser.addPositionalArgument(
+        "file", QObject::tr("Path of the file to import. Default is the standard input."), QString("[file]"));
+    QCommandLineOption keyFile(QStringList() << "k"
+                                             << "key-file",
+                               QObject::tr("Key file of the database."),
+                               QObject::tr("path"));
+    parser.addOption(keyFile);
+    QCommandLineOption format("format",
+                              QObject::tr("Input format: csv or ndjson. "
+                                          "Default is ndjson for .ndjson and .jsonl files and csv otherwise."),
+                              QObject::tr("format"));
+    parser.addOption(format);
+    QCommandLineOption dedupe("dedupe",
+                              QObject::tr("Skip entries that already exist with the same path, the same uuid or none. "
+                                          "Default is path."),
+                              QObject::tr("path|uuid|none"),
+                              QString("path"));
+    parser.addOption(dedupe);
+    QCommandLineOption generate(QStringList() << "g"
+                                              << "generate",
+                                QObject::tr("Generate a password for entries without password."));
+    parser.addOption(generate);
+    QCommandLineOption length(QStringList() << "l"
+                                            << "password-length",
+                              QObject::tr("Length for the generated passwords."),
+                              QObject::tr("length"));
+    parser.addOption(length);
+    if (!parseArguments(parser, arguments)) {
+        return EXIT_FAILURE;
+    }
+
+    const QStringList args = parser.positionalArguments();
+    if (args.size() != 1 && args.size() != 2) {
+        outputTextStream << parser.helpText().replace("keepassxc-cli", "keepassxc-cli import");
+        return EXIT_FAILURE;
+    }
+
+    const QString databasePath = args.at(0);
+    const QString filePath = args.size() == 2 && args.at(1) != "-" ? args.at(1) : QString();
+
+    QString inputFormat = parser.value(format);
+    if (inputFormat.isEmpty()) {
+        inputFormat = filePath.endsWith(".ndjson") || filePath.endsWith(".jsonl") ? "ndjson" : "csv";
+    }
+    if (inputFormat != "csv" && inputFormat != "ndjson") {
+        qCritical("Unknown input format %s.", qPrintable(inputFormat));
+        return EXIT_FAILURE;
+    }
+
+    EntryImporter::DedupeMode dedupeMode;
+    if (parser.value(dedupe) == "path") {
+        dedupeMode = EntryImporter::DedupePath;
+    } else if (parser.value(dedupe) == "uuid") {
+        dedupeMode = EntryImporter::DedupeUuid;
+    } else if (parser.value(dedupe) == "none") {
+        dedupeMode = EntryImporter::DedupeNone;
+    } else {
+        qCritical("Invalid value for dedupe %s.", qPrintable(parser.value(dedupe)));
+        return EXIT_FAILURE;
+    }
+
+    const QString passwordLength = parser.value(length);
+    if (!passwordLength.isEmpty() && !passwordLength.toInt()) {
+        qCritical("Invalid value for password length %s.", qPrintable(passwordLength));
+        return EXIT_FAILURE;
+    }
+
+    QFile file(filePath);
+    if (!filePath.isEmpty() && !file.open(QIODevice::ReadOnly)) {
+        qCritical("Failed to open %s: %s", qPrintable(filePath), qPrintable(file.errorString()));
+        return EXIT_FAILURE;
+    }
+
+    Database* db = unlockDatabase(databasePath, parser.value(keyFile));
+    if (db == nullptr) {
+        return EXIT_FAILURE;
+    }
+
+    PasswordGenerator passwordGenerator;
+    passwordGenerator.setLength(passwordLength.isEmpty() ? PasswordGenerator::DefaultLength : passwordLength.toInt());
+    passwordGenerator.setCharClasses(PasswordGenerator::DefaultCharset);
+    passwordGenerator.setFlags(PasswordGenerator::DefaultFlags);
+
+    QElapsedTimer timer;
+    timer.start();
+
+    EntryImporter importer(db, dedupeMode, parser.isSet(generate) ? &passwordGenerator : nullptr);
+    const QString rootGroupName = db->rootGroup()->name();
+    bool success;
+    if (inputFormat == "ndjson") {
+        QTextStream fileTextStream(&file);
+        fileTextStream.setCodec("UTF-8");
+        success = importNdjson(filePath.isEmpty() ? nullptr : &fileTextStream, importer, rootGroupName);
+    } else if (filePath.isEmpty()) {
+        // the CSV parser needs all of the input, read stdin where the password was read from
+        QBuffer buffer;
+        for (QString line = Utils::readLine(); !line.isNull(); line = Utils::readLine()) {
+            buffer.buffer().append(line.toUtf8()).append('\n');
+        }
+        success = importCsv(&buffer, importer, rootGroupName);
+    } else {
+        success = importCsv(&file, importer, rootGroupName);
+    }
+    if (!success) {
+        return EXIT_FAILURE;
+    }
+
+    const qint64 importTime = qMax<qint64>(timer.elapsed(), 1);
+
+    if (importer.importedCount() > 0) {
+        QString errorMessage = saveDatabase(db, databasePath);
+        if (!errorMessage.isEmpty()) {
+            qCritical("Writing the database failed %s.", qPrintable(errorMessage));
+            return EXIT_FAILURE;
+        }
+    }
+
+    outputTextStream << "Imported " << importer.importedCount() << " entries in " << importTime << " ms ("
+                     << qRound64(importer.importedCount() * 1000.0 / importTime) << " entries/s), skipped "
+                     << importer.skippedCount() << " duplicates, saved in " << timer.elapsed() - importTime << " ms."
+                     << endl;
+    return EXIT_SUCCESS;
+}
@@ -23,6 +23,8 @@
 #include <QCommandLineParser>
 #include <QTextStream>
 
+#include "cli/EntryJsonWriter.h"
+#include "cli/Utils.h"
 #include "core/Database.h"
 #include "core/Entry.h"
 #include "core/Group.h"
@@ -37,9 +39,14 @@ List::~List()
 {
 }
 
+bool List::canRunInSession(const QStringList&)
+{
+    return true;
+}
+
 int List::execute(const QStringList& arguments)
 {
-    QTextStream out(stdout);
+    QTextStream out(Utils::STDOUT);
 
     QCommandLineParser parser;
     parser.setApplicationDescription(this->description);
@@ -50,7 +57,27 @@ int List::execute(const QStringList& arguments)
                                QObject::tr("Key file of the database."),
                                QObject::tr("path"));
     parser.addOption(keyFile);
-    parser.process(arguments);
+    QCommandLineOption recursive(QStringList() << "R"
+                                               << "recursive",
+                                 QObject::tr("Recursive mode, list elements recursively"));
+    parser.addOption(recursive);
+    QCommandLineOption format("format",
+                              QObject::tr("Output format: text, json or ndjson. Default is text."),
+                              QObject::tr("format"),
+                              QString("text"));
+    parser.addOption(format);
+    QCommandLineOption attributes(QStringList() << "a"
+                                                << "attributes",
+                                  QObject::tr("Names of the attributes to output in json and ndjson format. "
+                                              "This option can be specified more than once. "
+                                              "The default is uuid, path, Title, UserName and URL."),
+                                  QObject::tr("attribute"));
+    parser.addOption(attributes);
+    QCommandLineOption resolve("resolve", QObject::tr("Resolve placeholders and references in json and ndjson format."));
+    parser.addOption(resolve);
+    if (!parseArguments(parser, arguments)) {
+        return EXIT_FAILURE;
+    }
 
     const QStringList args = parser.positionalArguments();
     if (args.size() != 1 && args.size() != 2) {
@@ -58,33 +85,58 @@ int List::execute(const QStringList& arguments)
         return EXIT_FAILURE;
     }
 
-    Database* db = Database::unlockFromStdin(args.at(0), parser.value(keyFile));
+    const EntryJsonWriter::OutputFormat outputFormat = EntryJsonWriter::formatFromName(parser.value(format));
+    if (outputFormat == EntryJsonWriter::InvalidFormat) {
+        qCritical("Unknown output format %s.", qPrintable(parser.value(format)));
+        return EXIT_FAILURE;
+    }
+
+    Database* db = unlockDatabase(args.at(0), parser.value(keyFile));
     if (db == nullptr) {
         return EXIT_FAILURE;
     }
 
+    Group* group = db->rootGroup();
     if (args.size() == 2) {
-        return this->listGroup(db, args.at(1));
+        group = group->findGroupByPath(args.at(1));
+        if (group == nullptr) {
+            qCritical("Cannot find group %s.", qPrintable(args.at(1)));
+            return EXIT_FAILURE;
+        }
     }
-    return this->listGroup(db);
-}
 
-int List::listGroup(Database* database, QString groupPath)
-{
-    QTextStream outputTextStream(stdout, QIODevice::WriteOnly);
-    if (groupPath.isEmpty()) {
-        outputTextStream << database->rootGroup()->print();
-        outputTextStream.flush();
+    if (outputFormat == EntryJsonWriter::TextFormat) {
+        out << group->print(parser.isSet(recursive));
+        out.flush();
         return EXIT_SUCCESS;
     }
 
-    Group* group = database->rootGroup()->findGroupByPath(groupPath);
-    if (group == nullptr) {
-        qCritical("Cannot find group %s.", qPrintable(groupPath));
-        return EXIT_FAILURE;
+    QStringList fields = parser.values(attributes);
+    if (fields.isEmpty()) {
+        fields = EntryJsonWriter::DefaultFields;
+    }
+    EntryJsonWriter writer(Utils::STDOUT, outputFormat, fields, parser.isSet(resolve));
+    return this->listEntries(group, writer, parser.isSet(recursive));
+}
+
+/**
+ * Writes the entries of the group, and of its subgroups in recursive mode,
+ * one at a time. Subgroups are only visible through the paths of their
+ * entries.
+ */
+int List::listEntries(const Group* group, EntryJsonWriter& writer, bool recursive)
+{
+    if (recursive) {
+        group->walkEntries([&writer](const Entry* entry) {
+            writer.writeEntry(entry);
+            return false;
+        });
+    } else {
+        for (const Entry* entry : group->entries()) {
+            writer.writeEntry(entry);
+        }
     }
 
-    outputTextStream << group->print();
-    outputTextStream.flush();
+    writer.finish();
     return EXIT_SUCCESS;
 }
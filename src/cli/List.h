@@ -20,13 +20,17 @@
 
 #include "Command.h"
 
+class EntryJsonWriter;
+class Group;
+
 class List : public Command
 {
 public:
     List();
     ~List();
     int execute(const QStringList& arguments);
-    int listGroup(Database* database, QString groupPath = QString(""));
+    bool canRunInSession(const QStringList& arguments);
+    int listEntries(const Group* group, EntryJsonWriter& writer, bool recursive);
 };
 
 #endif // KEEPASSXC_LIST_H
@@ -24,6 +24,7 @@
 #include <QStringList>
 #include <QTextStream>
 
+#include "cli/EntryJsonWriter.h"
 #include "cli/Utils.h"
 #include "core/Database.h"
 #include "core/Entry.h"
@@ -39,10 +40,15 @@ Locate::~Locate()
 {
 }
 
+bool Locate::canRunInSession(const QStringList&)
+{
+    return true;
+}
+
 int Locate::execute(const QStringList& arguments)
 {
 
-    QTextStream out(stdout);
+    QTextStream out(Utils::STDOUT);
 
     QCommandLineParser parser;
     parser.setApplicationDescription(this->description);
@@ -53,7 +59,23 @@ int Locate::execute(const QStringList& arguments)
                                QObject::tr("Key file of the database."),
                                QObject::tr("path"));
     parser.addOption(keyFile);
-    parser.process(arguments);
+    QCommandLineOption format("format",
+                              QObject::tr("Output format: text, json or ndjson. Default is text."),
+                              QObject::tr("format"),
+                              QString("text"));
+    parser.addOption(format);
+    QCommandLineOption attributes(QStringList() << "a"
+                                                << "attributes",
+                                  QObject::tr("Names of the attributes to output in json and ndjson format. "
+                                              "This option can be specified more than once. "
+                                              "The default is uuid, path, Title, UserName and URL."),
+                                  QObject::tr("attribute"));
+    parser.addOption(attributes);
+    QCommandLineOption resolve("resolve", QObject::tr("Resolve placeholders and references in json and ndjson format."));
+    parser.addOption(resolve);
+    if (!parseArguments(parser, arguments)) {
+        return EXIT_FAILURE;
+    }
 
     const QStringList args = parser.positionalArguments();
     if (args.size() != 2) {
@@ -61,26 +83,65 @@ int Locate::execute(const QStringList& arguments)
         return EXIT_FAILURE;
     }
 
-    Database* db = Database::unlockFromStdin(args.at(0), parser.value(keyFile));
+    const EntryJsonWriter::OutputFormat outputFormat = EntryJsonWriter::formatFromName(parser.value(format));
+    if (outputFormat == EntryJsonWriter::InvalidFormat) {
+        qCritical("Unknown output format %s.", qPrintable(parser.value(format)));
+        return EXIT_FAILURE;
+    }
+
+    Database* db = unlockDatabase(args.at(0), parser.value(keyFile));
     if (!db) {
         return EXIT_FAILURE;
     }
 
-    return this->locateEntry(db, args.at(1));
+    if (outputFormat == EntryJsonWriter::TextFormat) {
+        return this->locateEntry(db, args.at(1));
+    }
+
+    QStringList fields = parser.values(attributes);
+    if (fields.isEmpty()) {
+        fields = EntryJsonWriter::DefaultFields;
+    }
+    EntryJsonWriter writer(Utils::STDOUT, outputFormat, fields, parser.isSet(resolve));
+    this->findEntries(db, args.at(1), [&writer](const Entry* entry, const QString&) { writer.writeEntry(entry); });
+    writer.finish();
+    return EXIT_SUCCESS;
 }
 
 int Locate::locateEntry(Database* database, QString searchTerm)
 {
 
-    QTextStream outputTextStream(stdout, QIODevice::WriteOnly);
-    QStringList results = database->rootGroup()->locate(searchTerm);
-    if (results.isEmpty()) {
+    QTextStream outputTextStream(Utils::STDOUT);
+    const int resultCount = this->findEntries(
+        database, searchTerm, [&outputTextStream](const Entry*, const QString& path) { outputTextStream << path << endl; });
+    if (resultCount == 0) {
         outputTextStream << "No results for that search term" << endl;
-        return EXIT_SUCCESS;
-    }
-
-    for (QString result : results) {
-        outputTextStream << result << endl;
     }
     return EXIT_SUCCESS;
 }
+
+/**
+ * Calls found with every entry whose path contains the search term, in the
+ * order of Group::locate, while the tree is walked.
+ *
+ * @return number of entries found
+ */
+int Locate::findEntries(Database* database,
+                        const QString& searchTerm,
+                        const std::function<void(const Entry*, const QString&)>& found)
+{
+    const QString lowerSearchTerm = searchTerm.toLower();
+    int resultCount = 0;
+    database->rootGroup()->walkGroups([&](const Group* group) {
+        const QString groupPath = group->path();
+        for (const Entry* entry : group->entries()) {
+            const QString entryPath = groupPath + entry->title();
+            if (entryPath.toLower().contains(lowerSearchTerm)) {
+                found(entry, entryPath);
+                ++resultCount;
+            }
+        }
+        return false;
+    });
+    return resultCount;
+}
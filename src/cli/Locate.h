@@ -18,15 +18,23 @@
 #ifndef KEEPASSXC_LOCATE_H
 #define KEEPASSXC_LOCATE_H
 
+#include <functional>
+
 #include "Command.h"
 
+class Entry;
+
 class Locate : public Command
 {
 public:
     Locate();
     ~Locate();
     int execute(const QStringList& arguments);
+    bool canRunInSession(const QStringList& arguments);
     int locateEntry(Database* database, QString searchTerm);
+    int findEntries(Database* database,
+                    const QString& searchTerm,
+                    const std::function<void(const Entry*, const QString&)>& found);
 };
 
 #endif // KEEPASSXC_LOCATE_H
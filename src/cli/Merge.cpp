@@ -22,7 +22,49 @@
 #include <QCommandLineParser>
 #include <QTextStream>
 
+#include "cli/Utils.h"
 #include "core/Database.h"
+#include "core/Entry.h"
+#include "core/Merger.h"
+
+static QString describeChange(const Merger::Change& change)
+{
+    switch (change.type) {
+    case Merger::EntryAdded:
+        return QObject::tr("Entry added: %1").arg(change.sourceEntry->title());
+    case Merger::EntryMoved:
+        return QObject::tr("Entry moved: %1").arg(change.sourceEntry->title());
+    case Merger::EntryUpdated:
+        return QObject::tr("Entry updated: %1").arg(change.sourceEntry->title());
+    case Merger::EntryDuplicated:
+        return QObject::tr("Entry duplicated: %1").arg(change.sourceEntry->title());
+    case Merger::GroupAdded:
+        return QObject::tr("Group added: %1").arg(change.sourceGroup->name());
+    case Merger::GroupMoved:
+        return QObject::tr("Group moved: %1").arg(change.sourceGroup->name());
+    case Merger::GroupUpdated:
+        return QObject::tr("Group updated: %1").arg(change.sourceGroup->name());
+    case Merger::CustomIconAdded:
+        return QObject::tr("Custom icon added: %1").arg(change.uuid.toHex());
+    }
+
+    return QString();
+}
+
+static void printStats(QTextStream& out, const Merger::ChangeSet& changeSet)
+{
+    out << QObject::tr("Entries added: %1").arg(changeSet.count(Merger::EntryAdded)) << "\n";
+    out << QObject::tr("Entries moved: %1").arg(changeSet.count(Merger::EntryMoved)) << "\n";
+    out << QObject::tr("Entries updated: %1").arg(changeSet.count(Merger::EntryUpdated)) << "\n";
+    out << QObject::tr("Entries duplicated: %1").arg(changeSet.count(Merger::EntryDuplicated)) << "\n";
+    out << QObject::tr("Groups added: %1").arg(changeSet.count(Merger::GroupAdded)) << "\n";
+    out << QObject::tr("Groups moved: %1").arg(changeSet.count(Merger::GroupMoved)) << "\n";
+    out << QObject::tr("Groups updated: %1").arg(changeSet.count(Merger::GroupUpdated)) << "\n";
+    out << QObject::tr("Custom icons added: %1").arg(changeSet.count(Merger::CustomIconAdded)) << "\n";
+    out << QObject::tr("Indexing time: %1 ms").arg(changeSet.indexTime / 1000000.0, 0, 'f', 3) << "\n";
+    out << QObject::tr("Planning time: %1 ms").arg(changeSet.planTime / 1000000.0, 0, 'f', 3) << "\n";
+    out << QObject::tr("Applying time: %1 ms").arg(changeSet.applyTime / 1000000.0, 0, 'f', 3) << "\n";
+}
 
 Merge::Merge()
 {
@@ -36,7 +78,7 @@ Merge::~Merge()
 
 int Merge::execute(const QStringList& arguments)
 {
-    QTextStream out(stdout);
+    QTextStream out(Utils::STDOUT);
 
     QCommandLineParser parser;
     parser.setApplicationDescription(this->description);
@@ -58,8 +100,17 @@ int Merge::execute(const QStringList& arguments)
                                    QObject::tr("path"));
     parser.addOption(keyFileFrom);
 
+    QCommandLineOption dryRunOption("dry-run",
+                                    QObject::tr("Only show the changes detected by the merge operation."));
+    parser.addOption(dryRunOption);
+    QCommandLineOption statsOption("stats",
+                                   QObject::tr("Show the number of changes and the time spent merging."));
+    parser.addOption(statsOption);
+
     parser.addOption(samePasswordOption);
-    parser.process(arguments);
+    if (!parseArguments(parser, arguments)) {
+        return EXIT_FAILURE;
+    }
 
     const QStringList args = parser.positionalArguments();
     if (args.size() != 2) {
@@ -67,14 +118,14 @@ int Merge::execute(const QStringList& arguments)
         return EXIT_FAILURE;
     }
 
-    Database* db1 = Database::unlockFromStdin(args.at(0), parser.value(keyFile));
+    Database* db1 = unlockDatabase(args.at(0), parser.value(keyFile));
     if (db1 == nullptr) {
         return EXIT_FAILURE;
     }
 
     Database* db2;
     if (!parser.isSet("same-credentials")) {
-        db2 = Database::unlockFromStdin(args.at(1), parser.value(keyFileFrom));
+        db2 = unlockDatabase(args.at(1), parser.value(keyFileFrom));
     } else {
         db2 = Database::openDatabaseFile(args.at(1), *(db1->key().clone()));
     }
@@ -82,14 +133,33 @@ int Merge::execute(const QStringList& arguments)
         return EXIT_FAILURE;
     }
 
-    db1->merge(db2);
+    Merger merger(db2, db1);
+    Merger::ChangeSet changeSet = merger.plan();
+
+    if (parser.isSet(dryRunOption)) {
+        for (const Merger::Change& change : asConst(changeSet.changes)) {
+            out << describeChange(change) << "\n";
+        }
+        if (parser.isSet(statsOption)) {
+            printStats(out, changeSet);
+        }
+        return EXIT_SUCCESS;
+    }
+
+    if (!merger.apply(changeSet)) {
+        qCritical("Unable to merge the database files.");
+        return EXIT_FAILURE;
+    }
 
-    QString errorMessage = db1->saveToFile(args.at(0));
+    QString errorMessage = saveDatabase(db1, args.at(0));
     if (!errorMessage.isEmpty()) {
         qCritical("Unable to save database to file : %s", qPrintable(errorMessage));
         return EXIT_FAILURE;
     }
 
+    if (parser.isSet(statsOption)) {
+        printStats(out, changeSet);
+    }
     out << "Successfully merged the database files.\n";
     return EXIT_SUCCESS;
 }
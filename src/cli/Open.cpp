@@ -0,0 +1,197 @@
+/*
+ *  Copyright (C) 2018 KeePassXC Team <team@keepassxc.org>
+ *
+ *  This program is free software: you can redistribute it and/or modify
+ *  it under the terms of the GNU General Public License as published by
+ *  the Free Software Foundation, either version 2 or (at your option)
+ *  version 3 of the License.
+ *
+ *  This program is distributed in the hope that it will be useful,
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *  GNU General Public License for more details.
+ *
+ *  You should have received a copy of the GNU General Public License
+ *  along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#include <cstdlib>
+#include <stdio.h>
+
+#include "Open.h"
+
+#include <QCommandLineParser>
+#include <QFile>
+#include <QTextStream>
+
+#include "cli/DatabaseSession.h"
+#include "cli/Utils.h"
+#include "core/Database.h"
+
+#ifdef Q_OS_WIN
+#include <io.h>
+#else
+#include <unistd.h>
+#endif
+
+namespace
+{
+    // commands that can run against the open database
+    const QStringList DatabaseCommands = {"add", "edit", "locate", "ls", "merge", "rm", "show"};
+
+    bool isInteractive()
+    {
+#ifdef Q_OS_WIN
+        return _isatty(_fileno(stdin));
+#else
+        return isatty(STDIN_FILENO);
+#endif
+    }
+} // namespace
+
+Open::Open()
+{
+    name = QString("open");
+    description = QObject::tr("Run several commands on a database unlocked once.");
+}
+
+Open::~Open()
+{
+}
+
+int Open::execute(const QStringList& arguments)
+{
+    QTextStream out(Utils::STDOUT);
+
+    QCommandLineParser parser;
+    parser.setApplicationDescription(this->description);
+    parser.addPositionalArgument("database", QObject::tr("Path of the database."));
+    parser.addPositionalArgument(
+        "script", QObject::tr("File to read the commands from. Default is the standard input."), QString("[script]"));
+    QCommandLineOption keyFile(QStringList() << "k"
+                                             << "key-file",
+                               QObject::tr("Key file of the database."),
+                               QObject::tr("path"));
+    parser.addOption(keyFile);
+    if (!parseArguments(parser, arguments)) {
+        return EXIT_FAILURE;
+    }
+
+    const QStringList args = parser.positionalArguments();
+    if (args.size() != 1 && args.size() != 2) {
+        out << parser.helpText().replace("keepassxc-cli", "keepassxc-cli open");
+        return EXIT_FAILURE;
+    }
+
+    QFile scriptFile(args.value(1));
+    if (args.size() == 2 && !scriptFile.open(QIODevice::ReadOnly)) {
+        qCritical("Unable to open file %s.", qPrintable(args.at(1)));
+        return EXIT_FAILURE;
+    }
+
+    Database* db = Database::unlockFromStdin(args.at(0), parser.value(keyFile));
+    if (db == nullptr) {
+        return EXIT_FAILURE;
+    }
+
+    DatabaseSession session(db, args.at(0));
+    DatabaseSession::setCurrent(&session);
+
+    int exitCode;
+    if (scriptFile.isOpen()) {
+        QTextStream scriptTextStream(&scriptFile);
+        exitCode = this->runCommands(&session, &scriptTextStream, false);
+    } else {
+        exitCode = this->runCommands(&session, nullptr, isInteractive());
+    }
+
+    // changes are only written at the end or by the save command
+    const QString errorMessage = session.save();
+    if (!errorMessage.isEmpty()) {
+        qCritical("Writing the database failed %s.", qPrintable(errorMessage));
+        exitCode = EXIT_FAILURE;
+    }
+
+    DatabaseSession::setCurrent(nullptr);
+    return exitCode;
+}
+
+/**
+ * Runs the commands read from scriptTextStream, or from stdin if it is null,
+ * until the end of the input or a quit command.
+ *
+ * @return EXIT_FAILURE if any of the commands failed
+ */
+int Open::runCommands(DatabaseSession* session, QTextStream* scriptTextStream, bool interactive)
+{
+    QTextStream out(Utils::STDOUT);
+
+    int exitCode = EXIT_SUCCESS;
+    while (true) {
+        if (interactive) {
+            out << "> ";
+            out.flush();
+        }
+
+        // stdin is read through Utils, which also reads the passwords
+        const QString line = scriptTextStream ? scriptTextStream->readLine() : Utils::readLine();
+        if (line.isNull()) {
+            break;
+        }
+
+        const QString command = line.trimmed();
+        if (command.isEmpty() || command.startsWith('#')) {
+            continue;
+        }
+
+        const QStringList words = Utils::splitCommandString(command);
+        if (words.first() == "quit" || words.first() == "exit") {
+            break;
+        }
+        if (this->runCommand(session, words) != EXIT_SUCCESS) {
+            exitCode = EXIT_FAILURE;
+        }
+    }
+
+    if (interactive) {
+        out << endl;
+    }
+    return exitCode;
+}
+
+int Open::runCommand(DatabaseSession* session, const QStringList& words)
+{
+    QTextStream out(Utils::STDOUT);
+
+    const QString commandName = words.first();
+    if (commandName == "help") {
+        out << QObject::tr("Available commands:") << "\n";
+        for (const QString& name : DatabaseCommands) {
+            out << getCommand(name)->getDescriptionLine();
+        }
+        out << QString("save").leftJustified(15) << QObject::tr("Write the changes to the database file.") << "\n";
+        out << QString("quit").leftJustified(15) << QObject::tr("Write the changes and exit.") << "\n";
+        out.flush();
+        return EXIT_SUCCESS;
+    }
+
+    if (commandName == "save") {
+        const QString errorMessage = session->save();
+        if (!errorMessage.isEmpty()) {
+            qCritical("Writing the database failed %s.", qPrintable(errorMessage));
+            return EXIT_FAILURE;
+        }
+        out << QObject::tr("Successfully saved the database.") << endl;
+        return EXIT_SUCCESS;
+    }
+
+    if (!DatabaseCommands.contains(commandName)) {
+        qCritical("Invalid command %s.", qPrintable(commandName));
+        return EXIT_FAILURE;
+    }
+
+    // the database is the first positional argument of all these commands
+    QStringList arguments = words;
+    arguments.insert(1, session->filePath());
+    return getCommand(commandName)->execute(arguments);
+}
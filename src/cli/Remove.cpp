@@ -42,9 +42,14 @@ Remove::~Remove()
 {
 }
 
+bool Remove::canRunInSession(const QStringList&)
+{
+    return true;
+}
+
 int Remove::execute(const QStringList& arguments)
 {
-    QTextStream outputTextStream(stdout, QIODevice::WriteOnly);
+    QTextStream outputTextStream(Utils::STDOUT);
 
     QCommandLineParser parser;
     parser.setApplicationDescription(QCoreApplication::translate("main", "Remove an entry from the database."));
@@ -55,7 +60,9 @@ int Remove::execute(const QStringList& arguments)
                                QObject::tr("path"));
     parser.addOption(keyFile);
     parser.addPositionalArgument("entry", QCoreApplication::translate("main", "Path of the entry to remove."));
-    parser.process(arguments);
+    if (!parseArguments(parser, arguments)) {
+        return EXIT_FAILURE;
+    }
 
     const QStringList args = parser.positionalArguments();
     if (args.size() != 2) {
@@ -63,7 +70,7 @@ int Remove::execute(const QStringList& arguments)
         return EXIT_FAILURE;
     }
 
-    Database* db = Database::unlockFromStdin(args.at(0), parser.value(keyFile));
+    Database* db = unlockDatabase(args.at(0), parser.value(keyFile));
     if (db == nullptr) {
         return EXIT_FAILURE;
     }
@@ -74,7 +81,7 @@ int Remove::execute(const QStringList& arguments)
 int Remove::removeEntry(Database* database, QString databasePath, QString entryPath)
 {
 
-    QTextStream outputTextStream(stdout, QIODevice::WriteOnly);
+    QTextStream outputTextStream(Utils::STDOUT);
     Entry* entry = database->rootGroup()->findEntryByPath(entryPath);
     if (!entry) {
         qCritical("Entry %s not found.", qPrintable(entryPath));
@@ -90,7 +97,7 @@ int Remove::removeEntry(Database* database, QString databasePath, QString entryP
         database->recycleEntry(entry);
     };
 
-    QString errorMessage = database->saveToFile(databasePath);
+    QString errorMessage = saveDatabase(database, databasePath);
     if (!errorMessage.isEmpty()) {
         qCritical("Unable to save database to file : %s", qPrintable(errorMessage));
         return EXIT_FAILURE;
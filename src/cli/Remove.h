@@ -28,6 +28,7 @@ public:
     Remove();
     ~Remove();
     int execute(const QStringList& arguments);
+    bool canRunInSession(const QStringList& arguments);
     int removeEntry(Database* database, QString databasePath, QString entryPath);
 };
 
@@ -0,0 +1,146 @@
+/*
+ *  Copyright (C) 2018 KeePassXC Team <team@keepassxc.org>
+ *
+ *  This program is free software: you can redistribute it and/or modify
+ *  it under the terms of the GNU General Public License as published by
+ *  the Free Software Foundation, either version 2 or (at your option)
+ *  version 3 of the License.
+ *
+ *  This program is distributed in the hope that it will be useful,
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *  GNU General Public License for more details.
+ *
+ *  You should have received a copy of the GNU General Public License
+ *  along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#include <climits>
+#include <cstdlib>
+#include <stdio.h>
+
+#include "Session.h"
+
+#include <QCommandLineParser>
+#include <QCoreApplication>
+#include <QTextStream>
+
+#include "cli/DatabaseSession.h"
+#include "cli/SessionServer.h"
+#include "cli/Utils.h"
+#include "core/Database.h"
+
+Session::Session()
+{
+    name = QString("session");
+    description = QObject::tr("Keep a database unlocked for other commands.");
+}
+
+Session::~Session()
+{
+}
+
+int Session::execute(const QStringList& arguments)
+{
+    QTextStream out(Utils::STDOUT);
+
+    QCommandLineParser parser;
+    parser.setApplicationDescription(this->description);
+    parser.addPositionalArgument("action",
+                                 QObject::tr("start: unlock the database and serve commands until stopped, "
+                                             "save: write pending changes, "
+                                             "stop: write pending changes and end the session."),
+                                 QString("start|save|stop"));
+    parser.addPositionalArgument("database", QObject::tr("Path of the database."));
+    QCommandLineOption keyFile(QStringList() << "k"
+                                             << "key-file",
+                               QObject::tr("Key file of the database."),
+                               QObject::tr("path"));
+    parser.addOption(keyFile);
+    QCommandLineOption idleTimeout(QStringList() << "idle-timeout",
+                                   QObject::tr("End the session after this many seconds without a command. "
+                                               "Default is 600."),
+                                   QObject::tr("seconds"),
+                                   QString("600"));
+    parser.addOption(idleTimeout);
+    QCommandLineOption saveInterval(QStringList() << "save-interval",
+                                    QObject::tr("Write changes at most every this many seconds, "
+                                                "0 writes after every command. Default is 10."),
+                                    QObject::tr("seconds"),
+                                    QString("10"));
+    parser.addOption(saveInterval);
+    if (!parseArguments(parser, arguments)) {
+        return EXIT_FAILURE;
+    }
+
+    const QStringList args = parser.positionalArguments();
+    if (args.size() != 2) {
+        out << parser.helpText().replace("keepassxc-cli", "keepassxc-cli session");
+        return EXIT_FAILURE;
+    }
+
+    const QString action = args.at(0);
+    const QString databasePath = args.at(1);
+    if (action == "start") {
+        bool idleTimeoutOk;
+        bool saveIntervalOk;
+        const int idleTimeoutSeconds = parser.value(idleTimeout).toInt(&idleTimeoutOk);
+        const int saveIntervalSeconds = parser.value(saveInterval).toInt(&saveIntervalOk);
+        // the timers take milliseconds
+        if (!idleTimeoutOk || idleTimeoutSeconds <= 0 || idleTimeoutSeconds > INT_MAX / 1000) {
+            qCritical("Invalid value for the idle timeout %s.", qPrintable(parser.value(idleTimeout)));
+            return EXIT_FAILURE;
+        }
+        if (!saveIntervalOk || saveIntervalSeconds < 0 || saveIntervalSeconds > INT_MAX / 1000) {
+            qCritical("Invalid value for the save interval %s.", qPrintable(parser.value(saveInterval)));
+            return EXIT_FAILURE;
+        }
+        return this->startSession(databasePath, parser.value(keyFile), idleTimeoutSeconds, saveIntervalSeconds);
+    }
+
+    if (action != "save" && action != "stop") {
+        qCritical("Invalid session action %s.", qPrintable(action));
+        return EXIT_FAILURE;
+    }
+
+    int exitCode;
+    QByteArray output;
+    QByteArray errors;
+    const QString canonicalPath = DatabaseSession::canonicalPath(databasePath);
+    if (!SessionServer::sendRequest(
+            canonicalPath, QStringList() << name << action << canonicalPath, exitCode, output, errors)) {
+        qCritical("No session is running for %s.", qPrintable(databasePath));
+        return EXIT_FAILURE;
+    }
+
+    Utils::STDOUT->write(output);
+    Utils::STDERR->write(errors);
+    return exitCode;
+}
+
+int Session::startSession(const QString& databasePath, const QString& keyFilePath, int idleTimeout, int saveInterval)
+{
+    QTextStream out(Utils::STDOUT);
+
+    if (SessionServer::isRunning(databasePath)) {
+        qCritical("A session is already running for %s.", qPrintable(databasePath));
+        return EXIT_FAILURE;
+    }
+
+    Database* db = Database::unlockFromStdin(databasePath, keyFilePath);
+    if (db == nullptr) {
+        return EXIT_FAILURE;
+    }
+
+    DatabaseSession session(db, databasePath);
+    SessionServer server(&session, idleTimeout * 1000, saveInterval * 1000);
+    if (!server.listen()) {
+        qCritical("Unable to start the session: %s", qPrintable(server.errorString()));
+        return EXIT_FAILURE;
+    }
+
+    DatabaseSession::setCurrent(&session);
+    out << QObject::tr("Session started for %1.").arg(session.filePath()) << endl;
+
+    return QCoreApplication::exec();
+}
@@ -0,0 +1,414 @@
+/*
+ *  Copyright (C) 2018 KeePassXC Team <team@keepassxc.org>
+ *
+ *  This program is free software: you can redistribute it and/or modify
+ *  it under the terms of the GNU General Public License as published by
+ *  the Free Software Foundation, either version 2 or (at your option)
+ *  version 3 of the License.
+ *
+ *  This program is distributed in the hope that it will be useful,
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *  GNU General Public License for more details.
+ *
+ *  You should have received a copy of the GNU General Public License
+ *  along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#include "SessionServer.h"
+
+#include <cstdlib>
+
+#include <QBuffer>
+#include <QCoreApplication>
+#include <QDataStream>
+#include <QFileInfo>
+#include <QLocalSocket>
+#include <QSocketNotifier>
+#include <QTextStream>
+#include <QVector>
+
+#include "cli/Command.h"
+#include "cli/DatabaseSession.h"
+#include "cli/Utils.h"
+
+#if defined(Q_OS_UNIX)
+#include <signal.h>
+#include <sys/socket.h>
+#include <unistd.h>
+#endif
+
+namespace
+{
+    constexpr int WaitTimeoutMSec = 1000;
+    constexpr quint32 MaxBlockSize = 64 * 1024 * 1024;
+
+    void writeBlock(QLocalSocket* socket, const QByteArray& payload)
+    {
+        QByteArray data;
+        QDataStream out(&data, QIODevice::WriteOnly);
+        out.setVersion(QDataStream::Qt_5_0);
+        out << quint32(payload.size());
+        data.append(payload);
+        socket->write(data);
+    }
+
+    /**
+     * Reads the next block from socket once it was received completely.
+     * A block is a quint32 size followed by size bytes of payload.
+     */
+    bool readBlock(QLocalSocket* socket, QByteArray& payload)
+    {
+        // Relies on the fact that QDataStream format streams a quint32 into sizeof(quint32) bytes
+        if (socket->bytesAvailable() < qint64(sizeof(quint32))) {
+            return false;
+        }
+
+        QDataStream in(socket->peek(sizeof(quint32)));
+        in.setVersion(QDataStream::Qt_5_0);
+        quint32 blockSize;
+        in >> blockSize;
+        if (blockSize > MaxBlockSize) {
+            socket->abort();
+            return false;
+        }
+        if (socket->bytesAvailable() < qint64(sizeof(quint32) + blockSize)) {
+            return false;
+        }
+
+        socket->read(sizeof(quint32));
+        payload = socket->read(blockSize);
+        return true;
+    }
+
+    void writeMessage(QtMsgType type, const QMessageLogContext& context, const QString& message)
+    {
+        Q_UNUSED(type);
+        Q_UNUSED(context);
+        QTextStream errorTextStream(Utils::STDERR);
+        errorTextStream << message << endl;
+    }
+} // namespace
+
+SessionServer::SessionServer(DatabaseSession* session, int idleTimeout, int saveInterval, QObject* parent)
+    : QObject(parent)
+    , m_session(session)
+    , m_saveInterval(saveInterval)
+    , m_stopRequested(false)
+    , m_unixSignalNotifier(nullptr)
+{
+    m_server.setSocketOptions(QLocalServer::UserAccessOption);
+    connect(&m_server, SIGNAL(newConnection()), this, SLOT(newConnection()));
+
+    m_idleTimer.setSingleShot(true);
+    m_idleTimer.setInterval(idleTimeout);
+    connect(&m_idleTimer, SIGNAL(timeout()), this, SLOT(stop()));
+
+    m_saveTimer.setSingleShot(true);
+    m_saveTimer.setInterval(saveInterval);
+    connect(&m_saveTimer, SIGNAL(timeout()), this, SLOT(saveDatabase()));
+
+#if defined(Q_OS_UNIX)
+    registerUnixSignals();
+#endif
+}
+
+SessionServer::~SessionServer()
+{
+    m_server.close();
+}
+
+bool SessionServer::listen()
+{
+    const QString socketName = DatabaseSession::socketName(m_session->filePath());
+    if (!m_server.listen(socketName)) {
+        // a session that crashed leaves its socket behind
+        if (isRunning(m_session->filePath())) {
+            return false;
+        }
+        QLocalServer::removeServer(socketName);
+        if (!m_server.listen(socketName)) {
+            return false;
+        }
+    }
+
+    m_idleTimer.start();
+    return true;
+}
+
+QString SessionServer::errorString() const
+{
+    return m_server.errorString();
+}
+
+bool SessionServer::isRunning(const QString& databasePath)
+{
+    QLocalSocket socket;
+    socket.connectToServer(DatabaseSession::socketName(databasePath));
+    return socket.waitForConnected(WaitTimeoutMSec);
+}
+
+bool SessionServer::canForward(const QStringList& arguments)
+{
+    Command* command = Command::getCommand(arguments.value(0));
+    return command && command->canRunInSession(arguments);
+}
+
+bool SessionServer::forwardCommand(const QStringList& arguments, int& exitCode)
+{
+    if (!canForward(arguments)) {
+        return false;
+    }
+
+    // The database is the first argument naming a file that a session
+    // serves; the session gets its canonical path, as the working
+    // directory of the session may differ.
+    for (int i = 1; i < arguments.size(); ++i) {
+        if (!QFileInfo(arguments.at(i)).isFile()) {
+            continue;
+        }
+
+        const QString databasePath = DatabaseSession::canonicalPath(arguments.at(i));
+        QStringList sessionArguments = arguments;
+        sessionArguments[i] = databasePath;
+
+        QByteArray output;
+        QByteArray errors;
+        if (sendRequest(databasePath, sessionArguments, exitCode, output, errors)) {
+            Utils::STDOUT->write(output);
+            Utils::STDERR->write(errors);
+            return true;
+        }
+    }
+
+    return false;
+}
+
+bool SessionServer::sendRequest(const QString& databasePath,
+                                const QStringList& arguments,
+                                int& exitCode,
+                                QByteArray& output,
+                                QByteArray& errors)
+{
+    QLocalSocket socket;
+    socket.connectToServer(DatabaseSession::socketName(databasePath));
+    if (!socket.waitForConnected(WaitTimeoutMSec)) {
+        return false;
+    }
+
+    QByteArray request;
+    QDataStream out(&request, QIODevice::WriteOnly);
+    out.setVersion(QDataStream::Qt_5_0);
+    out << arguments;
+    writeBlock(&socket, request);
+
+    // The command may already have run, so it must not be run again
+    // locally if the session goes away before replying.
+    QByteArray reply;
+    while (!readBlock(&socket, reply)) {
+        if (!socket.waitForReadyRead(-1)) {
+            exitCode = EXIT_FAILURE;
+            errors = QObject::tr("Lost the connection to the session of %1.").arg(databasePath).toUtf8() + "\n";
+            return true;
+        }
+    }
+
+    qint32 replyExitCode;
+    QDataStream in(reply);
+    in.setVersion(QDataStream::Qt_5_0);
+    in >> replyExitCode >> output >> errors;
+    exitCode = replyExitCode;
+    return true;
+}
+
+void SessionServer::newConnection()
+{
+    while (QLocalSocket* socket = m_server.nextPendingConnection()) {
+        connect(socket, SIGNAL(readyRead()), this, SLOT(readRequest()));
+        connect(socket, SIGNAL(disconnected()), socket, SLOT(deleteLater()));
+    }
+}
+
+void SessionServer::readRequest()
+{
+    QLocalSocket* socket = qobject_cast<QLocalSocket*>(sender());
+    QByteArray request;
+    if (!socket || !readBlock(socket, request)) {
+        return;
+    }
+
+    QStringList arguments;
+    QDataStream in(request);
+    in.setVersion(QDataStream::Qt_5_0);
+    in >> arguments;
+
+    m_idleTimer.start();
+
+    QByteArray output;
+    QByteArray errors;
+    int exitCode;
+    if (arguments.value(0) == "session") {
+        exitCode = runSessionAction(arguments, output, errors);
+    } else {
+        exitCode = runCommand(arguments, output, errors);
+    }
+
+    QByteArray reply;
+    QDataStream out(&reply, QIODevice::WriteOnly);
+    out.setVersion(QDataStream::Qt_5_0);
+    out << qint32(exitCode) << output << errors;
+    writeBlock(socket, reply);
+    socket->flush();
+
+    if (m_stopRequested) {
+        socket->waitForBytesWritten(WaitTimeoutMSec);
+        QCoreApplication::quit();
+    }
+}
+
+int SessionServer::runCommand(const QStringList& arguments, QByteArray& output, QByteArray& errors)
+{
+    Command* command = Command::getCommand(arguments.value(0));
+    if (!command || !canForward(arguments)) {
+        errors = QObject::tr("The command %1 can't run in a session.").arg(arguments.value(0)).toUtf8() + "\n";
+        return EXIT_FAILURE;
+    }
+    if (!arguments.contains(m_session->filePath())) {
+        errors = QObject::tr("This session only serves %1.").arg(m_session->filePath()).toUtf8() + "\n";
+        return EXIT_FAILURE;
+    }
+
+    // collect everything the command prints for the client
+    QBuffer outputBuffer(&output);
+    QBuffer errorBuffer(&errors);
+    outputBuffer.open(QIODevice::WriteOnly);
+    errorBuffer.open(QIODevice::WriteOnly);
+    QIODevice* stdoutDevice = Utils::STDOUT;
+    QIODevice* stderrDevice = Utils::STDERR;
+    Utils::STDOUT = &outputBuffer;
+    Utils::STDERR = &errorBuffer;
+    const QtMessageHandler messageHandler = qInstallMessageHandler(writeMessage);
+
+    const int exitCode = command->execute(arguments);
+
+    qInstallMessageHandler(messageHandler);
+    Utils::STDOUT = stdoutDevice;
+    Utils::STDERR = stderrDevice;
+    outputBuffer.close();
+    errorBuffer.close();
+
+    if (m_session->isModified()) {
+        if (m_saveInterval == 0) {
+            saveOrWarn(errors);
+        } else if (!m_saveTimer.isActive()) {
+            m_saveTimer.start();
+        }
+    }
+
+    return exitCode;
+}
+
+int SessionServer::runSessionAction(const QStringList& arguments, QByteArray& output, QByteArray& errors)
+{
+    const QString action = arguments.value(1);
+    if (action == "save") {
+        if (!saveOrWarn(errors)) {
+            return EXIT_FAILURE;
+        }
+        output = QObject::tr("Successfully saved the database.").toUtf8() + "\n";
+        return EXIT_SUCCESS;
+    } else if (action == "stop") {
+        if (!saveOrWarn(errors)) {
+            return EXIT_FAILURE;
+        }
+        m_stopRequested = true;
+        output = QObject::tr("Session stopped.").toUtf8() + "\n";
+        return EXIT_SUCCESS;
+    }
+
+    errors = QObject::tr("Invalid session action %1.").arg(action).toUtf8() + "\n";
+    return EXIT_FAILURE;
+}
+
+bool SessionServer::saveOrWarn(QByteArray& errors)
+{
+    m_saveTimer.stop();
+    const QString errorMessage = m_session->save();
+    if (errorMessage.isEmpty()) {
+        return true;
+    }
+
+    errors.append(QObject::tr("Writing the database failed %1.").arg(errorMessage).toUtf8() + "\n");
+    return false;
+}
+
+void SessionServer::saveDatabase()
+{
+    QByteArray errors;
+    if (!saveOrWarn(errors)) {
+        qWarning("%s", errors.trimmed().constData());
+        m_saveTimer.start();
+    }
+}
+
+void SessionServer::stop()
+{
+    QByteArray errors;
+    if (!saveOrWarn(errors)) {
+        // keep the unsaved changes in memory and try again later
+        qWarning("%s", errors.trimmed().constData());
+        m_idleTimer.start();
+        return;
+    }
+
+    QCoreApplication::quit();
+}
+
+#if defined(Q_OS_UNIX)
+int SessionServer::unixSignalSocket[2];
+
+void SessionServer::registerUnixSignals()
+{
+    if (::socketpair(AF_UNIX, SOCK_STREAM, 0, unixSignalSocket) != 0) {
+        return;
+    }
+
+    // SIGHUP is ignored, the session keeps running when its terminal is closed
+    const QVector<int> handledSignals = {SIGQUIT, SIGINT, SIGTERM, SIGHUP};
+    for (auto s : handledSignals) {
+        struct sigaction sigAction;
+
+        sigAction.sa_handler = handleUnixSignal;
+        sigemptyset(&sigAction.sa_mask);
+        sigAction.sa_flags = 0 | SA_RESTART;
+        sigaction(s, &sigAction, nullptr);
+    }
+
+    m_unixSignalNotifier = new QSocketNotifier(unixSignalSocket[1], QSocketNotifier::Read, this);
+    connect(m_unixSignalNotifier, SIGNAL(activated(int)), this, SLOT(quitBySignal()));
+}
+
+void SessionServer::handleUnixSignal(int sig)
+{
+    if (sig != SIGHUP) {
+        char buf = 0;
+        Q_UNUSED(::write(unixSignalSocket[0], &buf, sizeof(buf)));
+    }
+}
+
+void SessionServer::quitBySignal()
+{
+    char buf;
+    Q_UNUSED(::read(unixSignalSocket[1], &buf, sizeof(buf)));
+
+    // unlike the idle timeout, a signal ends the session even if the changes can't be written
+    QByteArray errors;
+    if (!saveOrWarn(errors)) {
+        qWarning("%s", errors.trimmed().constData());
+        QCoreApplication::exit(EXIT_FAILURE);
+        return;
+    }
+
+    QCoreApplication::quit();
+}
+#endif
@@ -0,0 +1,105 @@
+/*
+ *  Copyright (C) 2018 KeePassXC Team <team@keepassxc.org>
+ *
+ *  This program is free software: you can redistribute it and/or modify
+ *  it under the terms of the GNU General Public License as published by
+ *  the Free Software Foundation, either version 2 or (at your option)
+ *  version 3 of the License.
+ *
+ *  This program is distributed in the hope that it will be useful,
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *  GNU General Public License for more details.
+ *
+ *  You should have received a copy of the GNU General Public License
+ *  along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#ifndef KEEPASSXC_SESSIONSERVER_H
+#define KEEPASSXC_SESSIONSERVER_H
+
+#include <QByteArray>
+#include <QLocalServer>
+#include <QObject>
+#include <QStringList>
+#include <QTimer>
+
+class DatabaseSession;
+class QLocalSocket;
+class QSocketNotifier;
+
+/**
+ * Serves the commands of other keepassxc-cli processes from an unlocked
+ * database, so that they don't have to derive the key again.
+ *
+ * The server listens on a local socket that only the current user can
+ * connect to. A request is the argument list of a command, the reply
+ * carries its exit code and what it printed. Changes are written every
+ * saveInterval milliseconds (immediately for 0), when the session is
+ * stopped, and when no request came in for idleTimeout milliseconds,
+ * which also ends the session.
+ */
+class SessionServer : public QObject
+{
+    Q_OBJECT
+
+public:
+    SessionServer(DatabaseSession* session, int idleTimeout, int saveInterval, QObject* parent = nullptr);
+    ~SessionServer();
+
+    bool listen();
+    QString errorString() const;
+
+    static bool isRunning(const QString& databasePath);
+    /**
+     * Whether a command with these arguments can run in a session. Commands
+     * that need the terminal or the clipboard always run locally.
+     */
+    static bool canForward(const QStringList& arguments);
+    /**
+     * Runs the command in a session if one is serving the database it is
+     * about. The output of the command is printed as if it ran locally.
+     *
+     * @return false if there is no session for the database
+     */
+    static bool forwardCommand(const QStringList& arguments, int& exitCode);
+    /**
+     * Sends arguments to the session of databasePath and waits for the reply.
+     *
+     * @return false if no session is serving databasePath
+     */
+    static bool sendRequest(const QString& databasePath,
+                            const QStringList& arguments,
+                            int& exitCode,
+                            QByteArray& output,
+                            QByteArray& errors);
+
+private slots:
+    void newConnection();
+    void readRequest();
+    void saveDatabase();
+    void stop();
+#if defined(Q_OS_UNIX)
+    void quitBySignal();
+#endif
+
+private:
+    int runCommand(const QStringList& arguments, QByteArray& output, QByteArray& errors);
+    int runSessionAction(const QStringList& arguments, QByteArray& output, QByteArray& errors);
+    bool saveOrWarn(QByteArray& errors);
+#if defined(Q_OS_UNIX)
+    void registerUnixSignals();
+    static void handleUnixSignal(int sig);
+    static int unixSignalSocket[2];
+#endif
+
+    DatabaseSession* const m_session;
+    QLocalServer m_server;
+    QTimer m_idleTimer;
+    QTimer m_saveTimer;
+    const int m_saveInterval;
+    bool m_stopRequested;
+    QSocketNotifier* m_unixSignalNotifier;
+};
+
+#endif // KEEPASSXC_SESSIONSERVER_H
@@ -23,8 +23,11 @@
 #include <QCommandLineParser>
 #include <QTextStream>
 
+#include "cli/EntryJsonWriter.h"
+#include "cli/Utils.h"
 #include "core/Database.h"
 #include "core/Entry.h"
+#include "core/Global.h"
 #include "core/Group.h"
 
 Show::Show()
@@ -37,9 +40,14 @@ Show::~Show()
 {
 }
 
+bool Show::canRunInSession(const QStringList&)
+{
+    return true;
+}
+
 int Show::execute(const QStringList& arguments)
 {
-    QTextStream out(stdout);
+    QTextStream out(Utils::STDOUT);
 
     QCommandLineParser parser;
     parser.setApplicationDescription(this->description);
@@ -58,8 +66,17 @@ int Show::execute(const QStringList& arguments)
             "If no attributes are specified, a summary of the default attributes is given."),
         QObject::tr("attribute"));
     parser.addOption(attributes);
+    QCommandLineOption format("format",
+                              QObject::tr("Output format: text, json or ndjson. Default is text."),
+                              QObject::tr("format"),
+                              QString("text"));
+    parser.addOption(format);
+    QCommandLineOption resolve("resolve", QObject::tr("Resolve placeholders and references in json and ndjson format."));
+    parser.addOption(resolve);
     parser.addPositionalArgument("entry", QObject::tr("Name of the entry to show."));
-    parser.process(arguments);
+    if (!parseArguments(parser, arguments)) {
+        return EXIT_FAILURE;
+    }
 
     const QStringList args = parser.positionalArguments();
     if (args.size() != 2) {
@@ -67,11 +84,20 @@ int Show::execute(const QStringList& arguments)
         return EXIT_FAILURE;
     }
 
-    Database* db = Database::unlockFromStdin(args.at(0), parser.value(keyFile));
+    const EntryJsonWriter::OutputFormat outputFormat = EntryJsonWriter::formatFromName(parser.value(format));
+    if (outputFormat == EntryJsonWriter::InvalidFormat) {
+        qCritical("Unknown output format %s.", qPrintable(parser.value(format)));
+        return EXIT_FAILURE;
+    }
+
+    Database* db = unlockDatabase(args.at(0), parser.value(keyFile));
     if (db == nullptr) {
         return EXIT_FAILURE;
     }
 
+    if (outputFormat != EntryJsonWriter::TextFormat) {
+        return this->showEntryJson(db, parser.values(attributes), args.at(1), parser.isSet(resolve));
+    }
     return this->showEntry(db, parser.values(attributes), args.at(1));
 }
 
@@ -79,7 +105,7 @@ int Show::showEntry(Database* database, QStringList attributes, QString entryPat
 {
 
     QTextStream inputTextStream(stdin, QIODevice::ReadOnly);
-    QTextStream outputTextStream(stdout, QIODevice::WriteOnly);
+    QTextStream outputTextStream(Utils::STDOUT);
 
     Entry* entry = database->rootGroup()->findEntry(entryPath);
     if (!entry) {
@@ -108,3 +134,34 @@ int Show::showEntry(Database* database, QStringList attributes, QString entryPat
     }
     return sawUnknownAttribute ? EXIT_FAILURE : EXIT_SUCCESS;
 }
+
+/**
+ * Writes the entry as a single JSON object on one line, which is the same
+ * in json and ndjson format.
+ */
+int Show::showEntryJson(Database* database, QStringList attributes, QString entryPath, bool resolve)
+{
+    Entry* entry = database->rootGroup()->findEntry(entryPath);
+    if (!entry) {
+        qCritical("Could not find entry with path %s.", qPrintable(entryPath));
+        return EXIT_FAILURE;
+    }
+
+    if (attributes.isEmpty()) {
+        attributes = QStringList() << "uuid"
+                                   << "path" << EntryAttributes::DefaultAttributes;
+    }
+
+    // unknown attributes are written as null
+    bool sawUnknownAttribute = false;
+    for (const QString& attribute : asConst(attributes)) {
+        if (!EntryJsonWriter::SpecialFields.contains(attribute) && !entry->attributes()->contains(attribute)) {
+            sawUnknownAttribute = true;
+            qCritical("ERROR: unknown attribute '%s'.", qPrintable(attribute));
+        }
+    }
+
+    EntryJsonWriter writer(Utils::STDOUT, EntryJsonWriter::NdjsonFormat, attributes, resolve);
+    writer.writeEntry(entry);
+    return sawUnknownAttribute ? EXIT_FAILURE : EXIT_SUCCESS;
+}
@@ -26,7 +26,9 @@ public:
     Show();
     ~Show();
     int execute(const QStringList& arguments);
+    bool canRunInSession(const QStringList& arguments);
     int showEntry(Database* database, QStringList attributes, QString entryPath);
+    int showEntryJson(Database* database, QStringList attributes, QString entryPath, bool resolve);
 };
 
 #endif // KEEPASSXC_SHOW_H
@@ -24,9 +24,34 @@
 #include <unistd.h>
 #endif
 
+#include <QFile>
 #include <QProcess>
+#include <QStringList>
 #include <QTextStream>
 
+namespace
+{
+    /**
+     * Shared by getPassword() and readLine(), as QTextStream reads ahead.
+     */
+    QTextStream& inputTextStream()
+    {
+        static QTextStream inputTextStream(stdin, QIODevice::ReadOnly);
+        return inputTextStream;
+    }
+
+    QIODevice* openStream(FILE* stream)
+    {
+        QFile* file = new QFile();
+        // unbuffered, the C library buffers and flushes the stream on exit
+        file->open(stream, QIODevice::WriteOnly | QIODevice::Unbuffered);
+        return file;
+    }
+} // namespace
+
+QIODevice* Utils::STDOUT = openStream(stdout);
+QIODevice* Utils::STDERR = openStream(stderr);
+
 void Utils::setStdinEcho(bool enable = true)
 {
 #ifdef Q_OS_WIN
@@ -58,11 +83,10 @@ void Utils::setStdinEcho(bool enable = true)
 
 QString Utils::getPassword()
 {
-    static QTextStream inputTextStream(stdin, QIODevice::ReadOnly);
     static QTextStream outputTextStream(stdout, QIODevice::WriteOnly);
 
     setStdinEcho(false);
-    QString line = inputTextStream.readLine();
+    QString line = inputTextStream().readLine();
     setStdinEcho(true);
 
     // The new line was also not echoed, but we do want to echo it.
@@ -72,6 +96,46 @@ QString Utils::getPassword()
     return line;
 }
 
+QString Utils::readLine()
+{
+    return inputTextStream().readLine();
+}
+
+QStringList Utils::splitCommandString(const QString& command)
+{
+    QStringList result;
+    QString word;
+    bool hasWord = false;
+    QChar quote;
+    for (int i = 0; i < command.size(); ++i) {
+        const QChar c = command.at(i);
+        if (quote.isNull() && c.isSpace()) {
+            if (hasWord) {
+                result << word;
+                word.clear();
+                hasWord = false;
+            }
+            continue;
+        }
+
+        hasWord = true;
+        if (c == '\\' && quote != '\'' && i + 1 < command.size()) {
+            word.append(command.at(++i));
+        } else if (quote.isNull() && (c == '"' || c == '\'')) {
+            quote = c;
+        } else if (!quote.isNull() && c == quote) {
+            quote = QChar();
+        } else {
+            word.append(c);
+        }
+    }
+
+    if (hasWord) {
+        result << word;
+    }
+    return result;
+}
+
 /*
  * A valid and running event loop is needed to use the global QClipboard,
  * so we need to use this from the CLI.
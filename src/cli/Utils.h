@@ -18,13 +18,33 @@
 #ifndef KEEPASSXC_UTILS_H
 #define KEEPASSXC_UTILS_H
 
+#include <QStringList>
 #include <QtCore/qglobal.h>
 
+class QIODevice;
+
 class Utils
 {
 public:
+    /**
+     * Streams the commands write their output to. They are stdout and
+     * stderr, unless a session redirects them to collect the output of
+     * a command it runs for a client.
+     */
+    static QIODevice* STDOUT;
+    static QIODevice* STDERR;
+
     static void setStdinEcho(bool enable);
     static QString getPassword();
+    /**
+     * Reads a line from stdin, returns a null string at the end of the input.
+     */
+    static QString readLine();
+    /**
+     * Splits a command line into arguments like a shell does for quotes
+     * and backslashes, without any expansion.
+     */
+    static QStringList splitCommandString(const QString& command);
     static int clipText(const QString& text);
 };
 
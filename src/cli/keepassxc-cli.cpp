@@ -23,6 +23,7 @@
 #include <QTextStream>
 
 #include <cli/Command.h>
+#include <cli/SessionServer.h>
 
 #include "config-keepassx.h"
 #include "core/Tools.h"
@@ -32,17 +33,42 @@
 #include <sanitizer/lsan_interface.h>
 #endif
 
+namespace
+{
+    /**
+     * Lists all commands in the help text. Only done when the help is
+     * shown, it constructs every command.
+     */
+    void setHelpDescription(QCommandLineParser& parser)
+    {
+        QString description("KeePassXC command line interface.");
+        description = description.append(QObject::tr("\n\nAvailable commands:\n"));
+        for (Command* command : Command::getCommands()) {
+            description = description.append(command->getDescriptionLine());
+        }
+        parser.setApplicationDescription(description);
+    }
+
+    bool initCrypto(Command::CryptoUsage usage)
+    {
+        switch (usage) {
+        case Command::NoCrypto:
+            return true;
+        case Command::CryptoBackend:
+            return Crypto::initBackend();
+        case Command::CryptoSelfTested:
+            return Crypto::init();
+        }
+        return false;
+    }
+} // namespace
+
 int main(int argc, char** argv)
 {
 #ifdef QT_NO_DEBUG
     Tools::disableCoreDumps();
 #endif
 
-    if (!Crypto::init()) {
-        qFatal("Fatal error while testing the cryptographic functions:\n%s", qPrintable(Crypto::errorString()));
-        return EXIT_FAILURE;
-    }
-
     QCoreApplication app(argc, argv);
     app.setApplicationVersion(KEEPASSX_VERSION);
 
@@ -53,13 +79,6 @@ int main(int argc, char** argv)
     }
     QCommandLineParser parser;
 
-    QString description("KeePassXC command line interface.");
-    description = description.append(QObject::tr("\n\nAvailable commands:\n"));
-    for (Command* command : Command::getCommands()) {
-        description = description.append(command->getDescriptionLine());
-    }
-    parser.setApplicationDescription(description);
-
     parser.addPositionalArgument("command", QObject::tr("Name of the command to execute."));
 
     parser.addHelpOption();
@@ -75,6 +94,7 @@ int main(int argc, char** argv)
             out << KEEPASSX_VERSION << endl;
             return EXIT_SUCCESS;
         }
+        setHelpDescription(parser);
         parser.showHelp();
     }
 
@@ -85,12 +105,21 @@ int main(int argc, char** argv)
         qCritical("Invalid command %s.", qPrintable(commandName));
         // showHelp exits the application immediately, so we need to set the
         // exit code here.
+        setHelpDescription(parser);
         parser.showHelp(EXIT_FAILURE);
     }
 
     // Removing the first argument (keepassxc).
     arguments.removeFirst();
-    int exitCode = command->execute(arguments);
+    int exitCode;
+    // a running session does the cryptography for forwarded commands
+    if (!SessionServer::forwardCommand(arguments, exitCode)) {
+        if (!initCrypto(command->cryptoUsage)) {
+            qFatal("Fatal error while testing the cryptographic functions:\n%s", qPrintable(Crypto::errorString()));
+            return EXIT_FAILURE;
+        }
+        exitCode = command->execute(arguments);
+    }
 
 #if defined(WITH_ASAN) && defined(WITH_LSAN)
     // do leak check here to prevent massive tail of end-of-process leak errors from third-party libraries
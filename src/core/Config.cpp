@@ -20,6 +20,7 @@
 
 #include <QCoreApplication>
 #include <QDir>
+#include <QMutexLocker>
 #include <QSettings>
 #include <QStandardPaths>
 #include <QTemporaryFile>
@@ -28,26 +29,31 @@ Config* Config::m_instance(nullptr);
 
 QVariant Config::get(const QString& key)
 {
+    QMutexLocker locker(&m_mutex);
     return m_settings->value(key, m_defaults.value(key));
 }
 
 QVariant Config::get(const QString& key, const QVariant& defaultValue)
 {
+    QMutexLocker locker(&m_mutex);
     return m_settings->value(key, defaultValue);
 }
 
 bool Config::hasAccessError()
 {
+    QMutexLocker locker(&m_mutex);
     return m_settings->status() & QSettings::AccessError;
 }
 
 QString Config::getFileName()
 {
+    QMutexLocker locker(&m_mutex);
     return m_settings->fileName();
 }
 
 void Config::set(const QString& key, const QVariant& value)
 {
+    QMutexLocker locker(&m_mutex);
     m_settings->setValue(key, value);
 }
 
@@ -60,6 +66,7 @@ void Config::set(const QString& key, const QVariant& value)
  */
 void Config::sync()
 {
+    QMutexLocker locker(&m_mutex);
     m_settings->sync();
 }
 
@@ -19,6 +19,7 @@
 #ifndef KEEPASSX_CONFIG_H
 #define KEEPASSX_CONFIG_H
 
+#include <QMutex>
 #include <QScopedPointer>
 #include <QVariant>
 
@@ -50,6 +51,8 @@ private:
 
     static Config* m_instance;
 
+    // settings are read by browser requests on worker threads
+    QMutex m_mutex;
     QScopedPointer<QSettings> m_settings;
     QHash<QString, QVariant> m_defaults;
 };
@@ -60,7 +60,7 @@ bool CsvParser::reparse()
     return parseFile();
 }
 
-bool CsvParser::parse(QFile* device)
+bool CsvParser::parse(QIODevice* device)
 {
     clear();
     if (nullptr == device) {
@@ -72,7 +72,7 @@ bool CsvParser::parse(QFile* device)
     return parseFile();
 }
 
-bool CsvParser::readFile(QFile* device)
+bool CsvParser::readFile(QIODevice* device)
 {
     if (device->isOpen())
         device->close();
@@ -33,8 +33,8 @@ class CsvParser
 public:
     CsvParser();
     ~CsvParser();
-    // read data from device and parse it
-    bool parse(QFile* device);
+    // read data from device and parse it, the device is (re)opened read-only
+    bool parse(QIODevice* device);
     bool isFileLoaded();
     // reparse the same buffer (device is not opened again)
     bool reparse();
@@ -91,7 +91,7 @@ private:
     void parseQuoted(QString& s);
     void parseEscaped(QString& s);
     void parseEscapedText(QString& s);
-    bool readFile(QFile* device);
+    bool readFile(QIODevice* device);
     void reset();
     void clear();
     bool skipEndline();
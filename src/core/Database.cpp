@@ -27,8 +27,12 @@
 
 #include "cli/Utils.h"
 #include "core/Group.h"
+#include "core/HostIndex.h"
+#include "core/Merger.h"
 #include "core/Metadata.h"
+#include "core/PathIndex.h"
 #include "crypto/kdf/AesKdf.h"
+#include "format/KdbxXmlCache.h"
 #include "format/KeePass2.h"
 #include "format/KeePass2Reader.h"
 #include "format/KeePass2Writer.h"
@@ -42,6 +46,9 @@ Database::Database()
     , m_timer(new QTimer(this))
     , m_emitModified(false)
     , m_uuid(Uuid::random())
+    , m_xmlCache(new KdbxXmlCache())
+    , m_pathIndex(new PathIndex(this))
+    , m_hostIndex(new HostIndex(this))
 {
     m_data.cipher = KeePass2::CIPHER_AES;
     m_data.compressionAlgo = CompressionGZip;
@@ -85,6 +92,8 @@ void Database::setRootGroup(Group* group)
 
     m_rootGroup = group;
     m_rootGroup->setParent(this);
+    m_pathIndex->invalidate();
+    m_hostIndex->invalidate();
 }
 
 Metadata* Database::metadata()
@@ -109,22 +118,16 @@ Entry* Database::resolveEntry(const QString& text, EntryReferenceType referenceT
 
 Entry* Database::findEntryRecursive(const Uuid& uuid, Group* group)
 {
-    const QList<Entry*> entryList = group->entries();
-    for (Entry* entry : entryList) {
+    Entry* result = nullptr;
+    group->walkEntries([&result, &uuid](Entry* entry) {
         if (entry->uuid() == uuid) {
-            return entry;
+            result = entry;
+            return true;
         }
-    }
-
-    const QList<Group*> children = group->children();
-    for (Group* child : children) {
-        Entry* result = findEntryRecursive(uuid, child);
-        if (result) {
-            return result;
-        }
-    }
+        return false;
+    });
 
-    return nullptr;
+    return result;
 }
 
 Entry* Database::findEntryRecursive(const QString& text, EntryReferenceType referenceType, Group* group)
@@ -133,12 +136,18 @@ Entry* Database::findEntryRecursive(const QString& text, EntryReferenceType refe
                "Database::findEntryRecursive",
                "Can't search entry with \"referenceType\" parameter equal to \"Unknown\"");
 
-    bool found = false;
-    const QList<Entry*> entryList = group->entries();
-    for (Entry* entry : entryList) {
+    if (referenceType == EntryReferenceType::Unknown) {
+        return nullptr;
+    }
+
+    const Uuid uuid = referenceType == EntryReferenceType::Uuid ? Uuid::fromHex(text) : Uuid();
+
+    Entry* result = nullptr;
+    group->walkEntries([&](Entry* entry) {
+        bool found = false;
         switch (referenceType) {
         case EntryReferenceType::Unknown:
-            return nullptr;
+            break;
         case EntryReferenceType::Title:
             found = entry->title() == text;
             break;
@@ -155,7 +164,7 @@ Entry* Database::findEntryRecursive(const QString& text, EntryReferenceType refe
             found = entry->notes() == text;
             break;
         case EntryReferenceType::Uuid:
-            found = entry->uuid() == Uuid::fromHex(text);
+            found = entry->uuid() == uuid;
             break;
         case EntryReferenceType::CustomAttributes:
             found = entry->attributes()->containsValue(text);
@@ -163,19 +172,12 @@ Entry* Database::findEntryRecursive(const QString& text, EntryReferenceType refe
         }
 
         if (found) {
-            return entry;
+            result = entry;
         }
-    }
+        return found;
+    });
 
-    const QList<Group*> children = group->children();
-    for (Group* child : children) {
-        Entry* result = findEntryRecursive(text, referenceType, child);
-        if (result) {
-            return result;
-        }
-    }
-
-    return nullptr;
+    return result;
 }
 
 Group* Database::resolveGroup(const Uuid& uuid)
@@ -185,19 +187,16 @@ Group* Database::resolveGroup(const Uuid& uuid)
 
 Group* Database::findGroupRecursive(const Uuid& uuid, Group* group)
 {
-    if (group->uuid() == uuid) {
-        return group;
-    }
-
-    const QList<Group*> children = group->children();
-    for (Group* child : children) {
-        Group* result = findGroupRecursive(uuid, child);
-        if (result) {
-            return result;
+    Group* result = nullptr;
+    group->walkGroups([&result, &uuid](Group* candidate) {
+        if (candidate->uuid() == uuid) {
+            result = candidate;
+            return true;
         }
-    }
+        return false;
+    });
 
-    return nullptr;
+    return result;
 }
 
 QList<DeletedObject> Database::deletedObjects()
@@ -385,19 +384,18 @@ void Database::emptyRecycleBin()
 
 void Database::merge(const Database* other)
 {
-    m_rootGroup->merge(other->rootGroup());
-
-    for (Uuid customIconId : other->metadata()->customIcons().keys()) {
-        QImage customIcon = other->metadata()->customIcon(customIconId);
-        if (!this->metadata()->containsCustomIcon(customIconId)) {
-            qDebug("Adding custom icon %s to database.", qPrintable(customIconId.toHex()));
-            this->metadata()->addCustomIcon(customIconId, customIcon);
-        }
-    }
+    Merger merger(other, this);
+    merger.merge();
 
     emit modified();
 }
 
+void Database::syncDataFrom(const Database* other)
+{
+    m_deletedObjects = other->m_deletedObjects;
+    m_data = other->m_data;
+}
+
 void Database::setEmitModified(bool value)
 {
     if (m_emitModified && !value) {
@@ -561,6 +559,25 @@ QString Database::saveToFile(QString filePath, bool atomic, bool backup)
     return error;
 }
 
+/**
+ * Serialized fragments of the last save, used by the KDBX writer to
+ * avoid re-encoding entries and groups that did not change.
+ */
+KdbxXmlCache* Database::xmlCache()
+{
+    return m_xmlCache.data();
+}
+
+PathIndex* Database::pathIndex()
+{
+    return m_pathIndex.data();
+}
+
+HostIndex* Database::hostIndex()
+{
+    return m_hostIndex.data();
+}
+
 QString Database::writeDatabase(QIODevice* device)
 {
     KeePass2Writer writer;
@@ -22,6 +22,7 @@
 #include <QDateTime>
 #include <QHash>
 #include <QObject>
+#include <QScopedPointer>
 
 #include "core/Uuid.h"
 #include "crypto/kdf/Kdf.h"
@@ -31,6 +32,9 @@ class Entry;
 enum class EntryReferenceType;
 class Group;
 class Metadata;
+struct KdbxXmlCache;
+class HostIndex;
+class PathIndex;
 class QTimer;
 class QIODevice;
 
@@ -112,7 +116,15 @@ public:
     void emptyRecycleBin();
     void setEmitModified(bool value);
     void merge(const Database* other);
+    /**
+     * Takes over the settings, key and deleted objects of other, a newer
+     * copy of this database. Metadata and the group tree are not touched.
+     */
+    void syncDataFrom(const Database* other);
     QString saveToFile(QString filePath, bool atomic = true, bool backup = false);
+    KdbxXmlCache* xmlCache();
+    PathIndex* pathIndex();
+    HostIndex* hostIndex();
 
     /**
      * Returns a unique id that is only valid as long as the Database exists.
@@ -132,6 +144,7 @@ signals:
     void groupRemoved();
     void groupAboutToMove(Group* group, Group* toGroup, int index);
     void groupMoved();
+    void entryDataChanged(Entry* entry);
     void nameTextChanged();
     void modified();
     void modifiedImmediate();
@@ -156,6 +169,9 @@ private:
     bool m_emitModified;
 
     Uuid m_uuid;
+    QScopedPointer<KdbxXmlCache> m_xmlCache;
+    QScopedPointer<PathIndex> m_pathIndex;
+    QScopedPointer<HostIndex> m_hostIndex;
     static QHash<Uuid, Database*> m_uuidMap;
 };
 
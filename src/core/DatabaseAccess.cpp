@@ -0,0 +1,68 @@
+/*
+ *  Copyright (C) 2018 KeePassXC Team <team@keepassxc.org>
+ *
+ *  This program is free software: you can redistribute it and/or modify
+ *  it under the terms of the GNU General Public License as published by
+ *  the Free Software Foundation, either version 2 or (at your option)
+ *  version 3 of the License.
+ *
+ *  This program is distributed in the hope that it will be useful,
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *  GNU General Public License for more details.
+ *
+ *  You should have received a copy of the GNU General Public License
+ *  along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#include "DatabaseAccess.h"
+
+#include <QCoreApplication>
+#include <QReadWriteLock>
+#include <QThread>
+
+namespace
+{
+    QReadWriteLock g_lock;
+    // nesting of WriteLockers on the GUI thread, only touched by that thread
+    int g_writeDepth = 0;
+} // namespace
+
+namespace DatabaseAccess
+{
+    bool isGuiThread()
+    {
+        const QCoreApplication* app = QCoreApplication::instance();
+        return app && QThread::currentThread() == app->thread();
+    }
+
+    WriteLocker::WriteLocker()
+        : m_active(isGuiThread())
+    {
+        if (m_active && g_writeDepth++ == 0) {
+            g_lock.lockForWrite();
+        }
+    }
+
+    WriteLocker::~WriteLocker()
+    {
+        if (m_active && --g_writeDepth == 0) {
+            g_lock.unlock();
+        }
+    }
+
+    ReadLocker::ReadLocker()
+        : m_active(!isGuiThread())
+    {
+        if (m_active) {
+            g_lock.lockForRead();
+        }
+    }
+
+    ReadLocker::~ReadLocker()
+    {
+        if (m_active) {
+            g_lock.unlock();
+        }
+    }
+} // namespace DatabaseAccess
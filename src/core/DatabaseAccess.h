@@ -0,0 +1,90 @@
+/*
+ *  Copyright (C) 2018 KeePassXC Team <team@keepassxc.org>
+ *
+ *  This program is free software: you can redistribute it and/or modify
+ *  it under the terms of the GNU General Public License as published by
+ *  the Free Software Foundation, either version 2 or (at your option)
+ *  version 3 of the License.
+ *
+ *  This program is distributed in the hope that it will be useful,
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *  GNU General Public License for more details.
+ *
+ *  You should have received a copy of the GNU General Public License
+ *  along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#ifndef KEEPASSX_DATABASEACCESS_H
+#define KEEPASSX_DATABASEACCESS_H
+
+#include <QtGlobal>
+
+/**
+ * Reader-writer lock between the GUI thread, which owns and modifies the
+ * open databases, and worker threads that only read them.
+ *
+ * The GUI thread holds the write lock only around the code that changes
+ * entries or groups, or that replaces or deletes a database, never while
+ * it shows a dialog or runs a nested event loop, and it doesn't need a
+ * lock to read. View state that worker threads never read, e.g. whether
+ * a group is expanded, is not guarded. Worker threads take the read lock for
+ * the duration of a request and may then read databases concurrently with
+ * each other. They must not touch widgets, see BrowserService for the
+ * snapshot of open databases they use instead.
+ *
+ * The GUI code that takes the write lock, keep this list up to date when
+ * adding code that changes a database on the GUI thread:
+ * - DatabaseWidget: replacing, merging, reloading and locking a database,
+ *   deleting entries and groups, adding new ones, emptying the recycle bin
+ * - DatabaseTabWidget::deleteDatabase()
+ * - EditEntryWidget::commitEntry() and cancel(), EditGroupWidget::apply()
+ * - EditWidgetIcons::addCustomIcon() and removeCustomIcon()
+ * - DatabaseSettingsWidget::save() and truncateHistories()
+ * - CloneDialog::cloneEntry(), SetupTotpDialog::setupTotp()
+ * - GroupModel::dropMimeData()
+ * - BrowserService: adding, updating and confirming entries, storing and
+ *   removing keys and permissions
+ * Changing the master key or the KDF is not guarded, worker threads never
+ * read them.
+ *
+ * Both lockers do nothing on threads they don't apply to, so code that is
+ * shared between the GUI thread and worker threads can use them freely.
+ * Read locks must not be nested and must not be held while waiting for
+ * the GUI thread, e.g. in a Qt::BlockingQueuedConnection.
+ */
+namespace DatabaseAccess
+{
+    /**
+     * Holds the write lock on the GUI thread. Nested lockers are counted,
+     * only the outermost one locks.
+     */
+    class WriteLocker
+    {
+    public:
+        WriteLocker();
+        ~WriteLocker();
+
+    private:
+        Q_DISABLE_COPY(WriteLocker)
+        bool m_active;
+    };
+
+    /**
+     * Holds the read lock on a worker thread.
+     */
+    class ReadLocker
+    {
+    public:
+        ReadLocker();
+        ~ReadLocker();
+
+    private:
+        Q_DISABLE_COPY(ReadLocker)
+        bool m_active;
+    };
+
+    bool isGuiThread();
+} // namespace DatabaseAccess
+
+#endif // KEEPASSX_DATABASEACCESS_H
@@ -0,0 +1,220 @@
+/*
+ *  Copyright (C) 2018 KeePassXC Team <team@keepassxc.org>
+ *
+ *  This program is free software: you can redistribute it and/or modify
+ *  it under the terms of the GNU General Public License as published by
+ *  the Free Software Foundation, either version 2 or (at your option)
+ *  version 3 of the License.
+ *
+ *  This program is distributed in the hope that it will be useful,
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *  GNU General Public License for more details.
+ *
+ *  You should have received a copy of the GNU General Public License
+ *  along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#include "DatabaseDelta.h"
+
+#include "core/Database.h"
+#include "core/Entry.h"
+#include "core/Global.h"
+#include "core/Group.h"
+#include "core/Metadata.h"
+
+DatabaseDelta::DatabaseDelta(const Database* sourceDb, Database* targetDb)
+    : m_sourceDb(sourceDb)
+    , m_targetDb(targetDb)
+    , m_changeCount(0)
+{
+}
+
+bool DatabaseDelta::apply()
+{
+    m_changeCount = 0;
+
+    const Group* sourceRoot = m_sourceDb->rootGroup();
+    Group* targetRoot = m_targetDb->rootGroup();
+    if (sourceRoot->uuid() != targetRoot->uuid()) {
+        return false;
+    }
+
+    m_targetGroups.clear();
+    m_targetEntries.clear();
+    m_sourceGroups.clear();
+    m_sourceEntries.clear();
+
+    // adding, moving and removing children touches the time info of the
+    // parent groups, keep the one of the source instead
+    targetRoot->walkGroups([this](Group* group) {
+        m_targetGroups.insert(group->uuid(), group);
+        group->setUpdateTimeinfo(false);
+        return false;
+    });
+    targetRoot->walkEntries([this](Entry* entry) {
+        m_targetEntries.insert(entry->uuid(), entry);
+        return false;
+    });
+    sourceRoot->walkGroups([this](const Group* group) {
+        m_sourceGroups.insert(group->uuid());
+        return false;
+    });
+    sourceRoot->walkEntries([this](const Entry* entry) {
+        m_sourceEntries.insert(entry->uuid());
+        return false;
+    });
+
+    // icons have to be known before entries and groups refer to them
+    addCustomIcons();
+    syncGroup(targetRoot, sourceRoot);
+    removeStaleItems();
+    targetRoot->walkGroups([](Group* group) {
+        group->setUpdateTimeinfo(true);
+        return false;
+    });
+    removeCustomIcons();
+    syncDatabaseData();
+
+    return true;
+}
+
+int DatabaseDelta::changeCount() const
+{
+    return m_changeCount;
+}
+
+void DatabaseDelta::addCustomIcons()
+{
+    const Metadata* sourceMetadata = m_sourceDb->metadata();
+    Metadata* targetMetadata = m_targetDb->metadata();
+
+    const QList<Uuid> iconUuids = sourceMetadata->customIconsOrder();
+    for (const Uuid& iconUuid : iconUuids) {
+        if (!targetMetadata->containsCustomIcon(iconUuid)) {
+            targetMetadata->addCustomIcon(iconUuid, sourceMetadata->customIcon(iconUuid));
+            ++m_changeCount;
+        }
+    }
+}
+
+void DatabaseDelta::removeCustomIcons()
+{
+    const Metadata* sourceMetadata = m_sourceDb->metadata();
+    Metadata* targetMetadata = m_targetDb->metadata();
+
+    const QList<Uuid> iconUuids = targetMetadata->customIconsOrder();
+    for (const Uuid& iconUuid : iconUuids) {
+        if (!sourceMetadata->containsCustomIcon(iconUuid)) {
+            targetMetadata->removeCustomIcon(iconUuid);
+            ++m_changeCount;
+        }
+    }
+}
+
+void DatabaseDelta::syncGroup(Group* targetGroup, const Group* sourceGroup)
+{
+    syncGroupData(targetGroup, sourceGroup);
+
+    for (const Entry* sourceEntry : sourceGroup->entries()) {
+        Entry* targetEntry = m_targetEntries.value(sourceEntry->uuid());
+        if (!targetEntry) {
+            targetEntry = sourceEntry->clone(Entry::CloneIncludeHistory);
+            targetEntry->setUpdateTimeinfo(false);
+            targetEntry->setGroup(targetGroup);
+            targetEntry->setUpdateTimeinfo(true);
+            m_targetEntries.insert(targetEntry->uuid(), targetEntry);
+            ++m_changeCount;
+            continue;
+        }
+
+        if (targetEntry->group() != targetGroup) {
+            targetEntry->setUpdateTimeinfo(false);
+            targetEntry->setGroup(targetGroup);
+            targetEntry->setUpdateTimeinfo(true);
+            ++m_changeCount;
+        }
+        syncEntry(targetEntry, sourceEntry);
+    }
+
+    const QList<Group*>& sourceChildren = sourceGroup->children();
+    for (int i = 0; i < sourceChildren.size(); ++i) {
+        const Group* sourceChild = sourceChildren[i];
+        Group* targetChild = m_targetGroups.value(sourceChild->uuid());
+        if (!targetChild) {
+            // entries and children are added by the recursion below
+            targetChild = sourceChild->clone(Entry::CloneNoFlags, Group::CloneNoFlags);
+            targetChild->setUpdateTimeinfo(false);
+            targetChild->setParent(targetGroup, i);
+            m_targetGroups.insert(targetChild->uuid(), targetChild);
+            ++m_changeCount;
+        } else if (targetChild->parentGroup() != targetGroup || targetGroup->children().indexOf(targetChild) != i) {
+            // the parents of sourceChild have already been synced, so this can't create a cycle
+            targetChild->setParent(targetGroup, i);
+            ++m_changeCount;
+        }
+
+        syncGroup(targetChild, sourceChild);
+    }
+}
+
+void DatabaseDelta::syncGroupData(Group* targetGroup, const Group* sourceGroup)
+{
+    if (targetGroup->equals(sourceGroup)) {
+        return;
+    }
+
+    targetGroup->syncDataFrom(sourceGroup);
+    ++m_changeCount;
+}
+
+void DatabaseDelta::syncEntry(Entry* targetEntry, const Entry* sourceEntry)
+{
+    if (targetEntry->equals(sourceEntry)) {
+        return;
+    }
+
+    targetEntry->syncDataFrom(sourceEntry);
+    ++m_changeCount;
+}
+
+void DatabaseDelta::removeStaleItems()
+{
+    QList<Entry*> staleEntries;
+    for (Entry* entry : asConst(m_targetEntries)) {
+        if (!m_sourceEntries.contains(entry->uuid())) {
+            staleEntries.append(entry);
+        }
+    }
+
+    QList<Group*> staleGroups;
+    m_targetDb->rootGroup()->walkGroups([this, &staleGroups](Group* group) {
+        // only the topmost stale group needs to be deleted, it takes its children with it
+        if (!m_sourceGroups.contains(group->uuid()) && m_sourceGroups.contains(group->parentGroup()->uuid())) {
+            staleGroups.append(group);
+        }
+        return false;
+    }, false);
+
+    m_changeCount += staleEntries.size() + staleGroups.size();
+    qDeleteAll(staleEntries);
+    qDeleteAll(staleGroups);
+}
+
+void DatabaseDelta::syncDatabaseData()
+{
+    const Metadata* sourceMetadata = m_sourceDb->metadata();
+    Metadata* targetMetadata = m_targetDb->metadata();
+
+    targetMetadata->syncDataFrom(sourceMetadata);
+
+    const Group* sourceRecycleBin = sourceMetadata->recycleBin();
+    targetMetadata->setRecycleBin(sourceRecycleBin ? m_targetGroups.value(sourceRecycleBin->uuid()) : nullptr);
+    targetMetadata->setRecycleBinChanged(sourceMetadata->recycleBinChanged());
+
+    const Group* sourceTemplates = sourceMetadata->entryTemplatesGroup();
+    targetMetadata->setEntryTemplatesGroup(sourceTemplates ? m_targetGroups.value(sourceTemplates->uuid()) : nullptr);
+    targetMetadata->setEntryTemplatesGroupChanged(sourceMetadata->entryTemplatesGroupChanged());
+
+    m_targetDb->syncDataFrom(m_sourceDb);
+}
@@ -0,0 +1,80 @@
+/*
+ *  Copyright (C) 2018 KeePassXC Team <team@keepassxc.org>
+ *
+ *  This program is free software: you can redistribute it and/or modify
+ *  it under the terms of the GNU General Public License as published by
+ *  the Free Software Foundation, either version 2 or (at your option)
+ *  version 3 of the License.
+ *
+ *  This program is distributed in the hope that it will be useful,
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *  GNU General Public License for more details.
+ *
+ *  You should have received a copy of the GNU General Public License
+ *  along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#ifndef KEEPASSX_DATABASEDELTA_H
+#define KEEPASSX_DATABASEDELTA_H
+
+#include <QHash>
+#include <QSet>
+
+#include "core/Uuid.h"
+
+class Database;
+class Entry;
+class Group;
+
+/**
+ * Updates an open database in place so that it matches another copy of
+ * the same database, e.g. the file on disk after it was changed by
+ * someone else.
+ *
+ * Entries and groups are matched by uuid. Only the objects that differ
+ * are touched: changed data is copied, moved objects are reparented,
+ * missing objects are cloned from the source and stale objects are
+ * deleted. Every change goes through the regular Group and Entry
+ * methods, so attached models receive row signals instead of a reset
+ * and unchanged objects keep their identity (selection, pointers).
+ * Time info is taken over from the source unchanged.
+ */
+class DatabaseDelta
+{
+public:
+    DatabaseDelta(const Database* sourceDb, Database* targetDb);
+
+    /**
+     * Applies the differences to the target database.
+     *
+     * @return false if the databases do not share the same root group,
+     *         the target is left untouched in this case
+     */
+    bool apply();
+
+    /**
+     * Number of entries, groups and custom icons that were added, moved,
+     * updated or removed by the last apply().
+     */
+    int changeCount() const;
+
+private:
+    void addCustomIcons();
+    void removeCustomIcons();
+    void syncGroup(Group* targetGroup, const Group* sourceGroup);
+    void syncGroupData(Group* targetGroup, const Group* sourceGroup);
+    void syncEntry(Entry* targetEntry, const Entry* sourceEntry);
+    void removeStaleItems();
+    void syncDatabaseData();
+
+    const Database* m_sourceDb;
+    Database* m_targetDb;
+    QHash<Uuid, Group*> m_targetGroups;
+    QHash<Uuid, Entry*> m_targetEntries;
+    QSet<Uuid> m_sourceGroups;
+    QSet<Uuid> m_sourceEntries;
+    int m_changeCount;
+};
+
+#endif // KEEPASSX_DATABASEDELTA_H
@@ -25,6 +25,7 @@
 #include "core/Metadata.h"
 #include "totp/totp.h"
 
+#include <QAtomicInteger>
 #include <QRegularExpression>
 
 const int Entry::DefaultIconNumber = 0;
@@ -32,6 +33,22 @@ const int Entry::ResolveMaximumDepth = 10;
 const QString Entry::AutoTypeSequenceUsername = "{USERNAME}{ENTER}";
 const QString Entry::AutoTypeSequencePassword = "{PASSWORD}{ENTER}";
 
+static QAtomicInteger<quint64> s_nextRevision(1);
+
+bool EntryData::operator==(const EntryData& other) const
+{
+    // the TOTP settings are derived from the attributes and not compared
+    return iconNumber == other.iconNumber && customIcon == other.customIcon && foregroundColor == other.foregroundColor
+           && backgroundColor == other.backgroundColor && overrideUrl == other.overrideUrl && tags == other.tags
+           && autoTypeEnabled == other.autoTypeEnabled && autoTypeObfuscation == other.autoTypeObfuscation
+           && defaultAutoTypeSequence == other.defaultAutoTypeSequence && timeInfo == other.timeInfo;
+}
+
+bool EntryData::operator!=(const EntryData& other) const
+{
+    return !(*this == other);
+}
+
 Entry::Entry()
     : m_attributes(new EntryAttributes(this))
     , m_attachments(new EntryAttachments(this))
@@ -40,6 +57,7 @@ Entry::Entry()
     , m_tmpHistoryItem(nullptr)
     , m_modifiedSinceBegin(false)
     , m_updateTimeinfo(true)
+    , m_revision(s_nextRevision.fetchAndAddRelaxed(1))
 {
     m_data.iconNumber = DefaultIconNumber;
     m_data.autoTypeEnabled = true;
@@ -50,12 +68,14 @@ Entry::Entry()
     connect(m_attributes, SIGNAL(modified()), SLOT(updateTotp()));
     connect(m_attributes, SIGNAL(modified()), this, SIGNAL(modified()));
     connect(m_attributes, SIGNAL(defaultKeyModified()), SLOT(emitDataChanged()));
+    connect(m_attributes, SIGNAL(reset()), SLOT(emitDataChanged()));
     connect(m_attachments, SIGNAL(modified()), this, SIGNAL(modified()));
     connect(m_autoTypeAssociations, SIGNAL(modified()), SIGNAL(modified()));
     connect(m_customData, SIGNAL(modified()), this, SIGNAL(modified()));
 
     connect(this, SIGNAL(modified()), SLOT(updateTimeinfo()));
     connect(this, SIGNAL(modified()), SLOT(updateModifiedSinceBegin()));
+    connect(this, SIGNAL(modified()), SLOT(markDirty()));
 }
 
 Entry::~Entry()
@@ -95,6 +115,16 @@ void Entry::setUpdateTimeinfo(bool value)
     m_updateTimeinfo = value;
 }
 
+quint64 Entry::revision() const
+{
+    return m_revision;
+}
+
+void Entry::markDirty()
+{
+    m_revision = s_nextRevision.fetchAndAddRelaxed(1);
+}
+
 EntryReferenceType Entry::referenceType(const QString& referenceStr)
 {
     const QString referenceLowerStr = referenceStr.toLower();
@@ -396,15 +426,22 @@ void Entry::setTotp(const QString& seed, quint8& step, quint8& digits)
 
 QString Entry::totpSeed() const
 {
-    QString secret = "";
+    // updateTotp() already stored the digits and step of the secret,
+    // entries may be read on several threads so don't write them here
+    quint8 digits = m_data.totpDigits;
+    quint8 step = m_data.totpStep;
+    return Totp::parseOtpString(totpSecret(), digits, step);
+}
 
+QString Entry::totpSecret() const
+{
     if (m_attributes->hasKey("otp")) {
-        secret = m_attributes->value("otp");
+        return m_attributes->value("otp");
     } else if (m_attributes->hasKey("TOTP Seed")) {
-        secret = m_attributes->value("TOTP Seed");
+        return m_attributes->value("TOTP Seed");
     }
 
-    return Totp::parseOtpString(secret, m_data.totpDigits, m_data.totpStep);
+    return QString("");
 }
 
 quint8 Entry::totpStep() const
@@ -420,7 +457,9 @@ quint8 Entry::totpDigits() const
 void Entry::setUuid(const Uuid& uuid)
 {
     Q_ASSERT(!uuid.isNull());
-    set(m_uuid, uuid);
+    if (set(m_uuid, uuid)) {
+        emit dataChanged(this);
+    }
 }
 
 void Entry::setIcon(int iconNumber)
@@ -472,6 +511,7 @@ void Entry::setTags(const QString& tags)
 void Entry::setTimeInfo(const TimeInfo& timeInfo)
 {
     m_data.timeInfo = timeInfo;
+    markDirty();
 }
 
 void Entry::setAutoTypeEnabled(bool enable)
@@ -591,6 +631,7 @@ void Entry::truncateHistory()
             if (historyCount > histMaxItems) {
                 delete entry;
                 i.remove();
+                markDirty();
             }
         }
     }
@@ -622,6 +663,7 @@ void Entry::truncateHistory()
             if (size > histMaxSize) {
                 delete historyItem;
                 i.remove();
+                markDirty();
             }
         }
     }
@@ -689,6 +731,44 @@ void Entry::copyDataFrom(const Entry* other)
     m_attachments->copyDataFrom(other->m_attachments);
     m_autoTypeAssociations->copyDataFrom(other->m_autoTypeAssociations);
     setUpdateTimeinfo(true);
+    markDirty();
+}
+
+void Entry::syncDataFrom(const Entry* other)
+{
+    copyDataFrom(other);
+
+    setUpdateTimeinfo(false);
+    const QList<Entry*> oldHistory = m_history;
+    removeHistoryItems(oldHistory);
+    for (const Entry* historyItem : other->historyItems()) {
+        addHistoryItem(historyItem->clone(CloneNoFlags));
+    }
+    emit modified();
+    setUpdateTimeinfo(true);
+
+    emit dataChanged(this);
+}
+
+bool Entry::equals(const Entry* other) const
+{
+    if (!other) {
+        return false;
+    }
+
+    if (m_uuid != other->m_uuid || m_data != other->m_data || *m_attributes != *other->m_attributes
+        || *m_attachments != *other->m_attachments || *m_autoTypeAssociations != *other->m_autoTypeAssociations
+        || *m_customData != *other->m_customData || m_history.size() != other->m_history.size()) {
+        return false;
+    }
+
+    for (int i = 0; i < m_history.size(); ++i) {
+        if (!m_history[i]->equals(other->m_history[i])) {
+            return false;
+        }
+    }
+
+    return true;
 }
 
 void Entry::beginUpdate()
@@ -735,23 +815,22 @@ void Entry::updateTotp()
     m_data.totpDigits = Totp::defaultDigits;
     m_data.totpStep = Totp::defaultStep;
 
-    if (!m_attributes->hasKey("TOTP Settings")) {
-        return;
-    }
-
-    // this regex must be kept in sync with the set of allowed short names Totp::shortNameToEncoder
-    QRegularExpression rx(QString("(\\d+);((?:\\d+)|S)"));
-    QRegularExpressionMatch m = rx.match(m_attributes->value("TOTP Settings"));
-    if (!m.hasMatch()) {
-        return;
+    if (m_attributes->hasKey("TOTP Settings")) {
+        // this regex must be kept in sync with the set of allowed short names Totp::shortNameToEncoder
+        QRegularExpression rx(QString("(\\d+);((?:\\d+)|S)"));
+        QRegularExpressionMatch m = rx.match(m_attributes->value("TOTP Settings"));
+        if (m.hasMatch()) {
+            m_data.totpStep = static_cast<quint8>(m.captured(1).toUInt());
+            if (Totp::shortNameToEncoder.contains(m.captured(2))) {
+                m_data.totpDigits = Totp::shortNameToEncoder[m.captured(2)];
+            } else {
+                m_data.totpDigits = static_cast<quint8>(m.captured(2).toUInt());
+            }
+        }
     }
 
-    m_data.totpStep = static_cast<quint8>(m.captured(1).toUInt());
-    if (Totp::shortNameToEncoder.contains(m.captured(2))) {
-        m_data.totpDigits = Totp::shortNameToEncoder[m.captured(2)];
-    } else {
-        m_data.totpDigits = static_cast<quint8>(m.captured(2).toUInt());
-    }
+    // settings in the secret itself, e.g. an otpauth URL, take precedence
+    Totp::parseOtpString(totpSecret(), m_data.totpDigits, m_data.totpStep);
 }
 
 QString Entry::resolveMultiplePlaceholdersRecursive(const QString& str, int maxDepth) const
@@ -940,6 +1019,7 @@ void Entry::setGroup(Group* group)
 
     if (m_updateTimeinfo) {
         m_data.timeInfo.setLocationChanged(QDateTime::currentDateTimeUtc());
+        markDirty();
     }
 }
 
@@ -61,8 +61,11 @@ struct EntryData
     int autoTypeObfuscation;
     QString defaultAutoTypeSequence;
     TimeInfo timeInfo;
-    mutable quint8 totpDigits;
-    mutable quint8 totpStep;
+    quint8 totpDigits;
+    quint8 totpStep;
+
+    bool operator==(const EntryData& other) const;
+    bool operator!=(const EntryData& other) const;
 };
 
 class Entry : public QObject
@@ -187,6 +190,19 @@ public:
      */
     Entry* clone(CloneFlags flags) const;
     void copyDataFrom(const Entry* other);
+    /**
+     * Replaces the data and history of this entry with copies of the ones
+     * of other, e.g. a newer copy of the same entry. The time info is taken
+     * over as well instead of being updated. Emits modified() and
+     * dataChanged() like an edit does.
+     */
+    void syncDataFrom(const Entry* other);
+    /**
+     * Returns true if this entry and other hold the same uuid, data and
+     * history, i.e. would be written identically to the database file.
+     * The group the entries belong to is not compared.
+     */
+    bool equals(const Entry* other) const;
     QString maskPasswordPlaceholders(const QString& str) const;
     QString resolveMultiplePlaceholders(const QString& str) const;
     QString resolvePlaceholder(const QString& str) const;
@@ -207,6 +223,13 @@ public:
 
     void setUpdateTimeinfo(bool value);
 
+    /**
+     * Serial number that changes whenever data written to the database file
+     * changes. Used by the KDBX writer to reuse serialized fragments of
+     * entries that have not been touched since the last save.
+     */
+    quint64 revision() const;
+
 signals:
     /**
      * Emitted when a default attribute has been changed.
@@ -220,12 +243,14 @@ private slots:
     void updateTimeinfo();
     void updateModifiedSinceBegin();
     void updateTotp();
+    void markDirty();
 
 private:
     QString resolveMultiplePlaceholdersRecursive(const QString& str, int maxDepth) const;
     QString resolvePlaceholderRecursive(const QString& placeholder, int maxDepth) const;
     QString resolveReferencePlaceholderRecursive(const QString& placeholder, int maxDepth) const;
     QString referenceFieldValue(EntryReferenceType referenceType) const;
+    QString totpSecret() const;
 
     static EntryReferenceType referenceType(const QString& referenceStr);
 
@@ -244,6 +269,9 @@ private:
     bool m_modifiedSinceBegin;
     QPointer<Group> m_group;
     bool m_updateTimeinfo;
+    quint64 m_revision;
+
+    friend class Merger;
 };
 
 Q_DECLARE_OPERATORS_FOR_FLAGS(Entry::CloneFlags)
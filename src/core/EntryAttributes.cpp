@@ -18,6 +18,8 @@
 
 #include "EntryAttributes.h"
 
+#include <algorithm>
+
 const QString EntryAttributes::TitleKey = "Title";
 const QString EntryAttributes::UserNameKey = "UserName";
 const QString EntryAttributes::PasswordKey = "Password";
@@ -34,86 +36,123 @@ const QString EntryAttributes::RememberCmdExecAttr = "_EXEC_CMD";
 
 EntryAttributes::EntryAttributes(QObject* parent)
     : QObject(parent)
+    , m_data(new EntryAttributesData())
 {
+    for (int i = 0; i < DefaultAttributeCount; ++i) {
+        m_data->defaultAttributes[i].key = DefaultAttributes.at(i);
+        m_data->defaultAttributes[i].isProtected = false;
+    }
+
     clear();
 }
 
 QList<QString> EntryAttributes::keys() const
 {
-    return m_attributes.keys();
+    // Slots of Notes, Password, Title, URL and UserName
+    static const int sortedDefaultSlots[DefaultAttributeCount] = {4, 2, 0, 3, 1};
+
+    QList<QString> keyList;
+    keyList.reserve(DefaultAttributeCount + m_data->customAttributes.size());
+
+    int i = 0;
+    for (const Attribute& attribute : m_data->customAttributes) {
+        while (i < DefaultAttributeCount && m_data->defaultAttributes[sortedDefaultSlots[i]].key < attribute.key) {
+            keyList.append(m_data->defaultAttributes[sortedDefaultSlots[i++]].key);
+        }
+        keyList.append(attribute.key);
+    }
+    while (i < DefaultAttributeCount) {
+        keyList.append(m_data->defaultAttributes[sortedDefaultSlots[i++]].key);
+    }
+
+    return keyList;
 }
 
 bool EntryAttributes::hasKey(const QString& key) const
 {
-    return m_attributes.contains(key);
+    return constFind(key) != nullptr;
 }
 
 QList<QString> EntryAttributes::customKeys() const
 {
     QList<QString> customKeys;
-    const QList<QString> keyList = keys();
-    for (const QString& key : keyList) {
-        if (!isDefaultAttribute(key)) {
-            customKeys.append(key);
-        }
+    customKeys.reserve(m_data->customAttributes.size());
+    for (const Attribute& attribute : m_data->customAttributes) {
+        customKeys.append(attribute.key);
     }
     return customKeys;
 }
 
 QString EntryAttributes::value(const QString& key) const
 {
-    return m_attributes.value(key);
+    const Attribute* attribute = constFind(key);
+    return attribute ? attribute->value : QString();
 }
 
 bool EntryAttributes::contains(const QString& key) const
 {
-    return m_attributes.contains(key);
+    return constFind(key) != nullptr;
 }
 
 bool EntryAttributes::containsValue(const QString& value) const
 {
-    return m_attributes.values().contains(value);
+    for (const Attribute& attribute : m_data->defaultAttributes) {
+        if (attribute.value == value) {
+            return true;
+        }
+    }
+
+    for (const Attribute& attribute : m_data->customAttributes) {
+        if (attribute.value == value) {
+            return true;
+        }
+    }
+
+    return false;
 }
 
 bool EntryAttributes::isProtected(const QString& key) const
 {
-    return m_protectedAttributes.contains(key);
+    const Attribute* attribute = constFind(key);
+    return attribute && attribute->isProtected;
 }
 
 bool EntryAttributes::isReference(const QString& key) const
 {
-    if (!m_attributes.contains(key)) {
+    const Attribute* attribute = constFind(key);
+    if (!attribute) {
         Q_ASSERT(false);
         return false;
     }
 
-    const QString data = value(key);
-    return matchReference(data).hasMatch();
+    return matchReference(attribute->value).hasMatch();
 }
 
 void EntryAttributes::set(const QString& key, const QString& value, bool protect)
 {
     bool emitModified = false;
 
-    bool addAttribute = !m_attributes.contains(key);
-    bool changeValue = !addAttribute && (m_attributes.value(key) != value);
+    const Attribute* attribute = constFind(key);
+    bool addAttribute = !attribute;
+    bool changeValue = !addAttribute && (attribute->value != value);
+    bool changeProtection = !addAttribute && (attribute->isProtected != protect);
     bool defaultAttribute = isDefaultAttribute(key);
 
     if (addAttribute && !defaultAttribute) {
         emit aboutToBeAdded(key);
     }
 
-    if (addAttribute || changeValue) {
-        m_attributes.insert(key, value);
+    if (addAttribute) {
+        Attribute newAttribute;
+        newAttribute.key = key;
+        newAttribute.value = value;
+        newAttribute.isProtected = protect;
+        m_data->customAttributes.insert(customLowerBound(key), newAttribute);
         emitModified = true;
-    }
-
-    if (protect) {
-        if (!m_protectedAttributes.contains(key)) {
-            emitModified = true;
-        }
-        m_protectedAttributes.insert(key);
-    } else if (m_protectedAttributes.remove(key)) {
+    } else if (changeValue || changeProtection) {
+        Attribute* existingAttribute = find(key);
+        existingAttribute->value = value;
+        existingAttribute->isProtected = protect;
         emitModified = true;
     }
 
@@ -134,15 +173,14 @@ void EntryAttributes::remove(const QString& key)
 {
     Q_ASSERT(!isDefaultAttribute(key));
 
-    if (!m_attributes.contains(key)) {
+    if (isDefaultAttribute(key) || !contains(key)) {
         Q_ASSERT(false);
         return;
     }
 
     emit aboutToBeRemoved(key);
 
-    m_attributes.remove(key);
-    m_protectedAttributes.remove(key);
+    m_data->customAttributes.erase(customLowerBound(key));
 
     emit removed(key);
     emit modified();
@@ -153,27 +191,23 @@ void EntryAttributes::rename(const QString& oldKey, const QString& newKey)
     Q_ASSERT(!isDefaultAttribute(oldKey));
     Q_ASSERT(!isDefaultAttribute(newKey));
 
-    if (!m_attributes.contains(oldKey)) {
+    if (isDefaultAttribute(oldKey) || !contains(oldKey)) {
         Q_ASSERT(false);
         return;
     }
 
-    if (m_attributes.contains(newKey)) {
+    if (contains(newKey)) {
         Q_ASSERT(false);
         return;
     }
 
-    QString data = value(oldKey);
-    bool protect = isProtected(oldKey);
+    Attribute attribute = *constFind(oldKey);
+    attribute.key = newKey;
 
     emit aboutToRename(oldKey, newKey);
 
-    m_attributes.remove(oldKey);
-    m_attributes.insert(newKey, data);
-    if (protect) {
-        m_protectedAttributes.remove(oldKey);
-        m_protectedAttributes.insert(newKey);
-    }
+    m_data->customAttributes.erase(customLowerBound(oldKey));
+    m_data->customAttributes.insert(customLowerBound(newKey), attribute);
 
     emit modified();
     emit renamed(oldKey, newKey);
@@ -187,24 +221,7 @@ void EntryAttributes::copyCustomKeysFrom(const EntryAttributes* other)
 
     emit aboutToBeReset();
 
-    // remove all non-default keys
-    const QList<QString> keyList = keys();
-    for (const QString& key : keyList) {
-        if (!isDefaultAttribute(key)) {
-            m_attributes.remove(key);
-            m_protectedAttributes.remove(key);
-        }
-    }
-
-    const QList<QString> otherKeyList = other->keys();
-    for (const QString& key : otherKeyList) {
-        if (!isDefaultAttribute(key)) {
-            m_attributes.insert(key, other->value(key));
-            if (other->isProtected(key)) {
-                m_protectedAttributes.insert(key);
-            }
-        }
-    }
+    m_data->customAttributes = other->m_data->customAttributes;
 
     emit reset();
     emit modified();
@@ -212,23 +229,8 @@ void EntryAttributes::copyCustomKeysFrom(const EntryAttributes* other)
 
 bool EntryAttributes::areCustomKeysDifferent(const EntryAttributes* other)
 {
-    // check if they are equal ignoring the order of the keys
-    if (keys().toSet() != other->keys().toSet()) {
-        return true;
-    }
-
-    const QList<QString> keyList = keys();
-    for (const QString& key : keyList) {
-        if (isDefaultAttribute(key)) {
-            continue;
-        }
-
-        if (isProtected(key) != other->isProtected(key) || value(key) != other->value(key)) {
-            return true;
-        }
-    }
-
-    return false;
+    // both lists are sorted by key, so the order of insertion does not matter
+    return m_data.constData()->customAttributes != other->m_data->customAttributes;
 }
 
 void EntryAttributes::copyDataFrom(const EntryAttributes* other)
@@ -236,8 +238,7 @@ void EntryAttributes::copyDataFrom(const EntryAttributes* other)
     if (*this != *other) {
         emit aboutToBeReset();
 
-        m_attributes = other->m_attributes;
-        m_protectedAttributes = other->m_protectedAttributes;
+        m_data = other->m_data;
 
         emit reset();
         emit modified();
@@ -246,12 +247,22 @@ void EntryAttributes::copyDataFrom(const EntryAttributes* other)
 
 bool EntryAttributes::operator==(const EntryAttributes& other) const
 {
-    return (m_attributes == other.m_attributes && m_protectedAttributes == other.m_protectedAttributes);
+    if (m_data == other.m_data) {
+        return true;
+    }
+
+    for (int i = 0; i < DefaultAttributeCount; ++i) {
+        if (m_data->defaultAttributes[i] != other.m_data->defaultAttributes[i]) {
+            return false;
+        }
+    }
+
+    return m_data->customAttributes == other.m_data->customAttributes;
 }
 
 bool EntryAttributes::operator!=(const EntryAttributes& other) const
 {
-    return (m_attributes != other.m_attributes || m_protectedAttributes != other.m_protectedAttributes);
+    return !(*this == other);
 }
 
 QRegularExpressionMatch EntryAttributes::matchReference(const QString& text)
@@ -267,12 +278,11 @@ void EntryAttributes::clear()
 {
     emit aboutToBeReset();
 
-    m_attributes.clear();
-    m_protectedAttributes.clear();
-
-    for (const QString& key : DefaultAttributes) {
-        m_attributes.insert(key, "");
+    for (Attribute& attribute : m_data->defaultAttributes) {
+        attribute.value = QString("");
+        attribute.isProtected = false;
     }
+    m_data->customAttributes.clear();
 
     emit reset();
     emit modified();
@@ -281,13 +291,89 @@ void EntryAttributes::clear()
 int EntryAttributes::attributesSize() const
 {
     int size = 0;
-    for (auto it = m_attributes.constBegin(); it != m_attributes.constEnd(); ++it) {
-        size += it.key().toUtf8().size() + it.value().toUtf8().size();
+    for (const Attribute& attribute : m_data->defaultAttributes) {
+        size += attribute.key.toUtf8().size() + attribute.value.toUtf8().size();
+    }
+    for (const Attribute& attribute : m_data->customAttributes) {
+        size += attribute.key.toUtf8().size() + attribute.value.toUtf8().size();
     }
     return size;
 }
 
 bool EntryAttributes::isDefaultAttribute(const QString& key)
 {
-    return DefaultAttributes.contains(key);
+    return defaultSlot(key) >= 0;
+}
+
+/**
+ * Returns the index of a default attribute in DefaultAttributes or -1.
+ */
+int EntryAttributes::defaultSlot(const QString& key)
+{
+    // dispatch on the length first so custom keys rarely need a comparison
+    switch (key.size()) {
+    case 3:
+        return key == URLKey ? 3 : -1;
+    case 5:
+        if (key == TitleKey) {
+            return 0;
+        }
+        return key == NotesKey ? 4 : -1;
+    case 8:
+        if (key == UserNameKey) {
+            return 1;
+        }
+        return key == PasswordKey ? 2 : -1;
+    default:
+        return -1;
+    }
+}
+
+const EntryAttributes::Attribute* EntryAttributes::constFind(const QString& key) const
+{
+    int slot = defaultSlot(key);
+    if (slot >= 0) {
+        return &m_data->defaultAttributes[slot];
+    }
+
+    auto it = std::lower_bound(m_data->customAttributes.constBegin(),
+                               m_data->customAttributes.constEnd(),
+                               key,
+                               [](const Attribute& attribute, const QString& k) { return attribute.key < k; });
+    if (it != m_data->customAttributes.constEnd() && it->key == key) {
+        return &*it;
+    }
+    return nullptr;
+}
+
+EntryAttributes::Attribute* EntryAttributes::find(const QString& key)
+{
+    int slot = defaultSlot(key);
+    if (slot >= 0) {
+        return &m_data->defaultAttributes[slot];
+    }
+
+    auto it = customLowerBound(key);
+    if (it != m_data->customAttributes.end() && it->key == key) {
+        return &*it;
+    }
+    return nullptr;
+}
+
+QVector<EntryAttributes::Attribute>::iterator EntryAttributes::customLowerBound(const QString& key)
+{
+    return std::lower_bound(m_data->customAttributes.begin(),
+                            m_data->customAttributes.end(),
+                            key,
+                            [](const Attribute& attribute, const QString& k) { return attribute.key < k; });
+}
+
+bool EntryAttributes::Attribute::operator==(const Attribute& other) const
+{
+    return key == other.key && value == other.value && isProtected == other.isProtected;
+}
+
+bool EntryAttributes::Attribute::operator!=(const Attribute& other) const
+{
+    return !(*this == other);
 }
@@ -19,11 +19,11 @@
 #ifndef KEEPASSX_ENTRYATTRIBUTES_H
 #define KEEPASSX_ENTRYATTRIBUTES_H
 
-#include <QMap>
 #include <QObject>
 #include <QRegularExpression>
-#include <QSet>
+#include <QSharedData>
 #include <QStringList>
+#include <QVector>
 
 class EntryAttributes : public QObject
 {
@@ -79,8 +79,41 @@ signals:
     void reset();
 
 private:
-    QMap<QString, QString> m_attributes;
-    QSet<QString> m_protectedAttributes;
+    struct Attribute
+    {
+        QString key;
+        QString value;
+        bool isProtected;
+
+        bool operator==(const Attribute& other) const;
+        bool operator!=(const Attribute& other) const;
+    };
+
+    enum
+    {
+        DefaultAttributeCount = 5
+    };
+
+    /**
+     * The default attributes always exist and are stored in fixed slots in
+     * the order of DefaultAttributes. Custom attributes are kept sorted by
+     * key so keys() returns the same order as a map would.
+     *
+     * The data is implicitly shared, copying it between entries (clones,
+     * history items) only detaches once one of them is modified.
+     */
+    struct EntryAttributesData : public QSharedData
+    {
+        Attribute defaultAttributes[DefaultAttributeCount];
+        QVector<Attribute> customAttributes;
+    };
+
+    static int defaultSlot(const QString& key);
+    const Attribute* constFind(const QString& key) const;
+    Attribute* find(const QString& key);
+    QVector<Attribute>::iterator customLowerBound(const QString& key);
+
+    QSharedDataPointer<EntryAttributesData> m_data;
 };
 
 #endif // KEEPASSX_ENTRYATTRIBUTES_H
@@ -18,54 +18,89 @@
 
 #include "EntrySearcher.h"
 
+#include "core/Global.h"
 #include "core/Group.h"
 
 QList<Entry*> EntrySearcher::search(const QString& searchTerm, const Group* group, Qt::CaseSensitivity caseSensitivity)
 {
+    QList<Entry*> searchResult;
+
     if (!group->resolveSearchingEnabled()) {
-        return QList<Entry*>();
+        return searchResult;
     }
 
-    return searchEntries(searchTerm, group, caseSensitivity);
+    const QStringList wordList = searchTerm.split(QRegExp("\\s"), QString::SkipEmptyParts);
+    searchEntries(wordList, group, caseSensitivity, searchResult);
+    return searchResult;
 }
 
-QList<Entry*>
-EntrySearcher::searchEntries(const QString& searchTerm, const Group* group, Qt::CaseSensitivity caseSensitivity)
+void EntrySearcher::searchEntries(const QStringList& wordList,
+                                  const Group* group,
+                                  Qt::CaseSensitivity caseSensitivity,
+                                  QList<Entry*>& searchResult)
 {
-    QList<Entry*> searchResult;
-
-    const QList<Entry*> entryList = group->entries();
-    for (Entry* entry : entryList) {
-        searchResult.append(matchEntry(searchTerm, entry, caseSensitivity));
+    for (Entry* entry : group->entries()) {
+        if (matchEntry(wordList, entry, caseSensitivity)) {
+            searchResult.append(entry);
+        }
     }
 
-    const QList<Group*> children = group->children();
-    for (Group* childGroup : children) {
+    for (const Group* childGroup : group->children()) {
         if (childGroup->searchingEnabled() != Group::Disable) {
-            if (matchGroup(searchTerm, childGroup, caseSensitivity)) {
+            if (matchGroup(wordList, childGroup, caseSensitivity)) {
                 searchResult.append(childGroup->entriesRecursive());
             } else {
-                searchResult.append(searchEntries(searchTerm, childGroup, caseSensitivity));
+                searchEntries(wordList, childGroup, caseSensitivity, searchResult);
             }
         }
     }
-
-    return searchResult;
 }
 
-QList<Entry*> EntrySearcher::matchEntry(const QString& searchTerm, Entry* entry, Qt::CaseSensitivity caseSensitivity)
+bool EntrySearcher::isSearchResult(const QString& searchTerm,
+                                   const Entry* entry,
+                                   const Group* rootGroup,
+                                   Qt::CaseSensitivity caseSensitivity)
 {
+    if (!rootGroup->resolveSearchingEnabled()) {
+        return false;
+    }
+
+    QList<const Group*> path;
+    const Group* group = entry->group();
+    for (; group && group != rootGroup; group = group->parentGroup()) {
+        path.prepend(group);
+    }
+    if (group != rootGroup) {
+        return false;
+    }
+
+    // same order of checks as searchEntries(): a matching group returns all
+    // entries below it, a disabled one hides them
     const QStringList wordList = searchTerm.split(QRegExp("\\s"), QString::SkipEmptyParts);
+    for (const Group* pathGroup : asConst(path)) {
+        if (pathGroup->searchingEnabled() == Group::Disable) {
+            return false;
+        }
+        if (matchGroup(wordList, pathGroup, caseSensitivity)) {
+            return true;
+        }
+    }
+
+    return matchEntry(wordList, entry, caseSensitivity);
+}
+
+bool EntrySearcher::matchEntry(const QStringList& wordList, const Entry* entry, Qt::CaseSensitivity caseSensitivity)
+{
     for (const QString& word : wordList) {
         if (!wordMatch(word, entry, caseSensitivity)) {
-            return QList<Entry*>();
+            return false;
         }
     }
 
-    return QList<Entry*>() << entry;
+    return true;
 }
 
-bool EntrySearcher::wordMatch(const QString& word, Entry* entry, Qt::CaseSensitivity caseSensitivity)
+bool EntrySearcher::wordMatch(const QString& word, const Entry* entry, Qt::CaseSensitivity caseSensitivity)
 {
     return entry->resolvePlaceholder(entry->title()).contains(word, caseSensitivity)
            || entry->resolvePlaceholder(entry->username()).contains(word, caseSensitivity)
@@ -73,9 +108,8 @@ bool EntrySearcher::wordMatch(const QString& word, Entry* entry, Qt::CaseSensiti
            || entry->resolvePlaceholder(entry->notes()).contains(word, caseSensitivity);
 }
 
-bool EntrySearcher::matchGroup(const QString& searchTerm, const Group* group, Qt::CaseSensitivity caseSensitivity)
+bool EntrySearcher::matchGroup(const QStringList& wordList, const Group* group, Qt::CaseSensitivity caseSensitivity)
 {
-    const QStringList wordList = searchTerm.split(QRegExp("\\s"), QString::SkipEmptyParts);
     for (const QString& word : wordList) {
         if (!wordMatch(word, group, caseSensitivity)) {
             return false;
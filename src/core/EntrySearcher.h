@@ -20,6 +20,7 @@
 #define KEEPASSX_ENTRYSEARCHER_H
 
 #include <QString>
+#include <QStringList>
 
 class Group;
 class Entry;
@@ -28,12 +29,23 @@ class EntrySearcher
 {
 public:
     QList<Entry*> search(const QString& searchTerm, const Group* group, Qt::CaseSensitivity caseSensitivity);
+    /**
+     * Returns true if search() would return entry when searching the tree
+     * below rootGroup, without searching the rest of the tree.
+     */
+    bool isSearchResult(const QString& searchTerm,
+                        const Entry* entry,
+                        const Group* rootGroup,
+                        Qt::CaseSensitivity caseSensitivity);
 
 private:
-    QList<Entry*> searchEntries(const QString& searchTerm, const Group* group, Qt::CaseSensitivity caseSensitivity);
-    QList<Entry*> matchEntry(const QString& searchTerm, Entry* entry, Qt::CaseSensitivity caseSensitivity);
-    bool wordMatch(const QString& word, Entry* entry, Qt::CaseSensitivity caseSensitivity);
-    bool matchGroup(const QString& searchTerm, const Group* group, Qt::CaseSensitivity caseSensitivity);
+    void searchEntries(const QStringList& wordList,
+                       const Group* group,
+                       Qt::CaseSensitivity caseSensitivity,
+                       QList<Entry*>& searchResult);
+    bool matchEntry(const QStringList& wordList, const Entry* entry, Qt::CaseSensitivity caseSensitivity);
+    bool wordMatch(const QString& word, const Entry* entry, Qt::CaseSensitivity caseSensitivity);
+    bool matchGroup(const QStringList& wordList, const Group* group, Qt::CaseSensitivity caseSensitivity);
     bool wordMatch(const QString& word, const Group* group, Qt::CaseSensitivity caseSensitivity);
 };
 
@@ -21,7 +21,14 @@
 #include "core/Config.h"
 #include "core/DatabaseIcons.h"
 #include "core/Global.h"
+#include "core/HostIndex.h"
+#include "core/Merger.h"
 #include "core/Metadata.h"
+#include "core/PathIndex.h"
+
+#include <QAtomicInteger>
+#include <QVector>
+#include <algorithm>
 
 const int Group::DefaultIconNumber = 48;
 const int Group::RecycleBinIconNumber = 43;
@@ -32,9 +39,38 @@ Group::CloneFlags Group::DefaultCloneFlags =
 Entry::CloneFlags Group::DefaultEntryCloneFlags =
     static_cast<Entry::CloneFlags>(Entry::CloneNewUuid | Entry::CloneResetTimeInfo);
 
+static QAtomicInteger<quint64> s_nextRevision(1);
+
+/**
+ * Position of a group in a pre-order walk: the index of the group and of
+ * each of its ancestors among their siblings, from the top down.
+ */
+static QVector<int> treePosition(const Group* group)
+{
+    QVector<int> position;
+    for (; group->parentGroup(); group = group->parentGroup()) {
+        position.prepend(group->parentGroup()->children().indexOf(const_cast<Group*>(group)));
+    }
+    return position;
+}
+
+bool Group::GroupData::operator==(const GroupData& other) const
+{
+    return name == other.name && notes == other.notes && iconNumber == other.iconNumber
+           && customIcon == other.customIcon && timeInfo == other.timeInfo && isExpanded == other.isExpanded
+           && defaultAutoTypeSequence == other.defaultAutoTypeSequence && autoTypeEnabled == other.autoTypeEnabled
+           && searchingEnabled == other.searchingEnabled && mergeMode == other.mergeMode;
+}
+
+bool Group::GroupData::operator!=(const GroupData& other) const
+{
+    return !(*this == other);
+}
+
 Group::Group()
     : m_customData(new CustomData(this))
     , m_updateTimeinfo(true)
+    , m_revision(s_nextRevision.fetchAndAddRelaxed(1))
 {
     m_data.iconNumber = DefaultIconNumber;
     m_data.isExpanded = true;
@@ -44,6 +80,7 @@ Group::Group()
 
     connect(m_customData, SIGNAL(modified()), this, SIGNAL(modified()));
     connect(this, SIGNAL(modified()), SLOT(updateTimeinfo()));
+    connect(this, SIGNAL(modified()), SLOT(markDirty()));
 }
 
 Group::~Group()
@@ -105,6 +142,16 @@ void Group::setUpdateTimeinfo(bool value)
     m_updateTimeinfo = value;
 }
 
+quint64 Group::revision() const
+{
+    return m_revision;
+}
+
+void Group::markDirty()
+{
+    m_revision = s_nextRevision.fetchAndAddRelaxed(1);
+}
+
 Uuid Group::uuid() const
 {
     return m_uuid;
@@ -303,6 +350,7 @@ void Group::setIcon(const Uuid& uuid)
 void Group::setTimeInfo(const TimeInfo& timeInfo)
 {
     m_data.timeInfo = timeInfo;
+    markDirty();
 }
 
 void Group::setExpanded(bool expanded)
@@ -311,6 +359,7 @@ void Group::setExpanded(bool expanded)
         m_data.isExpanded = expanded;
         if (config()->get("IgnoreGroupExpansion").toBool()) {
             updateTimeinfo();
+            markDirty();
             return;
         }
         emit modified();
@@ -460,6 +509,17 @@ QStringList Group::hierarchy() const
     return hierarchy;
 }
 
+QString Group::path() const
+{
+    if (m_db) {
+        const QString path = m_db->pathIndex()->groupPath(this);
+        if (!path.isNull()) {
+            return path;
+        }
+    }
+    return m_parent ? m_parent->path() + m_data.name + "/" : QString("/");
+}
+
 Database* Group::database()
 {
     return m_db;
@@ -493,18 +553,15 @@ const QList<Entry*>& Group::entries() const
 QList<Entry*> Group::entriesRecursive(bool includeHistoryItems) const
 {
     QList<Entry*> entryList;
-
-    entryList.append(m_entries);
-
-    if (includeHistoryItems) {
-        for (Entry* entry : m_entries) {
-            entryList.append(entry->historyItems());
+    walkGroups([&entryList, includeHistoryItems](const Group* group) {
+        entryList.append(group->entries());
+        if (includeHistoryItems) {
+            for (const Entry* entry : group->entries()) {
+                entryList.append(entry->historyItems());
+            }
         }
-    }
-
-    for (Group* group : m_children) {
-        entryList.append(group->entriesRecursive(includeHistoryItems));
-    }
+        return false;
+    });
 
     return entryList;
 }
@@ -526,25 +583,42 @@ Entry* Group::findEntry(QString entryId)
         return entry;
     }
 
-    for (Entry* entry : entriesRecursive(false)) {
-        if (entry->title() == entryId) {
-            return entry;
-        }
+    PathIndex* index = rootPathIndex();
+    if (index) {
+        return index->entryByTitle(entryId);
     }
 
-    return nullptr;
+    entry = nullptr;
+    walkEntries([&entry, &entryId](Entry* candidate) {
+        if (candidate->title() == entryId) {
+            entry = candidate;
+            return true;
+        }
+        return false;
+    });
+
+    return entry;
 }
 
 Entry* Group::findEntryByUuid(const Uuid& uuid)
 {
     Q_ASSERT(!uuid.isNull());
-    for (Entry* entry : entriesRecursive(false)) {
-        if (entry->uuid() == uuid) {
-            return entry;
-        }
+
+    PathIndex* index = rootPathIndex();
+    if (index) {
+        return index->entryByUuid(uuid);
     }
 
-    return nullptr;
+    Entry* entry = nullptr;
+    walkEntries([&entry, &uuid](Entry* candidate) {
+        if (candidate->uuid() == uuid) {
+            entry = candidate;
+            return true;
+        }
+        return false;
+    });
+
+    return entry;
 }
 
 Entry* Group::findEntryByPath(QString entryPath, QString basePath)
@@ -552,6 +626,11 @@ Entry* Group::findEntryByPath(QString entryPath, QString basePath)
 
     Q_ASSERT(!entryPath.isNull());
 
+    PathIndex* index = rootPathIndex();
+    if (index && basePath.isEmpty()) {
+        return index->entryByPath(entryPath);
+    }
+
     for (Entry* entry : asConst(m_entries)) {
         QString currentEntryPath = basePath + entry->title();
         if (entryPath == currentEntryPath || entryPath == QString("/" + currentEntryPath)) {
@@ -574,25 +653,20 @@ Group* Group::findGroupByPath(QString groupPath, QString basePath)
 
     Q_ASSERT(!groupPath.isNull());
 
-    QStringList possiblePaths;
-    possiblePaths << groupPath;
-    if (!groupPath.startsWith("/")) {
-        possiblePaths << QString("/" + groupPath);
-    }
-    if (!groupPath.endsWith("/")) {
-        possiblePaths << QString(groupPath + "/");
-    }
-    if (!groupPath.endsWith("/") && !groupPath.endsWith("/")) {
-        possiblePaths << QString("/" + groupPath + "/");
+    PathIndex* index = rootPathIndex();
+    if (index && basePath == QLatin1String("/")) {
+        return index->groupByPath(groupPath);
     }
 
-    if (possiblePaths.contains(basePath)) {
+    // Base paths always have a leading and a trailing slash
+    const QString normalizedPath = PathIndex::normalizedGroupPath(groupPath);
+    if (normalizedPath == basePath) {
         return this;
     }
 
-    for (Group* innerGroup : children()) {
+    for (Group* innerGroup : asConst(m_children)) {
         QString innerBasePath = basePath + innerGroup->name() + "/";
-        Group* group = innerGroup->findGroupByPath(groupPath, innerBasePath);
+        Group* group = innerGroup->findGroupByPath(normalizedPath, innerBasePath);
         if (group != nullptr) {
             return group;
         }
@@ -629,13 +703,12 @@ QString Group::print(bool recursive, int depth)
 QList<const Group*> Group::groupsRecursive(bool includeSelf) const
 {
     QList<const Group*> groupList;
-    if (includeSelf) {
-        groupList.append(this);
-    }
-
-    for (const Group* group : m_children) {
-        groupList.append(group->groupsRecursive(true));
-    }
+    walkGroups(
+        [&groupList](const Group* group) {
+            groupList.append(group);
+            return false;
+        },
+        includeSelf);
 
     return groupList;
 }
@@ -643,13 +716,12 @@ QList<const Group*> Group::groupsRecursive(bool includeSelf) const
 QList<Group*> Group::groupsRecursive(bool includeSelf)
 {
     QList<Group*> groupList;
-    if (includeSelf) {
-        groupList.append(this);
-    }
-
-    for (Group* group : asConst(m_children)) {
-        groupList.append(group->groupsRecursive(true));
-    }
+    walkGroups(
+        [&groupList](Group* group) {
+            groupList.append(group);
+            return false;
+        },
+        includeSelf);
 
     return groupList;
 }
@@ -658,74 +730,29 @@ QSet<Uuid> Group::customIconsRecursive() const
 {
     QSet<Uuid> result;
 
-    if (!iconUuid().isNull()) {
-        result.insert(iconUuid());
-    }
-
-    const QList<Entry*> entryList = entriesRecursive(true);
-    for (Entry* entry : entryList) {
-        if (!entry->iconUuid().isNull()) {
-            result.insert(entry->iconUuid());
+    walkGroups([&result](const Group* group) {
+        if (!group->iconUuid().isNull()) {
+            result.insert(group->iconUuid());
         }
-    }
+        return false;
+    });
 
-    for (Group* group : m_children) {
-        result.unite(group->customIconsRecursive());
-    }
+    walkEntries(
+        [&result](const Entry* entry) {
+            if (!entry->iconUuid().isNull()) {
+                result.insert(entry->iconUuid());
+            }
+            return false;
+        },
+        true);
 
     return result;
 }
 
 void Group::merge(const Group* other)
 {
-
-    Group* rootGroup = this;
-    while (rootGroup->parentGroup()) {
-        rootGroup = rootGroup->parentGroup();
-    }
-
-    // merge entries
-    const QList<Entry*> dbEntries = other->entries();
-    for (Entry* entry : dbEntries) {
-
-        Entry* existingEntry = rootGroup->findEntryByUuid(entry->uuid());
-
-        if (!existingEntry) {
-            // This entry does not exist at all. Create it.
-            qDebug("New entry %s detected. Creating it.", qPrintable(entry->title()));
-            entry->clone(Entry::CloneIncludeHistory)->setGroup(this);
-        } else {
-            // Entry is already present in the database. Update it.
-            bool locationChanged = existingEntry->timeInfo().locationChanged() < entry->timeInfo().locationChanged();
-            if (locationChanged && existingEntry->group() != this) {
-                existingEntry->setGroup(this);
-                qDebug("Location changed for entry %s. Updating it", qPrintable(existingEntry->title()));
-            }
-            resolveEntryConflict(existingEntry, entry);
-        }
-    }
-
-    // merge groups recursively
-    const QList<Group*> dbChildren = other->children();
-    for (Group* group : dbChildren) {
-
-        Group* existingGroup = rootGroup->findChildByUuid(group->uuid());
-
-        if (!existingGroup) {
-            qDebug("New group %s detected. Creating it.", qPrintable(group->name()));
-            Group* newGroup = group->clone(Entry::CloneNoFlags, Group::CloneNoFlags);
-            newGroup->setParent(this);
-            newGroup->merge(group);
-        } else {
-            bool locationChanged = existingGroup->timeInfo().locationChanged() < group->timeInfo().locationChanged();
-            if (locationChanged && existingGroup->parent() != this) {
-                existingGroup->setParent(this);
-                qDebug("Location changed for group %s. Updating it", qPrintable(existingGroup->name()));
-            }
-            resolveGroupConflict(existingGroup, group);
-            existingGroup->merge(group);
-        }
-    }
+    Merger merger(other, this);
+    merger.merge();
 
     emit modified();
 }
@@ -733,13 +760,17 @@ void Group::merge(const Group* other)
 Group* Group::findChildByUuid(const Uuid& uuid)
 {
     Q_ASSERT(!uuid.isNull());
-    for (Group* group : groupsRecursive(true)) {
-        if (group->uuid() == uuid) {
-            return group;
+
+    Group* group = nullptr;
+    walkGroups([&group, &uuid](Group* candidate) {
+        if (candidate->uuid() == uuid) {
+            group = candidate;
+            return true;
         }
-    }
+        return false;
+    });
 
-    return nullptr;
+    return group;
 }
 
 Group* Group::findChildByName(const QString& name)
@@ -800,6 +831,42 @@ void Group::copyDataFrom(const Group* other)
     m_data = other->m_data;
     m_customData->copyDataFrom(other->m_customData);
     m_lastTopVisibleEntry = other->m_lastTopVisibleEntry;
+    markDirty();
+}
+
+void Group::syncDataFrom(const Group* other)
+{
+    m_data = other->m_data;
+    m_customData->copyDataFrom(other->m_customData);
+
+    // the time info was copied from other, don't touch it
+    const bool updateTimeinfo = m_updateTimeinfo;
+    m_updateTimeinfo = false;
+    emit modified();
+    m_updateTimeinfo = updateTimeinfo;
+    emit dataChanged(this);
+}
+
+bool Group::equals(const Group* other) const
+{
+    return other && m_uuid == other->m_uuid && m_data == other->m_data && *m_customData == *other->m_customData;
+}
+
+bool Group::walkOrderLessThan(const Group* a, const Group* b)
+{
+    const QVector<int> positionA = treePosition(a);
+    const QVector<int> positionB = treePosition(b);
+    return std::lexicographical_compare(positionA.begin(), positionA.end(), positionB.begin(), positionB.end());
+}
+
+bool Group::walkOrderLessThan(const Entry* a, const Entry* b)
+{
+    // the entries of a group are visited before those of its children
+    if (a->group() == b->group()) {
+        return a->group()->entries().indexOf(const_cast<Entry*>(a))
+               < b->group()->entries().indexOf(const_cast<Entry*>(b));
+    }
+    return walkOrderLessThan(a->group(), b->group());
 }
 
 void Group::addEntry(Entry* entry)
@@ -813,6 +880,8 @@ void Group::addEntry(Entry* entry)
     connect(entry, SIGNAL(dataChanged(Entry*)), SIGNAL(entryDataChanged(Entry*)));
     if (m_db) {
         connect(entry, SIGNAL(modified()), m_db, SIGNAL(modifiedImmediate()));
+        m_db->pathIndex()->addEntry(entry);
+        m_db->hostIndex()->addEntry(entry);
     }
 
     emit modified();
@@ -828,6 +897,8 @@ void Group::removeEntry(Entry* entry)
     entry->disconnect(this);
     if (m_db) {
         entry->disconnect(m_db);
+        m_db->pathIndex()->removeEntry(entry);
+        m_db->hostIndex()->removeEntry(entry);
     }
     m_entries.removeAll(entry);
     emit modified();
@@ -844,6 +915,7 @@ void Group::recSetDatabase(Database* db)
         disconnect(SIGNAL(added()), m_db);
         disconnect(SIGNAL(aboutToMove(Group*, Group*, int)), m_db);
         disconnect(SIGNAL(moved()), m_db);
+        disconnect(SIGNAL(entryDataChanged(Entry*)), m_db);
         disconnect(SIGNAL(modified()), m_db);
     }
 
@@ -864,6 +936,7 @@ void Group::recSetDatabase(Database* db)
         connect(this, SIGNAL(added()), db, SIGNAL(groupAdded()));
         connect(this, SIGNAL(aboutToMove(Group*, Group*, int)), db, SIGNAL(groupAboutToMove(Group*, Group*, int)));
         connect(this, SIGNAL(moved()), db, SIGNAL(groupMoved()));
+        connect(this, SIGNAL(entryDataChanged(Entry*)), db, SIGNAL(entryDataChanged(Entry*)));
         connect(this, SIGNAL(modified()), db, SIGNAL(modifiedImmediate()));
     }
 
@@ -898,12 +971,6 @@ void Group::recCreateDelObjects()
     }
 }
 
-void Group::markOlderEntry(Entry* entry)
-{
-    entry->attributes()->set(
-        "merged", tr("older entry merged from database \"%1\"").arg(entry->group()->database()->metadata()->name()));
-}
-
 bool Group::resolveSearchingEnabled() const
 {
     switch (m_data.searchingEnabled) {
@@ -942,82 +1009,38 @@ bool Group::resolveAutoTypeEnabled() const
     }
 }
 
-void Group::resolveEntryConflict(Entry* existingEntry, Entry* otherEntry)
-{
-    const QDateTime timeExisting = existingEntry->timeInfo().lastModificationTime();
-    const QDateTime timeOther = otherEntry->timeInfo().lastModificationTime();
-
-    Entry* clonedEntry;
-
-    switch (mergeMode()) {
-    case KeepBoth:
-        // if one entry is newer, create a clone and add it to the group
-        if (timeExisting > timeOther) {
-            clonedEntry = otherEntry->clone(Entry::CloneNewUuid | Entry::CloneIncludeHistory);
-            clonedEntry->setGroup(this);
-            markOlderEntry(clonedEntry);
-        } else if (timeExisting < timeOther) {
-            clonedEntry = otherEntry->clone(Entry::CloneNewUuid | Entry::CloneIncludeHistory);
-            clonedEntry->setGroup(this);
-            markOlderEntry(existingEntry);
-        }
-        break;
-    case KeepNewer:
-        if (timeExisting < timeOther) {
-            qDebug("Updating entry %s.", qPrintable(existingEntry->title()));
-            // only if other entry is newer, replace existing one
-            Group* currentGroup = existingEntry->group();
-            currentGroup->removeEntry(existingEntry);
-            otherEntry->clone(Entry::CloneIncludeHistory)->setGroup(currentGroup);
-        }
-
-        break;
-    case KeepExisting:
-        break;
-    default:
-        // do nothing
-        break;
-    }
-}
-
-void Group::resolveGroupConflict(Group* existingGroup, Group* otherGroup)
-{
-    const QDateTime timeExisting = existingGroup->timeInfo().lastModificationTime();
-    const QDateTime timeOther = otherGroup->timeInfo().lastModificationTime();
-
-    // only if the other group is newer, update the existing one.
-    if (timeExisting < timeOther) {
-        qDebug("Updating group %s.", qPrintable(existingGroup->name()));
-        existingGroup->setName(otherGroup->name());
-        existingGroup->setNotes(otherGroup->notes());
-        if (otherGroup->iconNumber() == 0) {
-            existingGroup->setIcon(otherGroup->iconUuid());
-        } else {
-            existingGroup->setIcon(otherGroup->iconNumber());
-        }
-        existingGroup->setExpiryTime(otherGroup->timeInfo().expiryTime());
-    }
-}
-
 QStringList Group::locate(QString locateTerm, QString currentPath)
 {
     Q_ASSERT(!locateTerm.isNull());
     QStringList response;
+    locate(locateTerm.toLower(), currentPath, response);
+    return response;
+}
 
-    for (Entry* entry : asConst(m_entries)) {
+void Group::locate(const QString& lowerLocateTerm, const QString& currentPath, QStringList& response) const
+{
+    for (const Entry* entry : m_entries) {
         QString entryPath = currentPath + entry->title();
-        if (entryPath.toLower().contains(locateTerm.toLower())) {
+        if (entryPath.toLower().contains(lowerLocateTerm)) {
             response << entryPath;
         }
     }
 
-    for (Group* group : asConst(m_children)) {
-        for (QString path : group->locate(locateTerm, currentPath + group->name() + QString("/"))) {
-            response << path;
-        }
+    for (const Group* group : m_children) {
+        group->locate(lowerLocateTerm, currentPath + group->name() + QString("/"), response);
     }
+}
 
-    return response;
+/**
+ * Returns the path index of the database if this is its root group.
+ * Lookups relative to other groups are resolved by walking the tree.
+ */
+PathIndex* Group::rootPathIndex() const
+{
+    if (m_db && m_db->rootGroup() == this) {
+        return m_db->pathIndex();
+    }
+    return nullptr;
 }
 
 Entry* Group::addEntryWithPath(QString entryPath)
@@ -1043,6 +1066,7 @@ Entry* Group::addEntryWithPath(QString entryPath)
     Entry* entry = new Entry();
     entry->setTitle(entryTitle);
     entry->setUuid(Uuid::random());
+
     entry->setGroup(group);
 
     return entry;
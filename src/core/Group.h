@@ -27,9 +27,12 @@
 #include "core/CustomData.h"
 #include "core/Database.h"
 #include "core/Entry.h"
+#include "core/Global.h"
 #include "core/TimeInfo.h"
 #include "core/Uuid.h"
 
+class PathIndex;
+
 class Group : public QObject
 {
     Q_OBJECT
@@ -70,6 +73,9 @@ public:
         Group::TriState autoTypeEnabled;
         Group::TriState searchingEnabled;
         Group::MergeMode mergeMode;
+
+        bool operator==(const GroupData& other) const;
+        bool operator!=(const GroupData& other) const;
     };
 
     Group();
@@ -130,10 +136,22 @@ public:
 
     void setUpdateTimeinfo(bool value);
 
+    /**
+     * Serial number that changes whenever the group's own data (excluding
+     * its entries and children) written to the database file changes.
+     */
+    quint64 revision() const;
+
     Group* parentGroup();
     const Group* parentGroup() const;
     void setParent(Group* parent, int index = -1);
     QStringList hierarchy() const;
+    /**
+     * Returns the path of the group with leading and trailing slash, "/" for
+     * the root group. Paths of groups in a database are cached by its path
+     * index, so listing every entry doesn't rebuild them.
+     */
+    QString path() const;
 
     Database* database();
     const Database* database() const;
@@ -145,6 +163,33 @@ public:
     QList<const Group*> groupsRecursive(bool includeSelf) const;
     QList<Group*> groupsRecursive(bool includeSelf);
     QSet<Uuid> customIconsRecursive() const;
+
+    /**
+     * Visit all entries of this group and its descendants depth-first
+     * without building intermediate lists.
+     * The visitor is called with an Entry*, or a const Entry* for a const
+     * group, and returns true to stop the traversal. Entries and groups
+     * must not be added, moved or removed while walking the tree.
+     *
+     * @return true if the visitor stopped the traversal
+     */
+    template <typename Visitor> bool walkEntries(Visitor&& visitor, bool includeHistoryItems = false);
+    template <typename Visitor> bool walkEntries(Visitor&& visitor, bool includeHistoryItems = false) const;
+    /**
+     * Visit this group (optionally) and all of its descendants in pre-order.
+     * The visitor returns true to stop the traversal.
+     *
+     * @return true if the visitor stopped the traversal
+     */
+    template <typename Visitor> bool walkGroups(Visitor&& visitor, bool includeSelf = true);
+    template <typename Visitor> bool walkGroups(Visitor&& visitor, bool includeSelf = true) const;
+    /**
+     * Returns true if group a comes before group b in walkGroups(), or
+     * entry a before entry b in walkEntries(). Both have to belong to the
+     * same tree.
+     */
+    static bool walkOrderLessThan(const Group* a, const Group* b);
+    static bool walkOrderLessThan(const Entry* a, const Entry* b);
     /**
      * Creates a duplicate of this group.
      * Note that you need to copy the custom icons manually when inserting the
@@ -154,6 +199,18 @@ public:
                  CloneFlags groupFlags = DefaultCloneFlags) const;
 
     void copyDataFrom(const Group* other);
+    /**
+     * Replaces the data of this group with the one of other, e.g. a newer
+     * copy of the same group, and emits modified() and dataChanged().
+     * Unlike copyDataFrom() the last top visible entry is kept, it is view
+     * state that refers to entries of this database.
+     */
+    void syncDataFrom(const Group* other);
+    /**
+     * Returns true if this group and other hold the same uuid and data.
+     * Entries, children and the parent group are not compared.
+     */
+    bool equals(const Group* other) const;
     void merge(const Group* other);
     QString print(bool recursive = false, int depth = 0);
 
@@ -181,6 +238,7 @@ signals:
 
 private slots:
     void updateTimeinfo();
+    void markDirty();
 
 private:
     template <class P, class V> bool set(P& property, const V& value);
@@ -188,9 +246,9 @@ private:
     void addEntry(Entry* entry);
     void removeEntry(Entry* entry);
     void setParent(Database* db);
-    void markOlderEntry(Entry* entry);
-    void resolveEntryConflict(Entry* existingEntry, Entry* otherEntry);
-    void resolveGroupConflict(Group* existingGroup, Group* otherGroup);
+
+    void locate(const QString& lowerLocateTerm, const QString& currentPath, QStringList& response) const;
+    PathIndex* rootPathIndex() const;
 
     void recSetDatabase(Database* db);
     void cleanupParent();
@@ -208,12 +266,98 @@ private:
     QPointer<Group> m_parent;
 
     bool m_updateTimeinfo;
+    quint64 m_revision;
 
     friend void Database::setRootGroup(Group* group);
     friend Entry::~Entry();
     friend void Entry::setGroup(Group* group);
+    friend class Merger;
 };
 
 Q_DECLARE_OPERATORS_FOR_FLAGS(Group::CloneFlags)
 
+template <typename Visitor> bool Group::walkEntries(Visitor&& visitor, bool includeHistoryItems)
+{
+    for (Entry* entry : asConst(m_entries)) {
+        if (visitor(entry)) {
+            return true;
+        }
+    }
+
+    if (includeHistoryItems) {
+        for (Entry* entry : asConst(m_entries)) {
+            for (Entry* historyItem : entry->historyItems()) {
+                if (visitor(historyItem)) {
+                    return true;
+                }
+            }
+        }
+    }
+
+    for (Group* group : asConst(m_children)) {
+        if (group->walkEntries(visitor, includeHistoryItems)) {
+            return true;
+        }
+    }
+
+    return false;
+}
+
+template <typename Visitor> bool Group::walkEntries(Visitor&& visitor, bool includeHistoryItems) const
+{
+    for (const Entry* entry : m_entries) {
+        if (visitor(entry)) {
+            return true;
+        }
+    }
+
+    if (includeHistoryItems) {
+        for (const Entry* entry : m_entries) {
+            for (const Entry* historyItem : entry->historyItems()) {
+                if (visitor(historyItem)) {
+                    return true;
+                }
+            }
+        }
+    }
+
+    for (const Group* group : m_children) {
+        if (group->walkEntries(visitor, includeHistoryItems)) {
+            return true;
+        }
+    }
+
+    return false;
+}
+
+template <typename Visitor> bool Group::walkGroups(Visitor&& visitor, bool includeSelf)
+{
+    if (includeSelf && visitor(this)) {
+        return true;
+    }
+
+    for (Group* group : asConst(m_children)) {
+        if (group->walkGroups(visitor, true)) {
+            return true;
+        }
+    }
+
+    return false;
+}
+
+template <typename Visitor> bool Group::walkGroups(Visitor&& visitor, bool includeSelf) const
+{
+    if (includeSelf && visitor(this)) {
+        return true;
+    }
+
+    for (const Group* group : m_children) {
+        if (group->walkGroups(visitor, true)) {
+            return true;
+        }
+    }
+
+    return false;
+}
+
 #endif // KEEPASSX_GROUP_H
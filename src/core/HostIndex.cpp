@@ -0,0 +1,180 @@
+/*
+ *  Copyright (C) 2018 KeePassXC Team <team@keepassxc.org>
+ *
+ *  This program is free software: you can redistribute it and/or modify
+ *  it under the terms of the GNU General Public License as published by
+ *  the Free Software Foundation, either version 2 or (at your option)
+ *  version 3 of the License.
+ *
+ *  This program is distributed in the hope that it will be useful,
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *  GNU General Public License for more details.
+ *
+ *  You should have received a copy of the GNU General Public License
+ *  along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#include "HostIndex.h"
+
+#include <QMutexLocker>
+#include <QSet>
+#include <QUrl>
+#include <algorithm>
+
+#include "core/Database.h"
+#include "core/Entry.h"
+#include "core/EntrySearcher.h"
+#include "core/Global.h"
+#include "core/Group.h"
+
+HostIndex::HostIndex(Database* db)
+    : m_db(db)
+    , m_valid(false)
+{
+    connect(db, SIGNAL(groupAdded()), SLOT(invalidate()));
+    connect(db, SIGNAL(groupRemoved()), SLOT(invalidate()));
+    connect(db, SIGNAL(entryDataChanged(Entry*)), SLOT(updateEntry(Entry*)));
+}
+
+bool HostIndex::isValid() const
+{
+    QMutexLocker locker(&m_mutex);
+    return m_valid;
+}
+
+void HostIndex::invalidate()
+{
+    QMutexLocker locker(&m_mutex);
+    m_valid = false;
+}
+
+QList<Entry*> HostIndex::entries(const QString& hostname)
+{
+    QSet<Entry*> candidates;
+    {
+        QMutexLocker locker(&m_mutex);
+        ensureValid();
+
+        // Title or URL that is part of the host name
+        for (int start = 0; start < hostname.size(); ++start) {
+            for (int length = 1; start + length <= hostname.size(); ++length) {
+                for (Entry* entry : m_entriesByValue.values(hostname.mid(start, length))) {
+                    candidates.insert(entry);
+                }
+            }
+        }
+        // Title or URL with a scheme whose host the host name ends with
+        for (int start = 0; start <= hostname.size(); ++start) {
+            for (Entry* entry : m_entriesByHost.values(hostname.mid(start))) {
+                candidates.insert(entry);
+            }
+        }
+    }
+
+    // the entries themselves are guarded by the caller, concurrent lookups only share the tables
+    QList<Entry*> result;
+    EntrySearcher searcher;
+    for (Entry* entry : asConst(candidates)) {
+        if (searcher.isSearchResult(hostname, entry, m_db->rootGroup(), Qt::CaseInsensitive)) {
+            result.append(entry);
+        }
+    }
+    std::sort(result.begin(), result.end(), [](const Entry* a, const Entry* b) {
+        return Group::walkOrderLessThan(a, b);
+    });
+
+    return result;
+}
+
+void HostIndex::addEntry(Entry* entry)
+{
+    QMutexLocker locker(&m_mutex);
+    if (m_valid) {
+        insertEntry(entry);
+    }
+}
+
+void HostIndex::removeEntry(Entry* entry)
+{
+    QMutexLocker locker(&m_mutex);
+    if (m_valid) {
+        removeEntryKeys(entry);
+    }
+}
+
+/**
+ * Re-keys an entry whose title or URL may have changed.
+ */
+void HostIndex::updateEntry(Entry* entry)
+{
+    QMutexLocker locker(&m_mutex);
+    if (!m_valid || !m_entryKeys.contains(entry)) {
+        return;
+    }
+
+    const EntryKeys& keys = m_entryKeys[entry];
+    if (keys.title == entry->title() && keys.url == entry->url()) {
+        return;
+    }
+
+    removeEntryKeys(entry);
+    insertEntry(entry);
+}
+
+void HostIndex::ensureValid()
+{
+    if (m_valid) {
+        return;
+    }
+
+    m_entryKeys.clear();
+    m_entriesByValue.clear();
+    m_entriesByHost.clear();
+
+    if (m_db->rootGroup()) {
+        m_db->rootGroup()->walkEntries([this](Entry* entry) {
+            insertEntry(entry);
+            return false;
+        });
+    }
+    m_valid = true;
+}
+
+void HostIndex::insertEntry(Entry* entry)
+{
+    EntryKeys keys;
+    keys.title = entry->title();
+    keys.url = entry->url();
+
+    for (const QString& value : {keys.title, keys.url}) {
+        // host names contain no whitespace, this skips titles like "My Bank"
+        if (!value.isEmpty() && !value.contains(QRegExp("\\s"))) {
+            keys.values.append(value);
+            m_entriesByValue.insert(value, entry);
+        }
+
+        QUrl url(value);
+        if (!url.scheme().isEmpty()) {
+            keys.hosts.append(url.host());
+            m_entriesByHost.insert(url.host(), entry);
+        }
+    }
+
+    m_entryKeys.insert(entry, keys);
+}
+
+void HostIndex::removeEntryKeys(Entry* entry)
+{
+    if (!m_entryKeys.contains(entry)) {
+        return;
+    }
+
+    const EntryKeys keys = m_entryKeys.take(entry);
+    for (const QString& value : keys.values) {
+        m_entriesByValue.remove(value, entry);
+    }
+    for (const QString& host : keys.hosts) {
+        m_entriesByHost.remove(host, entry);
+    }
+}
@@ -0,0 +1,100 @@
+/*
+ *  Copyright (C) 2018 KeePassXC Team <team@keepassxc.org>
+ *
+ *  This program is free software: you can redistribute it and/or modify
+ *  it under the terms of the GNU General Public License as published by
+ *  the Free Software Foundation, either version 2 or (at your option)
+ *  version 3 of the License.
+ *
+ *  This program is distributed in the hope that it will be useful,
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *  GNU General Public License for more details.
+ *
+ *  You should have received a copy of the GNU General Public License
+ *  along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#ifndef KEEPASSX_HOSTINDEX_H
+#define KEEPASSX_HOSTINDEX_H
+
+#include <QHash>
+#include <QList>
+#include <QMutex>
+#include <QObject>
+#include <QString>
+#include <QStringList>
+
+class Database;
+class Entry;
+class Group;
+
+/**
+ * Lookup table for the entries the browser integration offers for a host
+ * name.
+ *
+ * An entry matches a host name if searching the database for the host
+ * name finds it (see EntrySearcher) and either its Title or URL is part of
+ * the host name, or its Title or URL has a scheme and the host name ends
+ * with their host. The index maps every Title and URL, and the host of
+ * those with a scheme, to their entries; a lookup lets through only the
+ * substrings and suffixes of the host name and then runs the search check
+ * on the few remaining entries. Searching flags and group names are thus
+ * always evaluated at lookup time.
+ *
+ * The index is built on first use and then kept up to date like
+ * PathIndex: added, removed and edited entries update only their own
+ * keys, adding or removing groups drops the index. Lookups may happen on
+ * several threads at once as long as the database is not modified
+ * meanwhile, see DatabaseAccess.
+ */
+class HostIndex : public QObject
+{
+    Q_OBJECT
+
+public:
+    explicit HostIndex(Database* db);
+
+    bool isValid() const;
+
+    /**
+     * Returns the matching entries in tree order. Parent domains have to be
+     * looked up separately.
+     */
+    QList<Entry*> entries(const QString& hostname);
+
+    /**
+     * Called by Group when an entry was added to or is removed from a
+     * group of the database.
+     */
+    void addEntry(Entry* entry);
+    void removeEntry(Entry* entry);
+
+public slots:
+    void invalidate();
+
+private slots:
+    void updateEntry(Entry* entry);
+
+private:
+    struct EntryKeys
+    {
+        QString title;
+        QString url;
+        QStringList values;
+        QStringList hosts;
+    };
+
+    void ensureValid();
+    void insertEntry(Entry* entry);
+    void removeEntryKeys(Entry* entry);
+
+    Database* const m_db;
+    mutable QMutex m_mutex;
+    bool m_valid;
+    QHash<Entry*, EntryKeys> m_entryKeys;
+    QMultiHash<QString, Entry*> m_entriesByValue;
+    QMultiHash<QString, Entry*> m_entriesByHost;
+};
+
+#endif // KEEPASSX_HOSTINDEX_H
@@ -0,0 +1,428 @@
+/*
+ *  Copyright (C) 2018 KeePassXC Team <team@keepassxc.org>
+ *
+ *  This program is free software: you can redistribute it and/or modify
+ *  it under the terms of the GNU General Public License as published by
+ *  the Free Software Foundation, either version 2 or (at your option)
+ *  version 3 of the License.
+ *
+ *  This program is distributed in the hope that it will be useful,
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *  GNU General Public License for more details.
+ *
+ *  You should have received a copy of the GNU General Public License
+ *  along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#include "Merger.h"
+
+#include <QElapsedTimer>
+#include <QSet>
+
+#include "core/Database.h"
+#include "core/Entry.h"
+#include "core/Metadata.h"
+
+bool Merger::ChangeSet::isEmpty() const
+{
+    return changes.isEmpty();
+}
+
+int Merger::ChangeSet::count(ChangeType type) const
+{
+    int result = 0;
+    for (const Change& change : changes) {
+        if (change.type == type) {
+            ++result;
+        }
+    }
+    return result;
+}
+
+Merger::Merger(const Database* sourceDb, Database* targetDb)
+    : m_sourceDb(sourceDb)
+    , m_targetDb(targetDb)
+    , m_sourceGroup(sourceDb->rootGroup())
+    , m_targetGroup(targetDb->rootGroup())
+    , m_targetRootGroup(targetDb->rootGroup())
+{
+}
+
+/**
+ * Merge a single group. Entries and groups of the source are matched
+ * against the whole tree the target group belongs to.
+ */
+Merger::Merger(const Group* sourceGroup, Group* targetGroup)
+    : m_sourceDb(nullptr)
+    , m_targetDb(nullptr)
+    , m_sourceGroup(sourceGroup)
+    , m_targetGroup(targetGroup)
+    , m_targetRootGroup(targetGroup)
+{
+    while (m_targetRootGroup->parentGroup()) {
+        m_targetRootGroup = m_targetRootGroup->parentGroup();
+    }
+}
+
+/**
+ * Compute the changes merging the source into the target would make.
+ * The target is not modified. The returned change set refers to nodes
+ * of the source, which must not change before the set is applied.
+ */
+Merger::ChangeSet Merger::plan()
+{
+    ChangeSet changeSet;
+    QElapsedTimer timer;
+
+    timer.start();
+    indexTarget();
+    changeSet.indexTime = timer.nsecsElapsed();
+
+    timer.restart();
+    m_plannedEntryGroups.clear();
+    m_plannedGroupParents.clear();
+    m_plannedGroupModes.clear();
+
+    for (auto it = m_targetEntries.constBegin(); it != m_targetEntries.constEnd(); ++it) {
+        m_plannedEntryGroups.insert(it.key(), it.value()->group()->uuid());
+    }
+    for (auto it = m_targetGroups.constBegin(); it != m_targetGroups.constEnd(); ++it) {
+        const Group* group = it.value();
+        m_plannedGroupParents.insert(it.key(), group->parentGroup() ? group->parentGroup()->uuid() : Uuid());
+        m_plannedGroupModes.insert(it.key(), group->m_data.mergeMode);
+    }
+
+    planGroup(m_targetGroup->uuid(), m_sourceGroup, changeSet);
+    if (m_sourceDb && m_targetDb) {
+        planMetadata(changeSet);
+    }
+    changeSet.planTime = timer.nsecsElapsed();
+
+    return changeSet;
+}
+
+/**
+ * Carry out a change set computed by plan(). Either all changes are
+ * applied or, if the target no longer contains the nodes the set refers
+ * to, none of them and false is returned.
+ */
+bool Merger::apply(ChangeSet& changeSet)
+{
+    QElapsedTimer timer;
+    timer.start();
+
+    indexTarget();
+    if (!isApplicable(changeSet)) {
+        return false;
+    }
+
+    for (const Change& change : asConst(changeSet.changes)) {
+        applyChange(change);
+    }
+
+    m_targetEntries.clear();
+    m_targetGroups.clear();
+
+    changeSet.applyTime = timer.nsecsElapsed();
+    return true;
+}
+
+Merger::ChangeSet Merger::merge()
+{
+    ChangeSet changeSet = plan();
+    apply(changeSet);
+    return changeSet;
+}
+
+void Merger::indexTarget()
+{
+    m_targetEntries.clear();
+    m_targetGroups.clear();
+
+    // keep the first node in tree order for duplicate uuids, like the tree lookups do
+    m_targetRootGroup->walkGroups([this](Group* group) {
+        if (!m_targetGroups.contains(group->uuid())) {
+            m_targetGroups.insert(group->uuid(), group);
+        }
+        return false;
+    });
+
+    m_targetRootGroup->walkEntries([this](Entry* entry) {
+        if (!m_targetEntries.contains(entry->uuid())) {
+            m_targetEntries.insert(entry->uuid(), entry);
+        }
+        return false;
+    });
+}
+
+void Merger::planGroup(const Uuid& targetGroupUuid, const Group* sourceGroup, ChangeSet& changeSet)
+{
+    // merge entries
+    for (const Entry* entry : sourceGroup->entries()) {
+        Change change;
+        change.uuid = entry->uuid();
+        change.targetGroupUuid = targetGroupUuid;
+        change.sourceEntry = entry;
+        change.sourceGroup = nullptr;
+        change.existingIsOlder = false;
+
+        if (!m_plannedEntryGroups.contains(entry->uuid())) {
+            // This entry does not exist at all. Create it.
+            change.type = EntryAdded;
+            changeSet.changes.append(change);
+            m_plannedEntryGroups.insert(entry->uuid(), targetGroupUuid);
+            continue;
+        }
+
+        // An entry added earlier in this merge is identical to the source entry
+        const Entry* existingEntry = m_targetEntries.value(entry->uuid());
+        if (!existingEntry) {
+            continue;
+        }
+
+        // Entry is already present in the database. Update it.
+        bool locationChanged = existingEntry->timeInfo().locationChanged() < entry->timeInfo().locationChanged();
+        if (locationChanged && m_plannedEntryGroups.value(entry->uuid()) != targetGroupUuid) {
+            change.type = EntryMoved;
+            changeSet.changes.append(change);
+            m_plannedEntryGroups.insert(entry->uuid(), targetGroupUuid);
+        }
+        planEntryConflict(targetGroupUuid, existingEntry, entry, changeSet);
+    }
+
+    // merge groups recursively
+    for (const Group* group : sourceGroup->children()) {
+        Change change;
+        change.uuid = group->uuid();
+        change.targetGroupUuid = targetGroupUuid;
+        change.sourceEntry = nullptr;
+        change.sourceGroup = group;
+        change.existingIsOlder = false;
+
+        if (!m_plannedGroupParents.contains(group->uuid())) {
+            change.type = GroupAdded;
+            changeSet.changes.append(change);
+            m_plannedGroupParents.insert(group->uuid(), targetGroupUuid);
+            m_plannedGroupModes.insert(group->uuid(), group->m_data.mergeMode);
+            planGroup(group->uuid(), group, changeSet);
+            continue;
+        }
+
+        const Group* existingGroup = m_targetGroups.value(group->uuid());
+        if (existingGroup) {
+            bool locationChanged = existingGroup->timeInfo().locationChanged() < group->timeInfo().locationChanged();
+            if (locationChanged && m_plannedGroupParents.value(group->uuid()) != targetGroupUuid) {
+                change.type = GroupMoved;
+                changeSet.changes.append(change);
+                m_plannedGroupParents.insert(group->uuid(), targetGroupUuid);
+            }
+
+            // only if the other group is newer, update the existing one.
+            if (existingGroup->timeInfo().lastModificationTime() < group->timeInfo().lastModificationTime()) {
+                change.type = GroupUpdated;
+                changeSet.changes.append(change);
+            }
+        }
+        planGroup(group->uuid(), group, changeSet);
+    }
+}
+
+void Merger::planEntryConflict(const Uuid& targetGroupUuid,
+                               const Entry* existingEntry,
+                               const Entry* otherEntry,
+                               ChangeSet& changeSet)
+{
+    const QDateTime timeExisting = existingEntry->timeInfo().lastModificationTime();
+    const QDateTime timeOther = otherEntry->timeInfo().lastModificationTime();
+
+    Change change;
+    change.uuid = otherEntry->uuid();
+    change.targetGroupUuid = targetGroupUuid;
+    change.sourceEntry = otherEntry;
+    change.sourceGroup = nullptr;
+    change.existingIsOlder = timeExisting < timeOther;
+
+    switch (plannedMergeMode(targetGroupUuid)) {
+    case Group::KeepBoth:
+        // if one entry is newer, create a clone and add it to the group
+        if (timeExisting != timeOther) {
+            change.type = EntryDuplicated;
+            changeSet.changes.append(change);
+        }
+        break;
+    case Group::KeepNewer:
+        // only if other entry is newer, replace existing one
+        if (change.existingIsOlder) {
+            change.type = EntryUpdated;
+            changeSet.changes.append(change);
+        }
+        break;
+    case Group::KeepExisting:
+        break;
+    default:
+        // do nothing
+        break;
+    }
+}
+
+void Merger::planMetadata(ChangeSet& changeSet)
+{
+    const QList<Uuid> customIconIds = m_sourceDb->metadata()->customIcons().keys();
+    for (const Uuid& customIconId : customIconIds) {
+        if (!m_targetDb->metadata()->containsCustomIcon(customIconId)) {
+            Change change;
+            change.type = CustomIconAdded;
+            change.uuid = customIconId;
+            change.sourceEntry = nullptr;
+            change.sourceGroup = nullptr;
+            change.existingIsOlder = false;
+            changeSet.changes.append(change);
+        }
+    }
+}
+
+/**
+ * Resolve the merge mode of a group using the parents it will have
+ * after the changes planned so far.
+ */
+Group::MergeMode Merger::plannedMergeMode(Uuid groupUuid) const
+{
+    while (!groupUuid.isNull()) {
+        Group::MergeMode mode = m_plannedGroupModes.value(groupUuid, Group::ModeInherit);
+        if (mode != Group::ModeInherit) {
+            return mode;
+        }
+        groupUuid = m_plannedGroupParents.value(groupUuid);
+    }
+
+    return Group::KeepNewer; // fallback
+}
+
+bool Merger::isApplicable(const ChangeSet& changeSet) const
+{
+    QSet<Uuid> addedGroups;
+
+    for (const Change& change : changeSet.changes) {
+        switch (change.type) {
+        case EntryAdded:
+        case EntryDuplicated:
+        case GroupAdded:
+        case EntryMoved:
+        case GroupMoved:
+            if (!m_targetGroups.contains(change.targetGroupUuid) && !addedGroups.contains(change.targetGroupUuid)) {
+                return false;
+            }
+            break;
+        default:
+            break;
+        }
+
+        switch (change.type) {
+        case EntryMoved:
+        case EntryUpdated:
+        case EntryDuplicated:
+            if (!m_targetEntries.contains(change.uuid)) {
+                return false;
+            }
+            break;
+        case GroupMoved:
+        case GroupUpdated:
+            if (!m_targetGroups.contains(change.uuid)) {
+                return false;
+            }
+            break;
+        case GroupAdded:
+            addedGroups.insert(change.uuid);
+            break;
+        case CustomIconAdded:
+            if (!m_sourceDb || !m_targetDb || m_targetDb->metadata()->containsCustomIcon(change.uuid)) {
+                return false;
+            }
+            break;
+        default:
+            break;
+        }
+    }
+
+    return true;
+}
+
+void Merger::applyChange(const Change& change)
+{
+    Group* targetGroup = m_targetGroups.value(change.targetGroupUuid);
+
+    switch (change.type) {
+    case EntryAdded: {
+        qDebug("New entry %s detected. Creating it.", qPrintable(change.sourceEntry->title()));
+        Entry* newEntry = change.sourceEntry->clone(Entry::CloneIncludeHistory);
+        newEntry->setGroup(targetGroup);
+        m_targetEntries.insert(newEntry->uuid(), newEntry);
+        break;
+    }
+    case EntryMoved: {
+        Entry* existingEntry = m_targetEntries.value(change.uuid);
+        existingEntry->setGroup(targetGroup);
+        qDebug("Location changed for entry %s. Updating it", qPrintable(existingEntry->title()));
+        break;
+    }
+    case EntryUpdated: {
+        Entry* existingEntry = m_targetEntries.value(change.uuid);
+        qDebug("Updating entry %s.", qPrintable(existingEntry->title()));
+        Group* currentGroup = existingEntry->group();
+        currentGroup->removeEntry(existingEntry);
+        // the clone replaces the entry, don't record it as a deleted object
+        existingEntry->m_group = nullptr;
+        delete existingEntry;
+        Entry* clonedEntry = change.sourceEntry->clone(Entry::CloneIncludeHistory);
+        clonedEntry->setGroup(currentGroup);
+        m_targetEntries.insert(clonedEntry->uuid(), clonedEntry);
+        break;
+    }
+    case EntryDuplicated: {
+        Entry* existingEntry = m_targetEntries.value(change.uuid);
+        Entry* clonedEntry = change.sourceEntry->clone(Entry::CloneNewUuid | Entry::CloneIncludeHistory);
+        clonedEntry->setGroup(targetGroup);
+        markOlderEntry(change.existingIsOlder ? existingEntry : clonedEntry);
+        break;
+    }
+    case GroupAdded: {
+        qDebug("New group %s detected. Creating it.", qPrintable(change.sourceGroup->name()));
+        Group* newGroup = change.sourceGroup->clone(Entry::CloneNoFlags, Group::CloneNoFlags);
+        newGroup->setParent(targetGroup);
+        m_targetGroups.insert(newGroup->uuid(), newGroup);
+        break;
+    }
+    case GroupMoved: {
+        Group* existingGroup = m_targetGroups.value(change.uuid);
+        existingGroup->setParent(targetGroup);
+        qDebug("Location changed for group %s. Updating it", qPrintable(existingGroup->name()));
+        break;
+    }
+    case GroupUpdated: {
+        Group* existingGroup = m_targetGroups.value(change.uuid);
+        const Group* otherGroup = change.sourceGroup;
+        qDebug("Updating group %s.", qPrintable(existingGroup->name()));
+        existingGroup->setName(otherGroup->name());
+        existingGroup->setNotes(otherGroup->notes());
+        if (otherGroup->iconNumber() == 0) {
+            existingGroup->setIcon(otherGroup->iconUuid());
+        } else {
+            existingGroup->setIcon(otherGroup->iconNumber());
+        }
+        existingGroup->setExpiryTime(otherGroup->timeInfo().expiryTime());
+        break;
+    }
+    case CustomIconAdded:
+        qDebug("Adding custom icon %s to database.", qPrintable(change.uuid.toHex()));
+        m_targetDb->metadata()->addCustomIcon(change.uuid, m_sourceDb->metadata()->customIcon(change.uuid));
+        break;
+    }
+}
+
+void Merger::markOlderEntry(Entry* entry)
+{
+    entry->attributes()->set(
+        "merged",
+        Group::tr("older entry merged from database \"%1\"").arg(entry->group()->database()->metadata()->name()));
+}
@@ -0,0 +1,115 @@
+/*
+ *  Copyright (C) 2018 KeePassXC Team <team@keepassxc.org>
+ *
+ *  This program is free software: you can redistribute it and/or modify
+ *  it under the terms of the GNU General Public License as published by
+ *  the Free Software Foundation, either version 2 or (at your option)
+ *  version 3 of the License.
+ *
+ *  This program is distributed in the hope that it will be useful,
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *  GNU General Public License for more details.
+ *
+ *  You should have received a copy of the GNU General Public License
+ *  along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#ifndef KEEPASSX_MERGER_H
+#define KEEPASSX_MERGER_H
+
+#include <QHash>
+#include <QList>
+
+#include "core/Group.h"
+#include "core/Uuid.h"
+
+class Database;
+class Entry;
+
+/**
+ * Merges the entries and groups of a source tree into a target tree.
+ *
+ * Entries and groups are matched by uuid. A merge runs in two steps:
+ * plan() compares both trees and returns the list of changes without
+ * touching the target, apply() then carries out a planned change set.
+ * All decisions are taken on the state of the trees before the merge.
+ * The uuid maps of the target are built once per step, so a merge is
+ * linear in the size of both trees.
+ */
+class Merger
+{
+public:
+    enum ChangeType
+    {
+        EntryAdded,
+        EntryMoved,
+        EntryUpdated,
+        EntryDuplicated,
+        GroupAdded,
+        GroupMoved,
+        GroupUpdated,
+        CustomIconAdded
+    };
+
+    struct Change
+    {
+        ChangeType type;
+        /** Uuid of the entry, group or custom icon that is changed. */
+        Uuid uuid;
+        /** Group an entry or group is added to or moved to. */
+        Uuid targetGroupUuid;
+        const Entry* sourceEntry;
+        const Group* sourceGroup;
+        /** For EntryDuplicated: the existing entry is older than the source entry. */
+        bool existingIsOlder;
+    };
+
+    struct ChangeSet
+    {
+        QList<Change> changes;
+        /** Time spent in each phase, in nanoseconds. */
+        qint64 indexTime = 0;
+        qint64 planTime = 0;
+        qint64 applyTime = 0;
+
+        bool isEmpty() const;
+        int count(ChangeType type) const;
+    };
+
+    Merger(const Database* sourceDb, Database* targetDb);
+    Merger(const Group* sourceGroup, Group* targetGroup);
+
+    ChangeSet plan();
+    bool apply(ChangeSet& changeSet);
+    ChangeSet merge();
+
+private:
+    void indexTarget();
+    void planGroup(const Uuid& targetGroupUuid, const Group* sourceGroup, ChangeSet& changeSet);
+    void planEntryConflict(const Uuid& targetGroupUuid,
+                           const Entry* existingEntry,
+                           const Entry* otherEntry,
+                           ChangeSet& changeSet);
+    void planMetadata(ChangeSet& changeSet);
+    Group::MergeMode plannedMergeMode(Uuid groupUuid) const;
+    bool isApplicable(const ChangeSet& changeSet) const;
+    void applyChange(const Change& change);
+    void markOlderEntry(Entry* entry);
+
+    const Database* const m_sourceDb;
+    Database* const m_targetDb;
+    const Group* const m_sourceGroup;
+    Group* const m_targetGroup;
+    Group* m_targetRootGroup;
+
+    QHash<Uuid, Entry*> m_targetEntries;
+    QHash<Uuid, Group*> m_targetGroups;
+
+    // state of the target tree as it would be after the changes planned so far
+    QHash<Uuid, Uuid> m_plannedEntryGroups;
+    QHash<Uuid, Uuid> m_plannedGroupParents;
+    QHash<Uuid, Group::MergeMode> m_plannedGroupModes;
+};
+
+#endif // KEEPASSX_MERGER_H
@@ -90,6 +90,19 @@ void Metadata::copyAttributesFrom(const Metadata* other)
     m_data = other->m_data;
 }
 
+void Metadata::syncDataFrom(const Metadata* other)
+{
+    const QString oldName = m_data.name;
+
+    m_data = other->m_data;
+    m_customData->copyDataFrom(other->m_customData);
+    m_masterKeyChanged = other->m_masterKeyChanged;
+
+    if (m_data.name != oldName) {
+        emit nameTextChanged();
+    }
+}
+
 QString Metadata::generator() const
 {
     return m_data.generator;
@@ -146,6 +146,12 @@ public:
      * - Settings changed date
      */
     void copyAttributesFrom(const Metadata* other);
+    /*
+     * Copy the attributes, custom data and master key changed date from
+     * other, e.g. a newer copy of the same database. Emits nameTextChanged()
+     * if the name changes. Group pointers and custom icons are not copied.
+     */
+    void syncDataFrom(const Metadata* other);
 
 signals:
     void nameTextChanged();
@@ -17,11 +17,10 @@
 
 #include "PassphraseGenerator.h"
 
-#include <QFile>
-#include <QTextStream>
 #include <cmath>
 
 #include "core/FilePath.h"
+#include "core/WordList.h"
 #include "crypto/Random.h"
 
 const char* PassphraseGenerator::DefaultSeparator = " ";
@@ -37,11 +36,11 @@ double PassphraseGenerator::calculateEntropy(const QString& passphrase)
 {
     Q_UNUSED(passphrase);
 
-    if (m_wordlist.isEmpty()) {
+    if (!m_wordlist || m_wordlist->size() == 0) {
         return 0.0;
     }
 
-    return std::log2(m_wordlist.size()) * m_wordCount;
+    return std::log2(m_wordlist->size()) * m_wordCount;
 }
 
 void PassphraseGenerator::setWordCount(int wordCount)
@@ -56,20 +55,13 @@ void PassphraseGenerator::setWordCount(int wordCount)
 
 void PassphraseGenerator::setWordList(const QString& path)
 {
-    m_wordlist.clear();
-
-    QFile file(path);
-    if (!file.open(QIODevice::ReadOnly | QIODevice::Text)) {
+    m_wordlist = WordList::load(path);
+    if (!m_wordlist) {
         qWarning("Couldn't load passphrase wordlist.");
         return;
     }
 
-    QTextStream in(&file);
-    while (!in.atEnd()) {
-        m_wordlist.append(in.readLine());
-    }
-
-    if (m_wordlist.size() < 4000) {
+    if (m_wordlist->size() < 4000) {
         qWarning("Wordlist too short!");
         return;
     }
@@ -91,24 +83,34 @@ QString PassphraseGenerator::generatePassphrase() const
     Q_ASSERT(isValid());
 
     // In case there was an error loading the wordlist
-    if (m_wordlist.length() == 0) {
+    if (!m_wordlist || m_wordlist->size() == 0) {
         return QString();
     }
 
     QStringList words;
     for (int i = 0; i < m_wordCount; ++i) {
-        int wordIndex = randomGen()->randomUInt(static_cast<quint32>(m_wordlist.length()));
-        words.append(m_wordlist.at(wordIndex));
+        int wordIndex = randomGen()->randomUInt(static_cast<quint32>(m_wordlist->size()));
+        words.append(m_wordlist->word(wordIndex));
     }
 
     return words.join(m_separator);
 }
 
+QStringList PassphraseGenerator::generatePassphrases(int count) const
+{
+    QStringList passphrases;
+    passphrases.reserve(count);
+    for (int i = 0; i < count; ++i) {
+        passphrases.append(generatePassphrase());
+    }
+    return passphrases;
+}
+
 bool PassphraseGenerator::isValid() const
 {
     if (m_wordCount == 0) {
         return false;
     }
 
-    return m_wordlist.size() >= 1000;
+    return m_wordlist && m_wordlist->size() >= 1000;
 }
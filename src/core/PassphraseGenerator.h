@@ -19,8 +19,11 @@
 #define KEEPASSX_PASSPHRASEGENERATOR_H
 
 #include <QFlags>
+#include <QSharedPointer>
 #include <QString>
-#include <QVector>
+#include <QStringList>
+
+class WordList;
 
 class PassphraseGenerator
 {
@@ -36,6 +39,10 @@ public:
     bool isValid() const;
 
     QString generatePassphrase() const;
+    /**
+     * Generates count passphrases at once, e.g. for provisioning accounts.
+     */
+    QStringList generatePassphrases(int count) const;
 
     static constexpr int DefaultWordCount = 7;
     static const char* DefaultSeparator;
@@ -44,7 +51,7 @@ public:
 private:
     int m_wordCount;
     QString m_separator;
-    QVector<QString> m_wordlist;
+    QSharedPointer<const WordList> m_wordlist;
 };
 
 #endif // KEEPASSX_PASSPHRASEGENERATOR_H
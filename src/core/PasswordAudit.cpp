@@ -0,0 +1,174 @@
+/*
+ *  Copyright (C) 2018 KeePassXC Team <team@keepassxc.org>
+ *
+ *  This program is free software: you can redistribute it and/or modify
+ *  it under the terms of the GNU General Public License as published by
+ *  the Free Software Foundation, either version 2 or (at your option)
+ *  version 3 of the License.
+ *
+ *  This program is distributed in the hope that it will be useful,
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *  GNU General Public License for more details.
+ *
+ *  You should have received a copy of the GNU General Public License
+ *  along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#include "PasswordAudit.h"
+
+#include <QHash>
+#include <QSet>
+#include <QVector>
+#include <QtConcurrentMap>
+
+#include <algorithm>
+#include <zxcvbn.h>
+
+#include "core/Entry.h"
+#include "core/Global.h"
+#include "core/Group.h"
+
+const double PasswordAudit::DefaultWeakEntropy = 40.0;
+
+namespace
+{
+    struct PasswordInfo
+    {
+        QString password;
+        double entropy;
+        QSet<const Entry*> owners;
+    };
+
+    struct PasswordUse
+    {
+        const Entry* entry;
+        const Entry* owner;
+        int passwordIndex;
+    };
+} // namespace
+
+PasswordAudit::PasswordAudit(double weakEntropy)
+    : m_weakEntropy(weakEntropy)
+    , m_includeHistory(false)
+    , m_passwordCount(0)
+    , m_uniquePasswordCount(0)
+    , m_weakCount(0)
+    , m_reusedCount(0)
+    , m_expiredCount(0)
+{
+}
+
+void PasswordAudit::setIncludeHistory(bool includeHistory)
+{
+    m_includeHistory = includeHistory;
+}
+
+void PasswordAudit::audit(const Group* group)
+{
+    m_results.clear();
+    m_passwordCount = 0;
+    m_weakCount = 0;
+    m_reusedCount = 0;
+    m_expiredCount = 0;
+
+    QVector<PasswordInfo> passwords;
+    QHash<QString, int> passwordIndexes;
+    QVector<PasswordUse> uses;
+
+    auto addUse = [&](const Entry* entry, const Entry* owner) {
+        const QString password = entry->password();
+        int index = -1;
+        if (!password.isEmpty()) {
+            auto it = passwordIndexes.constFind(password);
+            if (it == passwordIndexes.constEnd()) {
+                index = passwords.size();
+                passwordIndexes.insert(password, index);
+                passwords.append({password, 0.0, QSet<const Entry*>()});
+            } else {
+                index = it.value();
+            }
+            passwords[index].owners.insert(owner);
+            ++m_passwordCount;
+        }
+        uses.append({entry, owner, index});
+    };
+
+    group->walkEntries([&](const Entry* entry) {
+        addUse(entry, entry);
+        if (m_includeHistory) {
+            for (const Entry* historyItem : entry->historyItems()) {
+                addUse(historyItem, entry);
+            }
+        }
+        return false;
+    });
+    m_uniquePasswordCount = passwords.size();
+
+    // zxcvbn only reads its dictionary while matching, so the passwords can be estimated in parallel
+    QtConcurrent::blockingMap(passwords, [](PasswordInfo& info) {
+        info.entropy = ZxcvbnMatch(info.password.toUtf8().constData(), nullptr, nullptr);
+    });
+
+    for (const PasswordUse& use : asConst(uses)) {
+        const PasswordInfo* info = use.passwordIndex >= 0 ? &passwords.at(use.passwordIndex) : nullptr;
+        Result result;
+        result.entry = use.entry;
+        result.owner = use.owner;
+        result.entropy = info ? info->entropy : 0.0;
+        result.reuseCount = info ? info->owners.size() - 1 : 0;
+        result.weak = info && info->entropy < m_weakEntropy;
+        result.expired = use.entry == use.owner && use.entry->isExpired();
+        if (!result.weak && result.reuseCount == 0 && !result.expired) {
+            continue;
+        }
+
+        m_weakCount += result.weak ? 1 : 0;
+        m_reusedCount += result.reuseCount > 0 ? 1 : 0;
+        m_expiredCount += result.expired ? 1 : 0;
+        m_results.append(result);
+    }
+
+    std::stable_sort(m_results.begin(), m_results.end(), [](const Result& lhs, const Result& rhs) {
+        if (lhs.weak != rhs.weak) {
+            return lhs.weak;
+        }
+        if (lhs.weak && lhs.entropy != rhs.entropy) {
+            return lhs.entropy < rhs.entropy;
+        }
+        if (lhs.reuseCount != rhs.reuseCount) {
+            return lhs.reuseCount > rhs.reuseCount;
+        }
+        return lhs.expired && !rhs.expired;
+    });
+}
+
+QList<PasswordAudit::Result> PasswordAudit::results() const
+{
+    return m_results;
+}
+
+int PasswordAudit::passwordCount() const
+{
+    return m_passwordCount;
+}
+
+int PasswordAudit::uniquePasswordCount() const
+{
+    return m_uniquePasswordCount;
+}
+
+int PasswordAudit::weakCount() const
+{
+    return m_weakCount;
+}
+
+int PasswordAudit::reusedCount() const
+{
+    return m_reusedCount;
+}
+
+int PasswordAudit::expiredCount() const
+{
+    return m_expiredCount;
+}
@@ -0,0 +1,91 @@
+/*
+ *  Copyright (C) 2018 KeePassXC Team <team@keepassxc.org>
+ *
+ *  This program is free software: you can redistribute it and/or modify
+ *  it under the terms of the GNU General Public License as published by
+ *  the Free Software Foundation, either version 2 or (at your option)
+ *  version 3 of the License.
+ *
+ *  This program is distributed in the hope that it will be useful,
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *  GNU General Public License for more details.
+ *
+ *  You should have received a copy of the GNU General Public License
+ *  along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#ifndef KEEPASSX_PASSWORDAUDIT_H
+#define KEEPASSX_PASSWORDAUDIT_H
+
+#include <QList>
+#include <QString>
+
+class Entry;
+class Group;
+
+/**
+ * Checks the passwords of all entries below a group for weak, reused and
+ * expired passwords.
+ *
+ * Every distinct password is estimated once with zxcvbn, in parallel on
+ * the global thread pool. Reuse is detected through a hash of the
+ * passwords, a password counts as reused if different entries use it.
+ * History items only contribute to the reuse counts of their entry's
+ * password if they are included, they are never reported as expired.
+ */
+class PasswordAudit
+{
+public:
+    /**
+     * Entropy in bits below which a password is weak, the limit of a poor
+     * password in the password generator.
+     */
+    static const double DefaultWeakEntropy;
+
+    struct Result
+    {
+        const Entry* entry;
+        /** The entry owning the history item, or entry itself. */
+        const Entry* owner;
+        double entropy;
+        /** Number of other entries that use the same password. */
+        int reuseCount;
+        bool weak;
+        bool expired;
+    };
+
+    explicit PasswordAudit(double weakEntropy = DefaultWeakEntropy);
+
+    void setIncludeHistory(bool includeHistory);
+
+    /**
+     * Audits the entries below group. Blocks until all passwords have been
+     * estimated.
+     */
+    void audit(const Group* group);
+
+    /**
+     * Entries with at least one issue: weak passwords first, weakest first,
+     * then the most reused passwords, then expired entries. Ties keep the
+     * order of the tree.
+     */
+    QList<Result> results() const;
+    int passwordCount() const;
+    int uniquePasswordCount() const;
+    int weakCount() const;
+    int reusedCount() const;
+    int expiredCount() const;
+
+private:
+    const double m_weakEntropy;
+    bool m_includeHistory;
+    QList<Result> m_results;
+    int m_passwordCount;
+    int m_uniquePasswordCount;
+    int m_weakCount;
+    int m_reusedCount;
+    int m_expiredCount;
+};
+
+#endif // KEEPASSX_PASSWORDAUDIT_H
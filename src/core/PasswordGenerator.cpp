@@ -61,15 +61,31 @@ QString PasswordGenerator::generatePassword() const
     Q_ASSERT(isValid());
 
     const QVector<PasswordGroup> groups = passwordGroups();
+    const QVector<QChar> passwordChars = alphabet(groups);
 
-    QVector<QChar> passwordChars;
-    for (const PasswordGroup& group : groups) {
-        for (QChar ch : group) {
-            passwordChars.append(ch);
-        }
+    return generatePassword(groups, passwordChars);
+}
+
+QStringList PasswordGenerator::generatePasswords(int count) const
+{
+    Q_ASSERT(isValid());
+
+    const QVector<PasswordGroup> groups = passwordGroups();
+    const QVector<QChar> passwordChars = alphabet(groups);
+
+    QStringList passwords;
+    passwords.reserve(count);
+    for (int i = 0; i < count; ++i) {
+        passwords.append(generatePassword(groups, passwordChars));
     }
+    return passwords;
+}
 
+QString PasswordGenerator::generatePassword(const QVector<PasswordGroup>& groups,
+                                            const QVector<QChar>& passwordChars) const
+{
     QString password;
+    password.reserve(m_length);
 
     if (m_flags & CharFromEveryGroup) {
         for (int i = 0; i < groups.size(); i++) {
@@ -223,6 +239,17 @@ QVector<PasswordGroup> PasswordGenerator::passwordGroups() const
     return passwordGroups;
 }
 
+QVector<QChar> PasswordGenerator::alphabet(const QVector<PasswordGroup>& groups)
+{
+    QVector<QChar> passwordChars;
+    for (const PasswordGroup& group : groups) {
+        for (QChar ch : group) {
+            passwordChars.append(ch);
+        }
+    }
+    return passwordChars;
+}
+
 int PasswordGenerator::numCharClasses() const
 {
     int numClasses = 0;
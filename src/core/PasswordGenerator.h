@@ -21,6 +21,7 @@
 
 #include <QFlags>
 #include <QString>
+#include <QStringList>
 #include <QVector>
 
 typedef QVector<QChar> PasswordGroup;
@@ -58,6 +59,12 @@ public:
     bool isValid() const;
 
     QString generatePassword() const;
+    /**
+     * Generates count passwords with the same settings and distribution
+     * as generatePassword(). The character set is built once for all of
+     * them.
+     */
+    QStringList generatePasswords(int count) const;
     int getbits() const;
 
     static const int DefaultLength = 16;
@@ -70,7 +77,9 @@ public:
     static constexpr bool DefaultFromEveryGroup = (DefaultFlags & CharFromEveryGroup) != 0;
 
 private:
+    QString generatePassword(const QVector<PasswordGroup>& groups, const QVector<QChar>& passwordChars) const;
     QVector<PasswordGroup> passwordGroups() const;
+    static QVector<QChar> alphabet(const QVector<PasswordGroup>& groups);
     int numCharClasses() const;
 
     int m_length;
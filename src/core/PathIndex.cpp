@@ -0,0 +1,239 @@
+/*
+ *  Copyright (C) 2018 KeePassXC Team <team@keepassxc.org>
+ *
+ *  This program is free software: you can redistribute it and/or modify
+ *  it under the terms of the GNU General Public License as published by
+ *  the Free Software Foundation, either version 2 or (at your option)
+ *  version 3 of the License.
+ *
+ *  This program is distributed in the hope that it will be useful,
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *  GNU General Public License for more details.
+ *
+ *  You should have received a copy of the GNU General Public License
+ *  along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#include "PathIndex.h"
+
+#include "core/Database.h"
+#include "core/Entry.h"
+#include "core/Global.h"
+#include "core/Group.h"
+
+PathIndex::PathIndex(Database* db)
+    : m_db(db)
+    , m_valid(false)
+{
+    connect(db, SIGNAL(groupAdded()), SLOT(invalidate()));
+    connect(db, SIGNAL(groupRemoved()), SLOT(invalidate()));
+    connect(db, SIGNAL(groupMoved()), SLOT(invalidate()));
+    connect(db, SIGNAL(groupDataChanged(Group*)), SLOT(updateGroup(Group*)));
+    connect(db, SIGNAL(entryDataChanged(Entry*)), SLOT(updateEntry(Entry*)));
+}
+
+bool PathIndex::isValid() const
+{
+    return m_valid;
+}
+
+void PathIndex::invalidate()
+{
+    m_valid = false;
+}
+
+Entry* PathIndex::entryByUuid(const Uuid& uuid)
+{
+    ensureValid();
+    return firstEntry(m_entriesByUuid.values(uuid));
+}
+
+/**
+ * Entry paths are accepted with or without a single leading slash.
+ */
+Entry* PathIndex::entryByPath(const QString& entryPath)
+{
+    ensureValid();
+
+    Entry* entry = firstEntry(m_entriesByPath.values(entryPath));
+    if (!entry && entryPath.startsWith("/")) {
+        entry = firstEntry(m_entriesByPath.values(entryPath.mid(1)));
+    }
+
+    return entry;
+}
+
+Entry* PathIndex::entryByTitle(const QString& title)
+{
+    ensureValid();
+    return firstEntry(m_entriesByTitle.values(title));
+}
+
+Group* PathIndex::groupByPath(const QString& groupPath)
+{
+    ensureValid();
+    return firstGroup(m_groupsByPath.values(normalizedGroupPath(groupPath)));
+}
+
+QString PathIndex::groupPath(const Group* group)
+{
+    ensureValid();
+    return m_groupPaths.value(const_cast<Group*>(group));
+}
+
+void PathIndex::addEntry(Entry* entry)
+{
+    if (!m_valid) {
+        return;
+    }
+
+    if (!m_groupPaths.contains(entry->group())) {
+        invalidate();
+        return;
+    }
+    insertEntry(entry, m_groupPaths.value(entry->group()));
+}
+
+void PathIndex::removeEntry(Entry* entry)
+{
+    if (m_valid) {
+        removeEntryKeys(entry);
+    }
+}
+
+/**
+ * Bring a group path into the form used as index key: exactly one slash is
+ * added in front and at the end if missing, "" and "/" denote the root group.
+ */
+QString PathIndex::normalizedGroupPath(const QString& groupPath)
+{
+    QString path = groupPath;
+    if (!path.startsWith("/")) {
+        path.prepend("/");
+    }
+    if (!path.endsWith("/")) {
+        path.append("/");
+    }
+    return path;
+}
+
+/**
+ * Re-keys an entry whose title or uuid may have changed.
+ */
+void PathIndex::updateEntry(Entry* entry)
+{
+    if (!m_valid || !m_entryKeys.contains(entry)) {
+        return;
+    }
+
+    const EntryKeys& keys = m_entryKeys[entry];
+    if (keys.title == entry->title() && keys.uuid == entry->uuid()) {
+        return;
+    }
+
+    removeEntryKeys(entry);
+    insertEntry(entry, m_groupPaths.value(entry->group()));
+}
+
+/**
+ * Re-keys the subtree of a group whose name may have changed.
+ */
+void PathIndex::updateGroup(Group* group)
+{
+    if (!m_valid || !m_groupPaths.contains(group) || !group->parentGroup()) {
+        return;
+    }
+
+    const QString path = m_groupPaths.value(group->parentGroup()) + group->name() + "/";
+    if (path == m_groupPaths.value(group)) {
+        return;
+    }
+
+    group->walkGroups([this](Group* subgroup) {
+        m_groupsByPath.remove(m_groupPaths.value(subgroup), subgroup);
+        for (Entry* entry : subgroup->entries()) {
+            removeEntryKeys(entry);
+        }
+        return false;
+    });
+    indexGroup(group, path);
+}
+
+void PathIndex::ensureValid()
+{
+    if (m_valid) {
+        return;
+    }
+
+    m_entryKeys.clear();
+    m_groupPaths.clear();
+    m_entriesByUuid.clear();
+    m_entriesByPath.clear();
+    m_entriesByTitle.clear();
+    m_groupsByPath.clear();
+
+    indexGroup(m_db->rootGroup(), QString("/"));
+    m_valid = true;
+}
+
+void PathIndex::indexGroup(Group* group, const QString& groupPath)
+{
+    m_groupPaths.insert(group, groupPath);
+    m_groupsByPath.insert(groupPath, group);
+
+    for (Entry* entry : group->entries()) {
+        insertEntry(entry, groupPath);
+    }
+
+    for (Group* child : group->children()) {
+        indexGroup(child, groupPath + child->name() + "/");
+    }
+}
+
+void PathIndex::insertEntry(Entry* entry, const QString& groupPath)
+{
+    EntryKeys keys;
+    keys.path = groupPath.mid(1) + entry->title();
+    keys.title = entry->title();
+    keys.uuid = entry->uuid();
+
+    m_entriesByPath.insert(keys.path, entry);
+    m_entriesByTitle.insert(keys.title, entry);
+    m_entriesByUuid.insert(keys.uuid, entry);
+    m_entryKeys.insert(entry, keys);
+}
+
+void PathIndex::removeEntryKeys(Entry* entry)
+{
+    if (!m_entryKeys.contains(entry)) {
+        return;
+    }
+
+    const EntryKeys keys = m_entryKeys.take(entry);
+    m_entriesByPath.remove(keys.path, entry);
+    m_entriesByTitle.remove(keys.title, entry);
+    m_entriesByUuid.remove(keys.uuid, entry);
+}
+
+Entry* PathIndex::firstEntry(const QList<Entry*>& entries)
+{
+    Entry* first = nullptr;
+    for (Entry* entry : entries) {
+        if (!first || Group::walkOrderLessThan(entry, first)) {
+            first = entry;
+        }
+    }
+    return first;
+}
+
+Group* PathIndex::firstGroup(const QList<Group*>& groups)
+{
+    Group* first = nullptr;
+    for (Group* group : groups) {
+        if (!first || Group::walkOrderLessThan(group, first)) {
+            first = group;
+        }
+    }
+    return first;
+}
@@ -0,0 +1,106 @@
+/*
+ *  Copyright (C) 2018 KeePassXC Team <team@keepassxc.org>
+ *
+ *  This program is free software: you can redistribute it and/or modify
+ *  it under the terms of the GNU General Public License as published by
+ *  the Free Software Foundation, either version 2 or (at your option)
+ *  version 3 of the License.
+ *
+ *  This program is distributed in the hope that it will be useful,
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *  GNU General Public License for more details.
+ *
+ *  You should have received a copy of the GNU General Public License
+ *  along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#ifndef KEEPASSX_PATHINDEX_H
+#define KEEPASSX_PATHINDEX_H
+
+#include <QHash>
+#include <QObject>
+#include <QString>
+
+#include "core/Uuid.h"
+
+class Database;
+class Entry;
+class Group;
+
+/**
+ * Lookup tables from paths, titles and uuids to the entries and groups
+ * below the root group of a database.
+ *
+ * The index is built on first use and then kept up to date: added,
+ * removed, moved and renamed entries and renamed groups update only the
+ * affected keys, edits that don't change a path, title or uuid leave it
+ * alone. Adding, removing or moving groups drops the index, it is rebuilt
+ * by the next lookup.
+ *
+ * Entry paths are stored relative to the root group ("group/entry"),
+ * group paths with leading and trailing slash ("/group/"). Keys may be
+ * shared by several nodes; the first one in tree order wins, which
+ * matches the behaviour of the recursive lookups in Group.
+ */
+class PathIndex : public QObject
+{
+    Q_OBJECT
+
+public:
+    explicit PathIndex(Database* db);
+
+    bool isValid() const;
+
+    Entry* entryByUuid(const Uuid& uuid);
+    Entry* entryByPath(const QString& entryPath);
+    Entry* entryByTitle(const QString& title);
+    Group* groupByPath(const QString& groupPath);
+    /**
+     * Returns the path of a group below the root group, or a null string
+     * for groups that are not in the tree.
+     */
+    QString groupPath(const Group* group);
+
+    /**
+     * Called by Group when an entry was added to or is removed from a
+     * group of the database.
+     */
+    void addEntry(Entry* entry);
+    void removeEntry(Entry* entry);
+
+    static QString normalizedGroupPath(const QString& groupPath);
+
+public slots:
+    void invalidate();
+
+private slots:
+    void updateEntry(Entry* entry);
+    void updateGroup(Group* group);
+
+private:
+    struct EntryKeys
+    {
+        QString path;
+        QString title;
+        Uuid uuid;
+    };
+
+    void ensureValid();
+    void indexGroup(Group* group, const QString& groupPath);
+    void insertEntry(Entry* entry, const QString& groupPath);
+    void removeEntryKeys(Entry* entry);
+    static Entry* firstEntry(const QList<Entry*>& entries);
+    static Group* firstGroup(const QList<Group*>& groups);
+
+    Database* const m_db;
+    bool m_valid;
+    QHash<Entry*, EntryKeys> m_entryKeys;
+    QHash<Group*, QString> m_groupPaths;
+    QMultiHash<Uuid, Entry*> m_entriesByUuid;
+    QMultiHash<QString, Entry*> m_entriesByPath;
+    QMultiHash<QString, Entry*> m_entriesByTitle;
+    QMultiHash<QString, Group*> m_groupsByPath;
+};
+
+#endif // KEEPASSX_PATHINDEX_H
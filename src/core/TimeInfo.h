@@ -41,6 +41,9 @@ public:
     void setUsageCount(int count);
     void setLocationChanged(const QDateTime& dateTime);
 
+    bool operator==(const TimeInfo& other) const;
+    bool operator!=(const TimeInfo& other) const;
+
 private:
     QDateTime m_lastModificationTime;
     QDateTime m_creationTime;
@@ -0,0 +1,208 @@
+/*
+ *  Copyright (C) 2018 KeePassXC Team <team@keepassxc.org>
+ *
+ *  This program is free software: you can redistribute it and/or modify
+ *  it under the terms of the GNU General Public License as published by
+ *  the Free Software Foundation, either version 2 or (at your option)
+ *  version 3 of the License.
+ *
+ *  This program is distributed in the hope that it will be useful,
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *  GNU General Public License for more details.
+ *
+ *  You should have received a copy of the GNU General Public License
+ *  along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#include "WordList.h"
+
+#include <QDateTime>
+#include <QFileInfo>
+#include <QHash>
+#include <QMutex>
+#include <QVector>
+#include <QtEndian>
+
+#include <cstring>
+
+#include "core/Endian.h"
+#include "core/Global.h"
+
+namespace
+{
+    const char Magic[] = "KPXCWORD";
+    const int MagicSize = 8;
+    const quint32 Version = 1;
+    const int HeaderSize = MagicSize + 4 + 4;
+
+    struct CachedWordList
+    {
+        QDateTime lastModified;
+        qint64 size;
+        QSharedPointer<const WordList> wordList;
+    };
+
+    quint32 readUInt32(const uchar* data)
+    {
+        return qFromLittleEndian<quint32>(data);
+    }
+
+    void appendUInt32(QByteArray& data, quint32 value)
+    {
+        data.append(Endian::sizedIntToBytes<quint32>(value, QSysInfo::LittleEndian));
+    }
+} // namespace
+
+WordList::WordList()
+    : m_data(nullptr)
+    , m_dataSize(0)
+    , m_count(0)
+    , m_offsets(nullptr)
+    , m_words(nullptr)
+{
+}
+
+WordList::~WordList()
+{
+}
+
+QSharedPointer<const WordList> WordList::load(const QString& path)
+{
+    static QMutex cacheMutex;
+    static QHash<QString, CachedWordList> cache;
+
+    const QFileInfo fileInfo(path);
+    const QString cacheKey = fileInfo.absoluteFilePath();
+
+    QMutexLocker locker(&cacheMutex);
+    auto it = cache.constFind(cacheKey);
+    if (it != cache.constEnd() && it->lastModified == fileInfo.lastModified() && it->size == fileInfo.size()) {
+        return it->wordList;
+    }
+    cache.remove(cacheKey);
+
+    QSharedPointer<WordList> wordList(new WordList());
+    wordList->m_file.setFileName(path);
+    if (!wordList->m_file.open(QIODevice::ReadOnly)) {
+        return QSharedPointer<const WordList>();
+    }
+
+    const bool isCompiled = wordList->m_file.peek(MagicSize) == QByteArray(Magic, MagicSize);
+    if (!(isCompiled ? wordList->loadCompiled() : wordList->loadText())) {
+        return QSharedPointer<const WordList>();
+    }
+
+    CachedWordList cached;
+    cached.lastModified = fileInfo.lastModified();
+    cached.size = fileInfo.size();
+    cached.wordList = wordList;
+    cache.insert(cacheKey, cached);
+    return wordList;
+}
+
+int WordList::size() const
+{
+    return static_cast<int>(m_count);
+}
+
+QString WordList::word(int index) const
+{
+    Q_ASSERT(index >= 0 && static_cast<quint32>(index) < m_count);
+
+    const quint32 begin = readUInt32(m_offsets + 4 * index);
+    const quint32 end = readUInt32(m_offsets + 4 * (index + 1));
+    return QString::fromUtf8(reinterpret_cast<const char*>(m_words + begin), static_cast<int>(end - begin));
+}
+
+bool WordList::isMapped() const
+{
+    return m_buffer.isEmpty() && m_data;
+}
+
+bool WordList::writeCompiled(QIODevice* device) const
+{
+    return device->write(reinterpret_cast<const char*>(m_data), m_dataSize) == m_dataSize;
+}
+
+bool WordList::loadCompiled()
+{
+    const qint64 fileSize = m_file.size();
+    const uchar* data = m_file.map(0, fileSize);
+    if (!data) {
+        // e.g. compressed resources can't be mapped
+        m_buffer = m_file.readAll();
+        return setData(reinterpret_cast<const uchar*>(m_buffer.constData()), m_buffer.size());
+    }
+    return setData(data, fileSize);
+}
+
+/**
+ * Converts a plain text list with one word per line into the compiled
+ * layout. Empty lines and surrounding white space are ignored.
+ */
+bool WordList::loadText()
+{
+    const QList<QByteArray> lines = m_file.readAll().split('\n');
+    m_file.close();
+
+    QByteArray words;
+    QVector<quint32> offsets;
+    offsets.reserve(lines.size() + 1);
+    offsets.append(0);
+    for (const QByteArray& line : lines) {
+        const QByteArray word = line.trimmed();
+        if (!word.isEmpty()) {
+            words.append(word);
+            offsets.append(static_cast<quint32>(words.size()));
+        }
+    }
+
+    m_buffer.reserve(HeaderSize + offsets.size() * 4 + words.size());
+    m_buffer.append(Magic, MagicSize);
+    appendUInt32(m_buffer, Version);
+    appendUInt32(m_buffer, static_cast<quint32>(offsets.size() - 1));
+    for (quint32 offset : asConst(offsets)) {
+        appendUInt32(m_buffer, offset);
+    }
+    m_buffer.append(words);
+
+    return setData(reinterpret_cast<const uchar*>(m_buffer.constData()), m_buffer.size());
+}
+
+/**
+ * Checks the header and the offsets table, so word() can't read outside
+ * of the data.
+ */
+bool WordList::setData(const uchar* data, qint64 size)
+{
+    if (size < HeaderSize || memcmp(data, Magic, MagicSize) != 0 || readUInt32(data + MagicSize) != Version) {
+        qWarning("Invalid word list %s.", qPrintable(m_file.fileName()));
+        return false;
+    }
+
+    const quint32 count = readUInt32(data + MagicSize + 4);
+    if ((size - HeaderSize) / 4 < static_cast<qint64>(count) + 1) {
+        qWarning("Invalid word list %s.", qPrintable(m_file.fileName()));
+        return false;
+    }
+
+    const uchar* offsets = data + HeaderSize;
+    const qint64 wordsSize = size - HeaderSize - (static_cast<qint64>(count) + 1) * 4;
+    quint32 previous = 0;
+    for (quint32 i = 0; i <= count; ++i) {
+        const quint32 offset = readUInt32(offsets + 4 * i);
+        if ((i == 0 && offset != 0) || offset < previous || offset > wordsSize) {
+            qWarning("Invalid word list %s.", qPrintable(m_file.fileName()));
+            return false;
+        }
+        previous = offset;
+    }
+
+    m_data = data;
+    m_dataSize = size;
+    m_count = count;
+    m_offsets = offsets;
+    m_words = offsets + (static_cast<qint64>(count) + 1) * 4;
+    return true;
+}
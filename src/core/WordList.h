@@ -0,0 +1,83 @@
+/*
+ *  Copyright (C) 2018 KeePassXC Team <team@keepassxc.org>
+ *
+ *  This program is free software: you can redistribute it and/or modify
+ *  it under the terms of the GNU General Public License as published by
+ *  the Free Software Foundation, either version 2 or (at your option)
+ *  version 3 of the License.
+ *
+ *  This program is distributed in the hope that it will be useful,
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *  GNU General Public License for more details.
+ *
+ *  You should have received a copy of the GNU General Public License
+ *  along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#ifndef KEEPASSX_WORDLIST_H
+#define KEEPASSX_WORDLIST_H
+
+#include <QByteArray>
+#include <QFile>
+#include <QSharedPointer>
+#include <QString>
+
+/**
+ * Read-only list of words with constant time access to every word.
+ *
+ * The list is stored as a table of word offsets followed by the UTF-8
+ * words without separators. Compiled word list files hold exactly this
+ * layout and are mapped into memory without parsing, plain text word
+ * lists (one word per line) are converted into it once when loaded.
+ *
+ * Compiled file layout, little endian:
+ *   8 bytes    magic "KPXCWORD"
+ *   quint32    version (1)
+ *   quint32    word count n
+ *   quint32    n + 1 ascending offsets into the words, the last one is
+ *              the size of the words
+ *   words
+ */
+class WordList
+{
+public:
+    ~WordList();
+    Q_DISABLE_COPY(WordList)
+
+    /**
+     * Returns the word list in path, compiled or plain text. Lists are
+     * cached by path until the file changes, so generators created for
+     * the same list share it.
+     *
+     * @return the word list, or nullptr if the file can't be read or is invalid
+     */
+    static QSharedPointer<const WordList> load(const QString& path);
+
+    int size() const;
+    QString word(int index) const;
+    /**
+     * Returns true if the list was mapped from a compiled file.
+     */
+    bool isMapped() const;
+    /**
+     * Writes the list in the compiled format.
+     */
+    bool writeCompiled(QIODevice* device) const;
+
+private:
+    WordList();
+    bool loadCompiled();
+    bool loadText();
+    bool setData(const uchar* data, qint64 size);
+
+    QFile m_file;
+    QByteArray m_buffer;
+    const uchar* m_data;
+    qint64 m_dataSize;
+    quint32 m_count;
+    const uchar* m_offsets;
+    const uchar* m_words;
+};
+
+#endif // KEEPASSX_WORDLIST_H
@@ -26,6 +26,7 @@
 #include "crypto/SymmetricCipher.h"
 
 bool Crypto::m_initalized(false);
+bool Crypto::m_selfTested(false);
 QString Crypto::m_errorStr;
 QString Crypto::m_backendVersion;
 
@@ -35,26 +36,39 @@ Crypto::Crypto()
 
 bool Crypto::init()
 {
-    if (m_initalized) {
+    if (m_selfTested) {
         qWarning("Crypto::init: already initalized");
         return true;
     }
 
-    m_backendVersion = QString::fromLocal8Bit(gcry_check_version(0));
-    gcry_control(GCRYCTL_INITIALIZATION_FINISHED, 0);
-
-    if (!checkAlgorithms()) {
+    // has to be initialized before testing Crypto classes
+    if (!initBackend()) {
         return false;
     }
 
-    // has to be set before testing Crypto classes
-    m_initalized = true;
-
     if (!selfTest()) {
         m_initalized = false;
         return false;
     }
 
+    m_selfTested = true;
+    return true;
+}
+
+bool Crypto::initBackend()
+{
+    if (m_initalized) {
+        return true;
+    }
+
+    m_backendVersion = QString::fromLocal8Bit(gcry_check_version(0));
+    gcry_control(GCRYCTL_INITIALIZATION_FINISHED, 0);
+
+    if (!checkAlgorithms()) {
+        return false;
+    }
+
+    m_initalized = true;
     return true;
 }
 
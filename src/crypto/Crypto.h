@@ -23,7 +23,16 @@
 class Crypto
 {
 public:
+    /**
+     * Initializes the backend and runs the self-tests of all algorithms.
+     */
     static bool init();
+    /**
+     * Initializes the backend and checks that all algorithms are available,
+     * without the self-tests, for programs that only need random numbers or
+     * hashes. init() can still be called afterwards to run the self-tests.
+     */
+    static bool initBackend();
     static bool initalized();
     static bool backendSelfTest();
     static QString errorString();
@@ -43,6 +52,7 @@ private:
     static bool testChaCha20();
 
     static bool m_initalized;
+    static bool m_selfTested;
     static QString m_errorStr;
     static QString m_backendVersion;
 };
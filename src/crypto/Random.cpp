@@ -17,8 +17,11 @@
 
 #include "Random.h"
 
+#include <cstring>
 #include <gcrypt.h>
 
+#include <QMutexLocker>
+
 #include "core/Global.h"
 #include "crypto/Crypto.h"
 
@@ -28,11 +31,42 @@ public:
     void randomize(void* data, int len) override;
 };
 
+class RandomBuffer
+{
+public:
+    explicit RandomBuffer(Random* random)
+        : m_random(random)
+        , m_pos(0)
+    {
+    }
+
+    ~RandomBuffer()
+    {
+        m_random->removeBuffer(this);
+        wipe();
+    }
+
+    void wipe()
+    {
+        memset(m_data.data(), 0, static_cast<size_t>(m_data.size()));
+        m_pos = m_data.size();
+    }
+
+    Random* m_random;
+    QMutex m_mutex;
+    QByteArray m_data;
+    int m_pos;
+};
+
 Random* Random::m_instance(nullptr);
 
+Random::~Random()
+{
+}
+
 void Random::randomize(QByteArray& ba)
 {
-    m_backend->randomize(ba.data(), ba.size());
+    read(ba.data(), ba.size());
 }
 
 QByteArray Random::randomArray(int len)
@@ -56,7 +90,7 @@ quint32 Random::randomUInt(quint32 limit)
     // To avoid modulo bias:
     // Make sure rand is below the largest number where rand%limit==0
     do {
-        m_backend->randomize(&rand, 4);
+        read(&rand, 4);
     } while (rand > ceil);
 
     return (rand % limit);
@@ -67,10 +101,38 @@ quint32 Random::randomUIntRange(quint32 min, quint32 max)
     return min + randomUInt(max - min);
 }
 
+void Random::setBufferSize(int size)
+{
+    Q_ASSERT(size >= 0);
+
+    QMutexLocker locker(&m_buffersMutex);
+    m_bufferSize.store(size);
+    for (RandomBuffer* buffer : asConst(m_buffers)) {
+        QMutexLocker bufferLocker(&buffer->m_mutex);
+        buffer->wipe();
+        buffer->m_data.clear();
+        buffer->m_pos = 0;
+    }
+}
+
+int Random::bufferSize() const
+{
+    return m_bufferSize.load();
+}
+
+void Random::wipeBuffers()
+{
+    QMutexLocker locker(&m_buffersMutex);
+    for (RandomBuffer* buffer : asConst(m_buffers)) {
+        QMutexLocker bufferLocker(&buffer->m_mutex);
+        buffer->wipe();
+    }
+}
+
 Random* Random::instance()
 {
     if (!m_instance) {
-        m_instance = new Random(new RandomBackendGcrypt());
+        m_instance = new Random(new RandomBackendGcrypt(), DefaultBufferSize);
     }
 
     return m_instance;
@@ -81,12 +143,62 @@ void Random::createWithBackend(RandomBackend* backend)
     Q_ASSERT(backend);
     Q_ASSERT(!m_instance);
 
-    m_instance = new Random(backend);
+    // custom backends are deterministic test sources, hand out their
+    // bytes exactly as requested unless buffering is enabled explicitly
+    m_instance = new Random(backend, 0);
 }
 
-Random::Random(RandomBackend* backend)
+Random::Random(RandomBackend* backend, int bufferSize)
     : m_backend(backend)
+    , m_bufferSize(bufferSize)
+{
+}
+
+void Random::read(void* data, int len)
+{
+    const int bufferSize = m_bufferSize.load();
+    if (bufferSize == 0 || len > bufferSize / 4) {
+        m_backend->randomize(data, len);
+        return;
+    }
+
+    RandomBuffer* buffer = threadBuffer();
+    QMutexLocker locker(&buffer->m_mutex);
+
+    if (buffer->m_data.size() != bufferSize) {
+        buffer->wipe();
+        buffer->m_data.resize(bufferSize);
+        buffer->m_pos = bufferSize;
+    }
+    if (len > buffer->m_data.size() - buffer->m_pos) {
+        m_backend->randomize(buffer->m_data.data(), buffer->m_data.size());
+        buffer->m_pos = 0;
+    }
+
+    // don't keep bytes around that have been handed out
+    char* bytes = buffer->m_data.data() + buffer->m_pos;
+    memcpy(data, bytes, static_cast<size_t>(len));
+    memset(bytes, 0, static_cast<size_t>(len));
+    buffer->m_pos += len;
+}
+
+RandomBuffer* Random::threadBuffer()
+{
+    if (!m_threadBuffers.hasLocalData()) {
+        // deleted by QThreadStorage when the thread exits
+        RandomBuffer* buffer = new RandomBuffer(this);
+        QMutexLocker locker(&m_buffersMutex);
+        m_buffers.append(buffer);
+        m_threadBuffers.setLocalData(buffer);
+    }
+
+    return m_threadBuffers.localData();
+}
+
+void Random::removeBuffer(RandomBuffer* buffer)
 {
+    QMutexLocker locker(&m_buffersMutex);
+    m_buffers.removeOne(buffer);
 }
 
 void RandomBackendGcrypt::randomize(void* data, int len)
@@ -18,8 +18,14 @@
 #ifndef KEEPASSX_RANDOM_H
 #define KEEPASSX_RANDOM_H
 
+#include <QAtomicInt>
 #include <QByteArray>
+#include <QList>
+#include <QMutex>
 #include <QScopedPointer>
+#include <QThreadStorage>
+
+class RandomBuffer;
 
 class RandomBackend
 {
@@ -30,9 +36,20 @@ public:
     }
 };
 
+/**
+ * Front-end of the random backend.
+ *
+ * Small requests are served from a per-thread buffer that is refilled
+ * from the backend in blocks of bufferSize() bytes, so drawing many
+ * random numbers doesn't cost a backend call each. Bytes are zeroed in
+ * the buffer as soon as they are handed out. Requests larger than a
+ * quarter of the buffer go to the backend directly.
+ */
 class Random
 {
 public:
+    ~Random();
+
     void randomize(QByteArray& ba);
     QByteArray randomArray(int len);
 
@@ -46,15 +63,39 @@ public:
      */
     quint32 randomUIntRange(quint32 min, quint32 max);
 
+    /**
+     * Set the size of the per-thread buffers, 0 disables buffering.
+     * The buffered bytes of all threads are wiped.
+     */
+    void setBufferSize(int size);
+    int bufferSize() const;
+
+    /**
+     * Overwrite and discard the buffered bytes of all threads, e.g. when
+     * a database is locked.
+     */
+    void wipeBuffers();
+
+    static const int DefaultBufferSize = 4096;
+
     static Random* instance();
     static void createWithBackend(RandomBackend* backend);
 
 private:
-    explicit Random(RandomBackend* backend);
+    Random(RandomBackend* backend, int bufferSize);
+    void read(void* data, int len);
+    RandomBuffer* threadBuffer();
+    void removeBuffer(RandomBuffer* buffer);
 
     QScopedPointer<RandomBackend> m_backend;
+    QAtomicInt m_bufferSize;
+    QMutex m_buffersMutex;
+    QList<RandomBuffer*> m_buffers;
+    QThreadStorage<RandomBuffer*> m_threadBuffers;
     static Random* m_instance;
 
+    friend class RandomBuffer;
+
     Q_DISABLE_COPY(Random)
 };
 
@@ -47,7 +47,7 @@ bool AesKdf::processParameters(const QVariantMap& p)
     return setSeed(seed);
 }
 
-QVariantMap AesKdf::writeParameters()
+QVariantMap AesKdf::writeParameters() const
 {
     QVariantMap p;
 
@@ -27,7 +27,7 @@ public:
     explicit AesKdf(bool legacyKdbx3);
 
     bool processParameters(const QVariantMap& p) override;
-    QVariantMap writeParameters() override;
+    QVariantMap writeParameters() const override;
     bool transform(const QByteArray& raw, QByteArray& result) const override;
     QSharedPointer<Kdf> clone() const override;
 
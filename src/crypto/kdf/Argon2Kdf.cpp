@@ -130,7 +130,7 @@ bool Argon2Kdf::processParameters(const QVariantMap& p)
     return true;
 }
 
-QVariantMap Argon2Kdf::writeParameters()
+QVariantMap Argon2Kdf::writeParameters() const
 {
     QVariantMap p;
     p.insert(KeePass2::KDFPARAM_UUID, KeePass2::KDF_ARGON2.toByteArray());
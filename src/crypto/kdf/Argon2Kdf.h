@@ -26,7 +26,7 @@ public:
     Argon2Kdf();
 
     bool processParameters(const QVariantMap& p) override;
-    QVariantMap writeParameters() override;
+    QVariantMap writeParameters() const override;
     bool transform(const QByteArray& raw, QByteArray& result) const override;
     QSharedPointer<Kdf> clone() const override;
 
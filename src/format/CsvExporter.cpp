@@ -64,8 +64,7 @@ bool CsvExporter::writeGroup(QIODevice* device, const Group* group, QString grou
     }
     groupPath.append(group->name());
 
-    const QList<Entry*> entryList = group->entries();
-    for (const Entry* entry : entryList) {
+    for (const Entry* entry : group->entries()) {
         QString line;
 
         addColumn(line, groupPath);
@@ -83,8 +82,7 @@ bool CsvExporter::writeGroup(QIODevice* device, const Group* group, QString grou
         }
     }
 
-    const QList<Group*> children = group->children();
-    for (const Group* child : children) {
+    for (const Group* child : group->children()) {
         if (!writeGroup(device, child, groupPath)) {
             return false;
         }
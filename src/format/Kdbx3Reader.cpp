@@ -110,6 +110,11 @@ Database* Kdbx3Reader::readDatabaseImpl(QIODevice* device,
         return nullptr;
     }
 
+    if (writesXml()) {
+        writeXml(xmlDevice, &randomStream);
+        return nullptr;
+    }
+
     QBuffer buffer;
     if (saveXml()) {
         m_xmlData = xmlDevice->readAll();
@@ -124,6 +124,11 @@ Database* Kdbx4Reader::readDatabaseImpl(QIODevice* device,
         return nullptr;
     }
 
+    if (writesXml()) {
+        writeXml(xmlDevice, &randomStream);
+        return nullptr;
+    }
+
     QBuffer buffer;
     if (saveXml()) {
         m_xmlData = xmlDevice->readAll();
@@ -219,23 +219,25 @@ bool Kdbx4Writer::writeInnerHeaderField(QIODevice* device, KeePass2::InnerHeader
 
 void Kdbx4Writer::writeAttachments(QIODevice* device, Database* db)
 {
-    const QList<Entry*> allEntries = db->rootGroup()->entriesRecursive(true);
     QSet<QByteArray> writtenAttachments;
 
-    for (Entry* entry : allEntries) {
-        const QList<QString> attachmentKeys = entry->attachments()->keys();
-        for (const QString& key : attachmentKeys) {
-            QByteArray data("\x01");
-            data.append(entry->attachments()->value(key));
+    db->rootGroup()->walkEntries(
+        [this, device, &writtenAttachments](const Entry* entry) {
+            const QList<QString> attachmentKeys = entry->attachments()->keys();
+            for (const QString& key : attachmentKeys) {
+                QByteArray data("\x01");
+                data.append(entry->attachments()->value(key));
 
-            if (writtenAttachments.contains(data)) {
-                continue;
-            }
+                if (writtenAttachments.contains(data)) {
+                    continue;
+                }
 
-            writeInnerHeaderField(device, KeePass2::InnerHeaderFieldID::Binary, data);
-            writtenAttachments.insert(data);
-        }
-    }
+                writeInnerHeaderField(device, KeePass2::InnerHeaderFieldID::Binary, data);
+                writtenAttachments.insert(data);
+            }
+            return false;
+        },
+        true);
 }
 
 /**
@@ -0,0 +1,140 @@
+/*
+ *  Copyright (C) 2018 KeePassXC Team <team@keepassxc.org>
+ *
+ *  This program is free software: you can redistribute it and/or modify
+ *  it under the terms of the GNU General Public License as published by
+ *  the Free Software Foundation, either version 2 or (at your option)
+ *  version 3 of the License.
+ *
+ *  This program is distributed in the hope that it will be useful,
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *  GNU General Public License for more details.
+ *
+ *  You should have received a copy of the GNU General Public License
+ *  along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#include "KdbxFingerprint.h"
+
+#include <QFile>
+#include <QFileInfo>
+
+#include "core/Endian.h"
+#include "crypto/CryptoHash.h"
+#include "format/KeePass2.h"
+
+namespace
+{
+    /**
+     * Append the next length bytes of device to data.
+     */
+    bool readInto(QIODevice* device, QByteArray& data, qint64 length)
+    {
+        QByteArray chunk = device->read(length);
+        data.append(chunk);
+        return chunk.size() == length;
+    }
+} // namespace
+
+KdbxFingerprint KdbxFingerprint::fromFile(const QString& filePath)
+{
+    QFile file(filePath);
+    if (!file.open(QIODevice::ReadOnly)) {
+        return {};
+    }
+
+    KdbxFingerprint fingerprint = fromDevice(&file);
+    fingerprint.m_lastModified = QFileInfo(file).lastModified();
+    return fingerprint;
+}
+
+KdbxFingerprint KdbxFingerprint::fromDevice(QIODevice* device)
+{
+    device->seek(0);
+
+    QByteArray data;
+    if (!readInto(device, data, 12)) {
+        return {};
+    }
+
+    bool ok;
+    const quint32 sig1 = Endian::bytesToSizedInt<quint32>(data.mid(0, 4), KeePass2::BYTEORDER);
+    const quint32 sig2 = Endian::bytesToSizedInt<quint32>(data.mid(4, 4), KeePass2::BYTEORDER);
+    const quint32 version =
+        Endian::bytesToSizedInt<quint32>(data.mid(8, 4), KeePass2::BYTEORDER) & KeePass2::FILE_VERSION_CRITICAL_MASK;
+    if (sig1 != KeePass2::SIGNATURE_1 || sig2 != KeePass2::SIGNATURE_2 || version < KeePass2::FILE_VERSION_3
+        || version > KeePass2::FILE_VERSION_4) {
+        return {};
+    }
+
+    // header fields are (id, length, data) with a 16 bit length in KDBX 3 and a 32 bit length in KDBX 4
+    const bool isKdbx4 = version == KeePass2::FILE_VERSION_4;
+    char fieldId;
+    do {
+        if (!readInto(device, data, 1)) {
+            return {};
+        }
+        fieldId = data.at(data.size() - 1);
+
+        quint32 fieldLength;
+        if (isKdbx4) {
+            fieldLength = Endian::readSizedInt<quint32>(device, KeePass2::BYTEORDER, &ok);
+            data.append(Endian::sizedIntToBytes<quint32>(fieldLength, KeePass2::BYTEORDER));
+        } else {
+            fieldLength = Endian::readSizedInt<quint16>(device, KeePass2::BYTEORDER, &ok);
+            data.append(Endian::sizedIntToBytes<quint16>(static_cast<quint16>(fieldLength), KeePass2::BYTEORDER));
+        }
+        if (!ok || !readInto(device, data, fieldLength)) {
+            return {};
+        }
+    } while (fieldId != static_cast<char>(KeePass2::HeaderFieldID::EndOfHeader));
+
+    if (isKdbx4) {
+        // header SHA-256 and HMAC, followed by the HMAC and length of the first
+        // payload block; the block HMAC covers the block content
+        if (!readInto(device, data, 32 + 32 + 32 + 4)) {
+            return {};
+        }
+    } else {
+        // first cipher block, which encrypts the stream start bytes
+        if (!readInto(device, data, 32)) {
+            return {};
+        }
+    }
+
+    KdbxFingerprint fingerprint;
+    fingerprint.m_size = device->size();
+    fingerprint.m_hash = CryptoHash::hash(data, CryptoHash::Sha256);
+    return fingerprint;
+}
+
+bool KdbxFingerprint::isValid() const
+{
+    return !m_hash.isEmpty();
+}
+
+qint64 KdbxFingerprint::size() const
+{
+    return m_size;
+}
+
+QDateTime KdbxFingerprint::lastModified() const
+{
+    return m_lastModified;
+}
+
+QByteArray KdbxFingerprint::hash() const
+{
+    return m_hash;
+}
+
+bool KdbxFingerprint::operator==(const KdbxFingerprint& other) const
+{
+    return isValid() && m_size == other.m_size && m_hash == other.m_hash;
+}
+
+bool KdbxFingerprint::operator!=(const KdbxFingerprint& other) const
+{
+    return !(*this == other);
+}
@@ -0,0 +1,65 @@
+/*
+ *  Copyright (C) 2018 KeePassXC Team <team@keepassxc.org>
+ *
+ *  This program is free software: you can redistribute it and/or modify
+ *  it under the terms of the GNU General Public License as published by
+ *  the Free Software Foundation, either version 2 or (at your option)
+ *  version 3 of the License.
+ *
+ *  This program is distributed in the hope that it will be useful,
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *  GNU General Public License for more details.
+ *
+ *  You should have received a copy of the GNU General Public License
+ *  along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#ifndef KEEPASSX_KDBXFINGERPRINT_H
+#define KEEPASSX_KDBXFINGERPRINT_H
+
+#include <QByteArray>
+#include <QDateTime>
+#include <QString>
+
+class QIODevice;
+
+/**
+ * Cheap identity of a KDBX file that can be computed without the key.
+ *
+ * Every save randomizes the master seed and the encryption IV in the
+ * header, and the first HMAC block authenticates the start of the
+ * payload, so a SHA-256 over the outer header and the first block
+ * header changes whenever the database is rewritten with new content.
+ * The modification time is recorded but not compared: touching the file
+ * or rewriting identical bytes changes it without changing the database.
+ */
+class KdbxFingerprint
+{
+public:
+    static KdbxFingerprint fromFile(const QString& filePath);
+    /**
+     * Computes the fingerprint of the file in device, starting at offset 0.
+     * Only the header and the first block header are read.
+     */
+    static KdbxFingerprint fromDevice(QIODevice* device);
+
+    /**
+     * Returns false if the file could not be read or is not a KDBX 3/4
+     * file. Invalid fingerprints never compare equal.
+     */
+    bool isValid() const;
+    qint64 size() const;
+    QDateTime lastModified() const;
+    QByteArray hash() const;
+
+    bool operator==(const KdbxFingerprint& other) const;
+    bool operator!=(const KdbxFingerprint& other) const;
+
+private:
+    qint64 m_size = -1;
+    QDateTime m_lastModified;
+    QByteArray m_hash;
+};
+
+#endif // KEEPASSX_KDBXFINGERPRINT_H
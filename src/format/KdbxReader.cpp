@@ -18,6 +18,20 @@
 #include "KdbxReader.h"
 #include "core/Database.h"
 #include "core/Endian.h"
+#include "format/KeePass2RandomStream.h"
+
+#include <QXmlStreamReader>
+#include <QXmlStreamWriter>
+
+namespace
+{
+    const qint64 XmlChunkSize = 64 * 1024;
+
+    bool isTrueValue(const QStringRef& value)
+    {
+        return value.compare(QLatin1String("true"), Qt::CaseInsensitive) == 0 || value == "1";
+    }
+} // namespace
 
 /**
  * Read KDBX magic header numbers from a device.
@@ -118,6 +132,100 @@ QByteArray KdbxReader::xmlData() const
     return m_xmlData;
 }
 
+void KdbxReader::setXmlOutput(QIODevice* device, bool unprotect)
+{
+    m_xmlOutput = device;
+    m_unprotectXml = unprotect;
+}
+
+bool KdbxReader::writesXml() const
+{
+    return m_xmlOutput != nullptr;
+}
+
+/**
+ * Copy the decrypted XML from xmlDevice to the XML output in chunks,
+ * without building the database.
+ *
+ * @param xmlDevice decrypted and decompressed payload after the inner header
+ * @param randomStream initialized inner stream, used to unprotect values
+ */
+void KdbxReader::writeXml(QIODevice* xmlDevice, KeePass2RandomStream* randomStream)
+{
+    if (m_unprotectXml) {
+        writeUnprotectedXml(xmlDevice, randomStream);
+        return;
+    }
+
+    QByteArray chunk(XmlChunkSize, Qt::Uninitialized);
+    qint64 readSize;
+    while ((readSize = xmlDevice->read(chunk.data(), chunk.size())) > 0) {
+        if (m_xmlOutput->write(chunk.constData(), readSize) != readSize) {
+            raiseError(m_xmlOutput->errorString());
+            return;
+        }
+    }
+
+    if (readSize < 0) {
+        raiseError(xmlDevice->errorString());
+    }
+}
+
+/**
+ * Rewrite the XML token by token, replacing protected values with their
+ * plain text. The inner stream has to be applied to the protected values
+ * in document order, like KdbxXmlReader does. Strings keep the
+ * ProtectInMemory flag like in a KeePass XML export, binaries stay base64.
+ */
+void KdbxReader::writeUnprotectedXml(QIODevice* xmlDevice, KeePass2RandomStream* randomStream)
+{
+    QXmlStreamReader xml(xmlDevice);
+    QXmlStreamWriter writer(m_xmlOutput);
+
+    while (!xml.atEnd() && !xml.hasError()) {
+        xml.readNext();
+        if (!xml.isStartElement() || !isTrueValue(xml.attributes().value("Protected"))) {
+            writer.writeCurrentToken(xml);
+            continue;
+        }
+
+        const QString name = xml.qualifiedName().toString();
+        QXmlStreamAttributes attributes;
+        for (const QXmlStreamAttribute& attribute : xml.attributes()) {
+            if (attribute.qualifiedName() != "Protected") {
+                attributes.append(attribute);
+            }
+        }
+
+        QByteArray data = QByteArray::fromBase64(xml.readElementText().toLatin1());
+        if (!data.isEmpty()) {
+            bool ok;
+            data = randomStream->process(data, &ok);
+            if (!ok) {
+                raiseError(randomStream->errorString());
+                return;
+            }
+        }
+
+        writer.writeStartElement(name);
+        if (name == "Value") {
+            attributes.append("ProtectInMemory", "True");
+            writer.writeAttributes(attributes);
+            writer.writeCharacters(QString::fromUtf8(data));
+        } else {
+            writer.writeAttributes(attributes);
+            writer.writeCharacters(QString::fromLatin1(data.toBase64()));
+        }
+        writer.writeEndElement();
+    }
+
+    if (xml.hasError()) {
+        raiseError(xml.errorString());
+    } else if (writer.hasError()) {
+        raiseError(m_xmlOutput->errorString());
+    }
+}
+
 QByteArray KdbxReader::streamKey() const
 {
     return m_protectedStreamKey;
@@ -26,6 +26,7 @@
 #include <QPointer>
 
 class Database;
+class KeePass2RandomStream;
 class QIODevice;
 
 /**
@@ -48,6 +49,15 @@ public:
     bool saveXml() const;
     void setSaveXml(bool save);
     QByteArray xmlData() const;
+    /**
+     * Write the decrypted XML to device while it is being decrypted instead
+     * of reading the database. readDatabase() returns nullptr in this mode,
+     * success is indicated by hasError() only.
+     *
+     * @param device output device, nullptr to read the database again
+     * @param unprotect write protected values in plain text
+     */
+    void setXmlOutput(QIODevice* device, bool unprotect = false);
     QByteArray streamKey() const;
     KeePass2::ProtectedStreamAlgo protectedStreamAlgo() const;
 
@@ -83,6 +93,8 @@ protected:
     virtual void setInnerRandomStreamID(const QByteArray& data);
 
     void raiseError(const QString& errorMessage);
+    bool writesXml() const;
+    void writeXml(QIODevice* xmlDevice, KeePass2RandomStream* randomStream);
 
     QScopedPointer<Database> m_db;
 
@@ -98,7 +110,11 @@ protected:
     QByteArray m_xmlData;
 
 private:
+    void writeUnprotectedXml(QIODevice* xmlDevice, KeePass2RandomStream* randomStream);
+
     bool m_saveXml = false;
+    QIODevice* m_xmlOutput = nullptr;
+    bool m_unprotectXml = false;
     bool m_error = false;
     QString m_errorStr = "";
 };
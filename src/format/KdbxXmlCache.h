@@ -0,0 +1,70 @@
+/*
+ *  Copyright (C) 2018 KeePassXC Team <team@keepassxc.org>
+ *
+ *  This program is free software: you can redistribute it and/or modify
+ *  it under the terms of the GNU General Public License as published by
+ *  the Free Software Foundation, either version 2 or (at your option)
+ *  version 3 of the License.
+ *
+ *  This program is distributed in the hope that it will be useful,
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *  GNU General Public License for more details.
+ *
+ *  You should have received a copy of the GNU General Public License
+ *  along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#ifndef KEEPASSX_KDBXXMLCACHE_H
+#define KEEPASSX_KDBXXMLCACHE_H
+
+#include <QByteArray>
+#include <QHash>
+#include <QList>
+
+class Entry;
+class Group;
+
+/**
+ * Serialized XML of a single entry (including its history) or of the
+ * data section of a group.
+ *
+ * Protected values and binary references cannot be stored in their final
+ * form because they depend on the inner random stream position and on
+ * the attachment id map of the save in progress. They are kept as separate
+ * segments and resolved by KdbxXmlWriter while splicing the fragment.
+ */
+struct KdbxXmlFragment
+{
+    enum SegmentType
+    {
+        RawSegment,
+        ProtectedValueSegment,
+        BinaryRefSegment
+    };
+
+    struct Segment
+    {
+        SegmentType type;
+        QByteArray data;
+    };
+
+    quint64 revision = 0;
+    quint64 context = 0;
+    QList<Segment> segments;
+};
+
+Q_DECLARE_TYPEINFO(KdbxXmlFragment::Segment, Q_MOVABLE_TYPE);
+
+/**
+ * Fragments of the last save of a database, keyed by the object they
+ * were generated from. A fragment is only reused if the revision of the
+ * object still matches.
+ */
+struct KdbxXmlCache
+{
+    QHash<const Entry*, KdbxXmlFragment> entries;
+    QHash<const Group*, KdbxXmlFragment> groups;
+};
+
+#endif // KEEPASSX_KDBXXMLCACHE_H
@@ -49,6 +49,9 @@ void KdbxXmlWriter::writeDatabase(QIODevice* device,
 
     generateIdMap();
 
+    m_fragmentContext = fragmentContext();
+    m_cache = KdbxXmlCache();
+
     m_xml.setDevice(device);
     m_xml.writeStartDocument("1.0", true);
     m_xml.writeStartElement("KeePassFile");
@@ -62,6 +65,14 @@ void KdbxXmlWriter::writeDatabase(QIODevice* device,
     if (m_xml.hasError()) {
         raiseError(device->errorString());
     }
+
+    // keep only the fragments of objects that are still part of the database
+    if (m_error) {
+        *db->xmlCache() = KdbxXmlCache();
+    } else {
+        qSwap(*db->xmlCache(), m_cache);
+    }
+    m_cache = KdbxXmlCache();
 }
 
 void KdbxXmlWriter::writeDatabase(const QString& filename, Database* db)
@@ -83,18 +94,20 @@ QString KdbxXmlWriter::errorString()
 
 void KdbxXmlWriter::generateIdMap()
 {
-    const QList<Entry*> allEntries = m_db->rootGroup()->entriesRecursive(true);
     int nextId = 0;
 
-    for (Entry* entry : allEntries) {
-        const QList<QString> attachmentKeys = entry->attachments()->keys();
-        for (const QString& key : attachmentKeys) {
-            QByteArray data = entry->attachments()->value(key);
-            if (!m_idMap.contains(data)) {
-                m_idMap.insert(data, nextId++);
+    m_db->rootGroup()->walkEntries(
+        [this, &nextId](const Entry* entry) {
+            const QList<QString> attachmentKeys = entry->attachments()->keys();
+            for (const QString& key : attachmentKeys) {
+                QByteArray data = entry->attachments()->value(key);
+                if (!m_idMap.contains(data)) {
+                    m_idMap.insert(data, nextId++);
+                }
             }
-        }
-    }
+            return false;
+        },
+        true);
 }
 
 void KdbxXmlWriter::writeMetadata()
@@ -263,6 +276,23 @@ void KdbxXmlWriter::writeGroup(const Group* group)
 
     m_xml.writeStartElement("Group");
 
+    writeFragment(groupFragment(group));
+
+    const QList<Entry*>& entryList = group->entries();
+    for (const Entry* entry : entryList) {
+        writeFragment(entryFragment(entry));
+    }
+
+    const QList<Group*>& children = group->children();
+    for (const Group* child : children) {
+        writeGroup(child);
+    }
+
+    m_xml.writeEndElement();
+}
+
+void KdbxXmlWriter::writeGroupData(const Group* group)
+{
     writeUuid("UUID", group->uuid());
     writeString("Name", group->name());
     writeString("Notes", group->notes());
@@ -284,18 +314,6 @@ void KdbxXmlWriter::writeGroup(const Group* group)
     if (m_kdbxVersion >= KeePass2::FILE_VERSION_4) {
         writeCustomData(group->customData());
     }
-
-    const QList<Entry*>& entryList = group->entries();
-    for (const Entry* entry : entryList) {
-        writeEntry(entry);
-    }
-
-    const QList<Group*>& children = group->children();
-    for (const Group* child : children) {
-        writeGroup(child);
-    }
-
-    m_xml.writeEndElement();
 }
 
 void KdbxXmlWriter::writeTimes(const TimeInfo& ti)
@@ -338,6 +356,7 @@ void KdbxXmlWriter::writeDeletedObject(const DeletedObject& delObj)
 void KdbxXmlWriter::writeEntry(const Entry* entry)
 {
     Q_ASSERT(!entry->uuid().isNull());
+    Q_ASSERT(m_fragment);
 
     m_xml.writeStartElement("Entry");
 
@@ -370,13 +389,10 @@ void KdbxXmlWriter::writeEntry(const Entry* entry)
 
         if (protect) {
             if (m_randomStream) {
+                // the value is encrypted when the fragment is written to the output
                 m_xml.writeAttribute("Protected", "True");
-                bool ok;
-                QByteArray rawData = m_randomStream->process(entry->attributes()->value(key).toUtf8(), &ok);
-                if (!ok) {
-                    raiseError(m_randomStream->errorString());
-                }
-                value = QString::fromLatin1(rawData.toBase64());
+                m_xml.writeCharacters(QString());
+                endFragmentSegment(KdbxXmlFragment::ProtectedValueSegment, entry->attributes()->value(key).toUtf8());
             } else {
                 m_xml.writeAttribute("ProtectInMemory", "True");
                 value = entry->attributes()->value(key);
@@ -399,8 +415,9 @@ void KdbxXmlWriter::writeEntry(const Entry* entry)
 
         writeString("Key", key);
 
+        // the Ref attribute is added when the fragment is written to the output
         m_xml.writeStartElement("Value");
-        m_xml.writeAttribute("Ref", QString::number(m_idMap[entry->attachments()->value(key)]));
+        endFragmentSegment(KdbxXmlFragment::BinaryRefSegment, entry->attachments()->value(key));
         m_xml.writeEndElement();
 
         m_xml.writeEndElement();
@@ -458,6 +475,153 @@ void KdbxXmlWriter::writeEntryHistory(const Entry* entry)
     m_xml.writeEndElement();
 }
 
+/**
+ * Identifies everything besides the serialized object itself that a fragment
+ * depends on. Cached fragments are discarded if this changes between saves.
+ */
+quint64 KdbxXmlWriter::fragmentContext() const
+{
+    quint64 context = static_cast<quint64>(m_kdbxVersion) << 8;
+    context |= m_randomStream ? 0x01 : 0x00;
+    context |= m_meta->protectTitle() ? 0x02 : 0x00;
+    context |= m_meta->protectUsername() ? 0x04 : 0x00;
+    context |= m_meta->protectPassword() ? 0x08 : 0x00;
+    context |= m_meta->protectUrl() ? 0x10 : 0x00;
+    context |= m_meta->protectNotes() ? 0x20 : 0x00;
+    return context;
+}
+
+const KdbxXmlFragment& KdbxXmlWriter::groupFragment(const Group* group)
+{
+    // LastTopVisibleEntry is written as a weak reference that is reset without notice
+    const quint64 context = m_fragmentContext | (group->lastTopVisibleEntry() ? 0x40 : 0x00);
+
+    const KdbxXmlFragment cached = m_db->xmlCache()->groups.value(group);
+    if (cached.revision == group->revision() && cached.context == context) {
+        return m_cache.groups[group] = cached;
+    }
+
+    QBuffer buffer;
+    KdbxXmlFragment fragment;
+    KdbxXmlWriter writer(m_kdbxVersion);
+    beginFragment(writer, &buffer, &fragment);
+
+    // open the element in the scratch writer only, the caller owns the real one
+    writer.m_xml.writeStartElement("Group");
+    writer.m_xml.writeCharacters(QString());
+    writer.m_fragmentPos = buffer.pos();
+
+    writer.writeGroupData(group);
+    writer.endFragmentSegment();
+
+    if (writer.hasError()) {
+        raiseError(writer.errorString());
+    }
+
+    fragment.revision = group->revision();
+    fragment.context = context;
+    return m_cache.groups[group] = fragment;
+}
+
+const KdbxXmlFragment& KdbxXmlWriter::entryFragment(const Entry* entry)
+{
+    const KdbxXmlFragment cached = m_db->xmlCache()->entries.value(entry);
+    if (cached.revision == entry->revision() && cached.context == m_fragmentContext) {
+        return m_cache.entries[entry] = cached;
+    }
+
+    QBuffer buffer;
+    KdbxXmlFragment fragment;
+    KdbxXmlWriter writer(m_kdbxVersion);
+    beginFragment(writer, &buffer, &fragment);
+
+    writer.writeEntry(entry);
+    writer.endFragmentSegment();
+
+    if (writer.hasError()) {
+        raiseError(writer.errorString());
+    }
+
+    fragment.revision = entry->revision();
+    fragment.context = m_fragmentContext;
+    return m_cache.entries[entry] = fragment;
+}
+
+/**
+ * Prepare a scratch writer that serializes into a fragment instead of the
+ * output device.
+ */
+void KdbxXmlWriter::beginFragment(KdbxXmlWriter& writer, QBuffer* buffer, KdbxXmlFragment* fragment) const
+{
+    buffer->open(QIODevice::WriteOnly);
+
+    writer.m_db = m_db;
+    writer.m_meta = m_meta;
+    writer.m_randomStream = m_randomStream;
+    writer.m_fragmentBuffer = buffer;
+    writer.m_fragment = fragment;
+    writer.m_fragmentPos = 0;
+
+    writer.m_xml.setAutoFormatting(true);
+    writer.m_xml.setAutoFormattingIndent(-1); // 1 tab
+    writer.m_xml.setCodec("UTF-8");
+    writer.m_xml.setDevice(buffer);
+}
+
+/**
+ * Close the raw segment written so far and optionally append a segment
+ * that is resolved when the fragment is written to the output.
+ */
+void KdbxXmlWriter::endFragmentSegment(KdbxXmlFragment::SegmentType type, const QByteArray& data)
+{
+    Q_ASSERT(m_fragment && m_fragmentBuffer);
+
+    const QByteArray& written = m_fragmentBuffer->data();
+    if (written.size() > m_fragmentPos) {
+        m_fragment->segments.append({KdbxXmlFragment::RawSegment, written.mid(m_fragmentPos)});
+        m_fragmentPos = written.size();
+    }
+
+    if (type != KdbxXmlFragment::RawSegment) {
+        m_fragment->segments.append({type, data});
+    }
+}
+
+void KdbxXmlWriter::writeFragment(const KdbxXmlFragment& fragment)
+{
+    // finish a pending start tag, everything below bypasses m_xml
+    m_xml.writeCharacters(QString());
+
+    QIODevice* device = m_xml.device();
+    for (const KdbxXmlFragment::Segment& segment : fragment.segments) {
+        QByteArray data;
+
+        switch (segment.type) {
+        case KdbxXmlFragment::RawSegment:
+            data = segment.data;
+            break;
+        case KdbxXmlFragment::ProtectedValueSegment: {
+            Q_ASSERT(m_randomStream);
+            bool ok;
+            QByteArray rawData = m_randomStream->process(segment.data, &ok);
+            if (!ok) {
+                raiseError(m_randomStream->errorString());
+            }
+            data = rawData.toBase64();
+            break;
+        }
+        case KdbxXmlFragment::BinaryRefSegment:
+            data = " Ref=\"" + QByteArray::number(m_idMap.value(segment.data)) + "\"";
+            break;
+        }
+
+        if (device->write(data) != data.size()) {
+            raiseError(device->errorString());
+            return;
+        }
+    }
+}
+
 void KdbxXmlWriter::writeString(const QString& qualifiedName, const QString& string)
 {
     if (string.isEmpty()) {
@@ -28,7 +28,9 @@
 #include "core/Group.h"
 #include "core/TimeInfo.h"
 #include "core/Uuid.h"
+#include "format/KdbxXmlCache.h"
 
+class QBuffer;
 class KeePass2RandomStream;
 class Metadata;
 
@@ -57,6 +59,7 @@ private:
     void writeCustomDataItem(const QString& key, const QString& value);
     void writeRoot();
     void writeGroup(const Group* group);
+    void writeGroupData(const Group* group);
     void writeTimes(const TimeInfo& ti);
     void writeDeletedObjects();
     void writeDeletedObject(const DeletedObject& delObj);
@@ -65,6 +68,14 @@ private:
     void writeAutoTypeAssoc(const AutoTypeAssociations::Association& assoc);
     void writeEntryHistory(const Entry* entry);
 
+    quint64 fragmentContext() const;
+    const KdbxXmlFragment& groupFragment(const Group* group);
+    const KdbxXmlFragment& entryFragment(const Entry* entry);
+    void beginFragment(KdbxXmlWriter& writer, QBuffer* buffer, KdbxXmlFragment* fragment) const;
+    void endFragmentSegment(KdbxXmlFragment::SegmentType type = KdbxXmlFragment::RawSegment,
+                            const QByteArray& data = QByteArray());
+    void writeFragment(const KdbxXmlFragment& fragment);
+
     void writeString(const QString& qualifiedName, const QString& string);
     void writeNumber(const QString& qualifiedName, int number);
     void writeBool(const QString& qualifiedName, bool b);
@@ -89,6 +100,12 @@ private:
     QHash<QByteArray, int> m_idMap;
     QByteArray m_headerHash;
 
+    KdbxXmlCache m_cache;
+    quint64 m_fragmentContext = 0;
+    QBuffer* m_fragmentBuffer = nullptr;
+    KdbxXmlFragment* m_fragment = nullptr;
+    qint64 m_fragmentPos = 0;
+
     bool m_error = false;
 
     QString m_errorStr = "";
@@ -93,6 +93,7 @@ Database* KeePass2Reader::readDatabase(QIODevice* device, const CompositeKey& ke
     }
 
     m_reader->setSaveXml(m_saveXml);
+    m_reader->setXmlOutput(m_xmlOutput, m_unprotectXml);
     return m_reader->readDatabase(device, key, keepDatabase);
 }
 
@@ -116,6 +117,17 @@ void KeePass2Reader::setSaveXml(bool save)
     m_saveXml = save;
 }
 
+/**
+ * Write the decrypted XML to device instead of reading the database.
+ *
+ * @see KdbxReader::setXmlOutput()
+ */
+void KeePass2Reader::setXmlOutput(QIODevice* device, bool unprotect)
+{
+    m_xmlOutput = device;
+    m_unprotectXml = unprotect;
+}
+
 /**
  * @return detected KDBX version
  */
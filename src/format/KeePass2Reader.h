@@ -43,6 +43,7 @@ public:
 
     bool saveXml() const;
     void setSaveXml(bool save);
+    void setXmlOutput(QIODevice* device, bool unprotect = false);
 
     QSharedPointer<KdbxReader> reader() const;
     quint32 version() const;
@@ -51,6 +52,8 @@ private:
     void raiseError(const QString& errorMessage);
 
     bool m_saveXml = false;
+    QIODevice* m_xmlOutput = nullptr;
+    bool m_unprotectXml = false;
     bool m_error = false;
     QString m_errorStr = "";
 
@@ -52,7 +52,7 @@ bool KeePass2Writer::implicitUpgradeNeeded(Database const* db) const
         return true;
     }
 
-    for (const auto& group : db->rootGroup()->groupsRecursive(true)) {
+    return db->rootGroup()->walkGroups([](const Group* group) {
         if (group->customData() && !group->customData()->isEmpty()) {
             return true;
         }
@@ -68,9 +68,9 @@ bool KeePass2Writer::implicitUpgradeNeeded(Database const* db) const
                 }
             }
         }
-    }
 
-    return false;
+        return false;
+    });
 }
 
 /**
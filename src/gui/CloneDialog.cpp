@@ -20,6 +20,7 @@
 
 #include "config-keepassx.h"
 #include "core/Database.h"
+#include "core/DatabaseAccess.h"
 #include "core/Entry.h"
 #include "core/FilePath.h"
 #include "crypto/Crypto.h"
@@ -60,6 +61,7 @@ void CloneDialog::cloneEntry()
         flags |= Entry::CloneIncludeHistory;
     }
 
+    DatabaseAccess::WriteLocker locker;
     Entry* entry = m_entry->clone(flags);
     entry->setGroup(m_entry->group());
 
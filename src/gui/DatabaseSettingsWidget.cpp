@@ -28,6 +28,7 @@
 #include "MessageBox.h"
 #include "core/AsyncTask.h"
 #include "core/Database.h"
+#include "core/DatabaseAccess.h"
 #include "core/FilePath.h"
 #include "core/Global.h"
 #include "core/Group.h"
@@ -179,46 +180,50 @@ void DatabaseSettingsWidget::save()
         }
     }
 
-    m_db->setCompressionAlgo(m_uiGeneral->compressionCheckbox->isChecked() ? Database::CompressionGZip
-                                                                           : Database::CompressionNone);
+    {
+        // the KDF is changed below without the lock, it runs the key transformation
+        DatabaseAccess::WriteLocker locker;
+        m_db->setCompressionAlgo(m_uiGeneral->compressionCheckbox->isChecked() ? Database::CompressionGZip
+                                                                               : Database::CompressionNone);
 
-    Metadata* meta = m_db->metadata();
+        Metadata* meta = m_db->metadata();
 
-    meta->setName(m_uiGeneral->dbNameEdit->text());
-    meta->setDescription(m_uiGeneral->dbDescriptionEdit->text());
-    meta->setDefaultUserName(m_uiGeneral->defaultUsernameEdit->text());
-    meta->setRecycleBinEnabled(m_uiGeneral->recycleBinEnabledCheckBox->isChecked());
-    meta->setSettingsChanged(QDateTime::currentDateTimeUtc());
+        meta->setName(m_uiGeneral->dbNameEdit->text());
+        meta->setDescription(m_uiGeneral->dbDescriptionEdit->text());
+        meta->setDefaultUserName(m_uiGeneral->defaultUsernameEdit->text());
+        meta->setRecycleBinEnabled(m_uiGeneral->recycleBinEnabledCheckBox->isChecked());
+        meta->setSettingsChanged(QDateTime::currentDateTimeUtc());
 
-    bool truncate = false;
+        bool truncate = false;
 
-    int historyMaxItems;
-    if (m_uiGeneral->historyMaxItemsCheckBox->isChecked()) {
-        historyMaxItems = m_uiGeneral->historyMaxItemsSpinBox->value();
-    } else {
-        historyMaxItems = -1;
-    }
-    if (historyMaxItems != meta->historyMaxItems()) {
-        meta->setHistoryMaxItems(historyMaxItems);
-        truncate = true;
-    }
+        int historyMaxItems;
+        if (m_uiGeneral->historyMaxItemsCheckBox->isChecked()) {
+            historyMaxItems = m_uiGeneral->historyMaxItemsSpinBox->value();
+        } else {
+            historyMaxItems = -1;
+        }
+        if (historyMaxItems != meta->historyMaxItems()) {
+            meta->setHistoryMaxItems(historyMaxItems);
+            truncate = true;
+        }
 
-    int historyMaxSize;
-    if (m_uiGeneral->historyMaxSizeCheckBox->isChecked()) {
-        historyMaxSize = m_uiGeneral->historyMaxSizeSpinBox->value() * 1048576;
-    } else {
-        historyMaxSize = -1;
-    }
-    if (historyMaxSize != meta->historyMaxSize()) {
-        meta->setHistoryMaxSize(historyMaxSize);
-        truncate = true;
-    }
+        int historyMaxSize;
+        if (m_uiGeneral->historyMaxSizeCheckBox->isChecked()) {
+            historyMaxSize = m_uiGeneral->historyMaxSizeSpinBox->value() * 1048576;
+        } else {
+            historyMaxSize = -1;
+        }
+        if (historyMaxSize != meta->historyMaxSize()) {
+            meta->setHistoryMaxSize(historyMaxSize);
+            truncate = true;
+        }
 
-    if (truncate) {
-        truncateHistories();
-    }
+        if (truncate) {
+            truncateHistories();
+        }
 
-    m_db->setCipher(Uuid(m_uiEncryption->algorithmComboBox->currentData().toByteArray()));
+        m_db->setCipher(Uuid(m_uiEncryption->algorithmComboBox->currentData().toByteArray()));
+    }
 
     // Save kdf parameters
     kdf->setRounds(m_uiEncryption->transformRoundsSpinBox->value());
@@ -278,10 +283,11 @@ void DatabaseSettingsWidget::transformRoundsBenchmark()
 
 void DatabaseSettingsWidget::truncateHistories()
 {
-    const QList<Entry*> allEntries = m_db->rootGroup()->entriesRecursive(false);
-    for (Entry* entry : allEntries) {
+    DatabaseAccess::WriteLocker locker;
+    m_db->rootGroup()->walkEntries([](Entry* entry) {
         entry->truncateHistory();
-    }
+        return false;
+    });
 }
 
 void DatabaseSettingsWidget::kdfChanged(int index)
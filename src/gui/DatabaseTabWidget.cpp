@@ -26,6 +26,7 @@
 #include "core/AsyncTask.h"
 #include "core/Config.h"
 #include "core/Database.h"
+#include "core/DatabaseAccess.h"
 #include "core/Global.h"
 #include "core/Group.h"
 #include "core/Metadata.h"
@@ -285,6 +286,7 @@ void DatabaseTabWidget::deleteDatabase(Database* db)
 
     int index = databaseIndex(db);
 
+    DatabaseAccess::WriteLocker locker;
     removeTab(index);
     toggleTabbar();
     m_dbList.remove(db);
@@ -796,10 +798,18 @@ void DatabaseTabWidget::updateLastDatabases(const QString& filename)
 void DatabaseTabWidget::changeDatabase(Database* newDb, bool unsavedChanges)
 {
     Q_ASSERT(sender());
-    Q_ASSERT(!m_dbList.contains(newDb));
 
     DatabaseWidget* dbWidget = static_cast<DatabaseWidget*>(sender());
     Database* oldDb = databaseFromDatabaseWidget(dbWidget);
+    if (newDb == oldDb) {
+        // the database has been updated in place, e.g. by a reload
+        m_dbList[newDb].modified = unsavedChanges;
+        updateTabName(newDb);
+        newDb->setEmitModified(true);
+        return;
+    }
+
+    Q_ASSERT(!m_dbList.contains(newDb));
     DatabaseManagerStruct dbStruct = m_dbList[oldDb];
     dbStruct.modified = unsavedChanges;
     m_dbList.remove(oldDb);
@@ -807,6 +817,7 @@ void DatabaseTabWidget::changeDatabase(Database* newDb, bool unsavedChanges)
 
     updateTabName(newDb);
     connectDatabase(newDb, oldDb);
+    emit databaseReplaced(dbWidget);
 }
 
 void DatabaseTabWidget::emitActivateDatabaseChanged()
@@ -87,6 +87,7 @@ signals:
     void activateDatabaseChanged(DatabaseWidget* dbWidget);
     void databaseLocked(DatabaseWidget* dbWidget);
     void databaseUnlocked(DatabaseWidget* dbWidget);
+    void databaseReplaced(DatabaseWidget* dbWidget);
     void messageGlobal(const QString&, MessageWidget::MessageType type);
     void messageTab(const QString&, MessageWidget::MessageType type);
     void messageDismissGlobal();
@@ -34,11 +34,15 @@
 
 #include "autotype/AutoType.h"
 #include "core/Config.h"
+#include "core/DatabaseAccess.h"
+#include "core/DatabaseDelta.h"
 #include "core/EntrySearcher.h"
 #include "core/FilePath.h"
 #include "core/Group.h"
 #include "core/Metadata.h"
 #include "core/Tools.h"
+#include "crypto/Random.h"
+#include "format/KdbxFingerprint.h"
 #include "format/KeePass2Reader.h"
 #include "gui/ChangeMasterKeyWidget.h"
 #include "gui/Clipboard.h"
@@ -396,6 +400,7 @@ void DatabaseWidget::setIconFromParent()
 
 void DatabaseWidget::replaceDatabase(Database* db)
 {
+    DatabaseAccess::WriteLocker locker;
     Database* oldDb = m_db;
     m_db = db;
     m_groupView->changeDatabase(m_db);
@@ -486,6 +491,7 @@ void DatabaseWidget::deleteEntries()
             this, tr("Delete entry(s)?", "", selected.size()), prompt, QMessageBox::Yes | QMessageBox::No);
 
         if (result == QMessageBox::Yes) {
+            DatabaseAccess::WriteLocker locker;
             for (Entry* entry : asConst(selectedEntries)) {
                 delete entry;
             }
@@ -507,6 +513,7 @@ void DatabaseWidget::deleteEntries()
             return;
         }
 
+        DatabaseAccess::WriteLocker locker;
         for (Entry* entry : asConst(selectedEntries)) {
             m_db->recycleEntry(entry);
         }
@@ -699,9 +706,11 @@ void DatabaseWidget::deleteGroup()
             tr("Do you really want to delete the group \"%1\" for good?").arg(currentGroup->name().toHtmlEscaped()),
             QMessageBox::Yes | QMessageBox::No);
         if (result == QMessageBox::Yes) {
+            DatabaseAccess::WriteLocker locker;
             delete currentGroup;
         }
     } else {
+        DatabaseAccess::WriteLocker locker;
         m_db->recycleGroup(currentGroup);
     }
 }
@@ -751,6 +760,7 @@ void DatabaseWidget::csvImportFinished(bool accepted)
 
 void DatabaseWidget::switchToView(bool accepted)
 {
+    DatabaseAccess::WriteLocker locker;
     if (m_newGroup) {
         if (accepted) {
             m_newGroup->setParent(m_newParent);
@@ -881,6 +891,7 @@ void DatabaseWidget::mergeDatabase(bool accepted)
             return;
         }
 
+        DatabaseAccess::WriteLocker locker;
         m_db->merge(srcDb);
     }
 
@@ -1205,9 +1216,11 @@ void DatabaseWidget::lock()
     clearAllWidgets();
     m_unlockDatabaseWidget->load(m_filePath);
     setCurrentWidget(m_unlockDatabaseWidget);
+    DatabaseAccess::WriteLocker locker;
     Database* newDb = new Database();
     newDb->metadata()->setName(m_db->metadata()->name());
     replaceDatabase(newDb);
+    randomGen()->wipeBuffers();
 }
 
 void DatabaseWidget::updateFilePath(const QString& filePath)
@@ -1218,6 +1231,7 @@ void DatabaseWidget::updateFilePath(const QString& filePath)
 
     m_fileWatcher.addPath(filePath);
     m_filePath = filePath;
+    m_fileFingerprint = KdbxFingerprint::fromFile(filePath);
 }
 
 void DatabaseWidget::blockAutoReload(bool block)
@@ -1257,6 +1271,14 @@ void DatabaseWidget::reloadDatabaseFile()
         return;
     }
 
+    // Ignore changes that leave the database as it is, e.g. touching the file or
+    // sync tools rewriting identical contents, before asking or running the KDF
+    KdbxFingerprint fingerprint = KdbxFingerprint::fromFile(m_filePath);
+    if (fingerprint == m_fileFingerprint) {
+        m_fileWatcher.addPath(m_filePath);
+        return;
+    }
+
     if (!config()->get("AutoReloadOnChange").toBool()) {
         // Ask if we want to reload the db
         QMessageBox::StandardButton mb =
@@ -1312,8 +1334,20 @@ void DatabaseWidget::reloadDatabaseFile()
                 entryBeforeReload = m_entryView->currentEntry()->uuid();
             }
 
-            replaceDatabase(db);
-            restoreGroupEntryFocus(groupBeforeReload, entryBeforeReload);
+            // Apply only the changes to the open database so the views keep their state
+            DatabaseAccess::WriteLocker locker;
+            m_db->setEmitModified(false);
+            DatabaseDelta delta(db, m_db);
+            if (delta.apply()) {
+                delete db;
+                emit databaseChanged(m_db, m_databaseModified);
+            } else {
+                replaceDatabase(db);
+                restoreGroupEntryFocus(groupBeforeReload, entryBeforeReload);
+            }
+            // only now the open database matches the file, a declined or failed
+            // reload has to be offered again on the next change notification
+            m_fileFingerprint = fingerprint;
         }
     } else {
         m_messageWidget->showMessage(
@@ -1506,6 +1540,7 @@ void DatabaseWidget::emptyRecycleBin()
                              QMessageBox::Yes | QMessageBox::No);
 
     if (result == QMessageBox::Yes) {
+        DatabaseAccess::WriteLocker locker;
         m_db->emptyRecycleBin();
         refreshSearch();
     }
@@ -25,6 +25,7 @@
 #include <QTimer>
 
 #include "core/Uuid.h"
+#include "format/KdbxFingerprint.h"
 
 #include "gui/MessageWidget.h"
 #include "gui/csvImport/CsvImportWizard.h"
@@ -251,6 +252,7 @@ private:
     QFileSystemWatcher m_fileWatcher;
     QTimer m_fileWatchTimer;
     QTimer m_fileWatchUnblockTimer;
+    KdbxFingerprint m_fileFingerprint;
     bool m_ignoreAutoReload;
     bool m_databaseModified;
 };
@@ -24,6 +24,7 @@
 #include <QMessageBox>
 
 #include "core/Config.h"
+#include "core/DatabaseAccess.h"
 #include "core/Group.h"
 #include "core/Metadata.h"
 #include "core/Tools.h"
@@ -343,6 +344,7 @@ void EditWidgetIcons::addCustomIcon(const QImage& icon)
         Uuid uuid = m_database->metadata()->findCustomIcon(icon);
         if (uuid.isNull()) {
             uuid = Uuid::random();
+            DatabaseAccess::WriteLocker locker;
             // Don't add an icon larger than 128x128, but retain original size if smaller
             if (icon.width() > 128 || icon.height() > 128) {
                 m_database->metadata()->addCustomIcon(uuid, icon.scaled(128, 128));
@@ -372,29 +374,31 @@ void EditWidgetIcons::removeCustomIcon()
         if (index.isValid()) {
             Uuid iconUuid = m_customIconModel->uuidFromIndex(index);
 
-            const QList<Entry*> allEntries = m_database->rootGroup()->entriesRecursive(true);
             QList<Entry*> entriesWithSameIcon;
             QList<Entry*> historyEntriesWithSameIcon;
 
-            for (Entry* entry : allEntries) {
-                if (iconUuid == entry->iconUuid()) {
-                    // Check if this is a history entry (no assigned group)
-                    if (!entry->group()) {
-                        historyEntriesWithSameIcon << entry;
-                    } else if (m_currentUuid != entry->uuid()) {
-                        entriesWithSameIcon << entry;
+            m_database->rootGroup()->walkEntries(
+                [&](Entry* entry) {
+                    if (iconUuid == entry->iconUuid()) {
+                        // Check if this is a history entry (no assigned group)
+                        if (!entry->group()) {
+                            historyEntriesWithSameIcon << entry;
+                        } else if (m_currentUuid != entry->uuid()) {
+                            entriesWithSameIcon << entry;
+                        }
                     }
-                }
-            }
+                    return false;
+                },
+                true);
 
-            const QList<Group*> allGroups = m_database->rootGroup()->groupsRecursive(true);
             QList<Group*> groupsWithSameIcon;
 
-            for (Group* group : allGroups) {
+            m_database->rootGroup()->walkGroups([&](Group* group) {
                 if (iconUuid == group->iconUuid() && m_currentUuid != group->uuid()) {
                     groupsWithSameIcon << group;
                 }
-            }
+                return false;
+            });
 
             int iconUseCount = entriesWithSameIcon.size() + groupsWithSameIcon.size();
             if (iconUseCount > 0) {
@@ -410,19 +414,21 @@ void EditWidgetIcons::removeCustomIcon()
                 if (ans == QMessageBox::No) {
                     // Early out, nothing is changed
                     return;
-                } else {
-                    // Revert matched entries to the default entry icon
-                    for (Entry* entry : asConst(entriesWithSameIcon)) {
-                        entry->setIcon(Entry::DefaultIconNumber);
-                    }
-
-                    // Revert matched groups to the default group icon
-                    for (Group* group : asConst(groupsWithSameIcon)) {
-                        group->setIcon(Group::DefaultIconNumber);
-                    }
                 }
             }
 
+            DatabaseAccess::WriteLocker locker;
+
+            // Revert matched entries to the default entry icon
+            for (Entry* entry : asConst(entriesWithSameIcon)) {
+                entry->setIcon(Entry::DefaultIconNumber);
+            }
+
+            // Revert matched groups to the default group icon
+            for (Group* group : asConst(groupsWithSameIcon)) {
+                group->setIcon(Group::DefaultIconNumber);
+            }
+
             // Remove the icon from history entries
             for (Entry* entry : asConst(historyEntriesWithSameIcon)) {
                 entry->setUpdateTimeinfo(false);
@@ -17,6 +17,7 @@
  */
 
 #include "SetupTotpDialog.h"
+#include "core/DatabaseAccess.h"
 #include "totp/totp.h"
 #include "ui_SetupTotpDialog.h"
 
@@ -53,6 +54,7 @@ void SetupTotpDialog::setupTotp()
 
     quint8 step = m_ui->stepSpinBox->value();
     QString seed = Totp::parseOtpString(m_ui->seedEdit->text(), digits, step);
+    DatabaseAccess::WriteLocker locker;
     m_entry->setTotp(seed, step, digits);
     emit m_parent->entrySelectionChanged();
     close();
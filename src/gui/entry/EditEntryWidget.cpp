@@ -36,6 +36,7 @@
 #include "autotype/AutoType.h"
 #include "core/Config.h"
 #include "core/Database.h"
+#include "core/DatabaseAccess.h"
 #include "core/Entry.h"
 #include "core/FilePath.h"
 #include "core/Metadata.h"
@@ -814,6 +815,9 @@ bool EditEntryWidget::commitEntry()
 
     m_currentAttribute = QPersistentModelIndex();
 
+    // the rest of the method changes the entry
+    DatabaseAccess::WriteLocker locker;
+
     // must stand before beginUpdate()
     // we don't want to create a new history item, if only the history has changed
     m_entry->removeHistoryItems(m_historyModel->deletedEntries());
@@ -917,6 +921,7 @@ void EditEntryWidget::cancel()
     }
 
     if (!m_entry->iconUuid().isNull() && !m_database->metadata()->containsCustomIcon(m_entry->iconUuid())) {
+        DatabaseAccess::WriteLocker locker;
         m_entry->setIcon(Entry::DefaultIconNumber);
     }
 
@@ -18,6 +18,7 @@
 #include "EditGroupWidget.h"
 #include "ui_EditGroupWidgetMain.h"
 
+#include "core/DatabaseAccess.h"
 #include "core/FilePath.h"
 #include "core/Metadata.h"
 #include "gui/EditWidgetIcons.h"
@@ -112,6 +113,7 @@ void EditGroupWidget::save()
 
 void EditGroupWidget::apply()
 {
+    DatabaseAccess::WriteLocker locker;
     m_group->setName(m_mainUi->editName->text());
     m_group->setNotes(m_mainUi->editNotes->toPlainText());
     m_group->setExpires(m_mainUi->expireCheck->isChecked());
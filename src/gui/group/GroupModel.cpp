@@ -21,6 +21,7 @@
 #include <QMimeData>
 
 #include "core/Database.h"
+#include "core/DatabaseAccess.h"
 #include "core/DatabaseIcons.h"
 #include "core/Group.h"
 #include "core/Metadata.h"
@@ -218,6 +219,7 @@ bool GroupModel::dropMimeData(const QMimeData* data,
     }
 
     // decode and insert
+    DatabaseAccess::WriteLocker locker;
     QByteArray encoded = data->data(isGroup ? types.at(0) : types.at(1));
     QDataStream stream(&encoded, QIODevice::ReadOnly);
 
@@ -17,6 +17,7 @@
 */
 
 #include "CompositeKey.h"
+#include <QDataStream>
 #include <QFile>
 #include <QtConcurrent>
 #include <format/KeePass2.h>
@@ -44,6 +45,8 @@ void CompositeKey::clear()
     qDeleteAll(m_keys);
     m_keys.clear();
     m_challengeResponseKeys.clear();
+    m_transformInputHash.clear();
+    m_transformedKey.clear();
 }
 
 bool CompositeKey::isEmpty() const
@@ -71,6 +74,8 @@ CompositeKey& CompositeKey::operator=(const CompositeKey& key)
     for (const auto subKey : asConst(key.m_challengeResponseKeys)) {
         addChallengeResponseKey(subKey);
     }
+    m_transformInputHash = key.m_transformInputHash;
+    m_transformedKey = key.m_transformedKey;
 
     return *this;
 }
@@ -133,6 +138,10 @@ QByteArray CompositeKey::rawKey(const QByteArray* transformSeed, bool* ok) const
  * challenge response key components after key transformation.
  * KDBX4+ KDFs transform the whole key including challenge-response components.
  *
+ * The result of the last transformation is cached, so transforming the same
+ * key with unchanged KDF parameters and seed (e.g. when reloading a database
+ * that was saved by us) does not run the KDF again.
+ *
  * @param kdf key derivation function
  * @param result transformed key hash
  * @return true on success
@@ -141,13 +150,50 @@ bool CompositeKey::transform(const Kdf& kdf, QByteArray& result) const
 {
     if (kdf.uuid() == KeePass2::KDF_AES_KDBX3) {
         // legacy KDBX3 AES-KDF, challenge response is added later to the hash
-        return kdf.transform(rawKey(), result);
+        return transformRawKey(kdf, rawKey(), result);
     }
 
     QByteArray seed = kdf.seed();
     Q_ASSERT(!seed.isEmpty());
     bool ok = false;
-    return kdf.transform(rawKey(&seed, &ok), result) && ok;
+    QByteArray raw = rawKey(&seed, &ok);
+    if (!ok) {
+        return false;
+    }
+    return transformRawKey(kdf, raw, result);
+}
+
+bool CompositeKey::transformRawKey(const Kdf& kdf, const QByteArray& raw, QByteArray& result) const
+{
+    const QByteArray inputHash = transformInputHash(kdf, raw);
+    if (!m_transformedKey.isEmpty() && m_transformInputHash == inputHash) {
+        result = m_transformedKey;
+        return true;
+    }
+
+    if (!kdf.transform(raw, result)) {
+        return false;
+    }
+
+    m_transformInputHash = inputHash;
+    m_transformedKey = result;
+    return true;
+}
+
+/**
+ * Hash identifying a transformation, so the cache doesn't have to keep
+ * the untransformed key around.
+ */
+QByteArray CompositeKey::transformInputHash(const Kdf& kdf, const QByteArray& raw)
+{
+    QByteArray parameters;
+    QDataStream stream(&parameters, QIODevice::WriteOnly);
+    stream << kdf.writeParameters();
+
+    CryptoHash cryptoHash(CryptoHash::Sha256);
+    cryptoHash.addData(raw);
+    cryptoHash.addData(parameters);
+    return cryptoHash.result();
 }
 
 bool CompositeKey::challenge(const QByteArray& seed, QByteArray& result) const
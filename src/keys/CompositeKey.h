@@ -47,8 +47,15 @@ public:
     void addChallengeResponseKey(QSharedPointer<ChallengeResponseKey> key);
 
 private:
+    bool transformRawKey(const Kdf& kdf, const QByteArray& raw, QByteArray& result) const;
+    static QByteArray transformInputHash(const Kdf& kdf, const QByteArray& raw);
+
     QList<Key*> m_keys;
     QList<QSharedPointer<ChallengeResponseKey>> m_challengeResponseKeys;
+
+    // last transformation, reused as long as the hash of the raw key and KDF parameters (including the seed) matches
+    mutable QByteArray m_transformInputHash;
+    mutable QByteArray m_transformedKey;
 };
 
 #endif // KEEPASSX_COMPOSITEKEY_H
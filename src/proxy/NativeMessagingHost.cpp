@@ -22,9 +22,13 @@
 #include <Winsock2.h>
 #endif
 
-NativeMessagingHost::NativeMessagingHost() : NativeMessagingBase(true)
+NativeMessagingHost::NativeMessagingHost()
+    : NativeMessagingBase(true)
+    , m_nextRequestId(1)
 {
     m_localSocket = new QLocalSocket();
+    // connected() may already be emitted by connectToServer()
+    connect(m_localSocket, SIGNAL(connected()), this, SLOT(sendHandshake()));
     m_localSocket->connectToServer(getLocalServerPath());
     m_localSocket->setReadBufferSize(NATIVE_MSG_MAX_LENGTH);
   
@@ -53,50 +57,49 @@ NativeMessagingHost::~NativeMessagingHost()
 #endif
 }
 
-void NativeMessagingHost::readLength()
+void NativeMessagingHost::sendHandshake()
 {
-    quint32 length = 0;
-    std::cin.read(reinterpret_cast<char*>(&length), 4);
-    if (!std::cin.eof() && length > 0) {
-        readStdIn(length);
-    } else {
-        QCoreApplication::quit();
-    }
+    m_localSocket->write(NativeMessagingFrames::handshake());
+    m_localSocket->flush();
 }
 
-void NativeMessagingHost::readStdIn(const quint32 length)
+void NativeMessagingHost::readNativeMessage(const QByteArray& message)
 {
-    if (length <= 0) {
-        return;
-    }
-
-    QByteArray arr;
-    arr.reserve(length);
-
-    for (quint32 i = 0; i < length; ++i) {
-        int c = std::getchar();
-        if (c == EOF) {
-            // message ended prematurely, ignore it and return
-            return;
+    if (m_localSocket && m_localSocket->state() == QLocalSocket::ConnectedState) {
+        // requests are forwarded without waiting for the replies of earlier ones,
+        // id 0 is reserved for messages the server sends on its own
+        const quint32 requestId = m_nextRequestId++;
+        if (m_nextRequestId == 0) {
+            m_nextRequestId = 1;
         }
-        arr.append(static_cast<char>(c));
-    }
 
-    if (arr.length() > 0 && m_localSocket && m_localSocket->state() == QLocalSocket::ConnectedState) {
-        m_localSocket->write(arr.constData(), arr.length());
+        m_localSocket->write(NativeMessagingFrames::encode(requestId, message));
         m_localSocket->flush();
     }
 }
 
+void NativeMessagingHost::nativeInputClosed()
+{
+    NativeMessagingBase::nativeInputClosed();
+    QCoreApplication::quit();
+}
+
 void NativeMessagingHost::newLocalMessage()
 {
     if (!m_localSocket || m_localSocket->bytesAvailable() <= 0) {
         return;
     }
 
-    QByteArray arr = m_localSocket->readAll();
-    if (!arr.isEmpty()) {
-        sendReply(arr);
+    // the browser doesn't know about request ids, the server sends replies in request order
+    m_frames.append(m_localSocket->readAll());
+    quint32 requestId;
+    QByteArray payload;
+    while (m_frames.takeFrame(requestId, payload)) {
+        sendReply(payload);
+    }
+
+    if (m_frames.hasError()) {
+        m_localSocket->disconnectFromServer();
     }
 }
 
@@ -19,6 +19,7 @@
 #define NATIVEMESSAGINGHOST_H
 
 #include "NativeMessagingBase.h"
+#include "NativeMessagingFrames.h"
 
 class NativeMessagingHost : public NativeMessagingBase
 {
@@ -32,12 +33,17 @@ public slots:
     void deleteSocket();
     void socketStateChanged(QLocalSocket::LocalSocketState socketState);
 
+private slots:
+    void sendHandshake();
+
 private:
-    void readLength();
-    void readStdIn(const quint32 length);
+    void readNativeMessage(const QByteArray& message) override;
+    void nativeInputClosed() override;
 
 private:
     QLocalSocket* m_localSocket;
+    NativeMessagingFrames m_frames;
+    quint32 m_nextRequestId;
 };
 
 #endif // NATIVEMESSAGINGHOST_H
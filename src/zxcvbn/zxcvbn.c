@@ -300,6 +300,8 @@ static const uint64_t CrcTable[16] =
 
 static const unsigned int MAGIC = 'z' + ('x'<< 8) + ('c' << 16) + ('v' << 24);
 
+/* Dictionary data. Only written by ZxcvbnInit() and ZxcvbnUnInit(), the matching code */
+/* only reads it, so concurrent calls to ZxcvbnMatch() are safe after initialisation. */
 static unsigned int NumNodes, NumChildLocs, NumRanks, NumWordEnd, NumChildMaps;
 static unsigned int SizeChildMapEntry, NumLargeCounts, NumSmallCounts, SizeCharSet;
 
@@ -453,7 +455,8 @@ void ZxcvbnUnInit()
 
 #else
 
-/* Include the source file containing the dictionary data */
+/* Include the source file containing the dictionary data. The tables are const, so they */
+/* are never written and can be read by concurrent calls to ZxcvbnMatch(). */
 #include "dict-src.h"
 
 #endif
@@ -1224,7 +1227,7 @@ static void SpatialMatch(ZxcMatch_t **Result, const uint8_t *Passwd, int Start,
 
 /* The possible date formats ordered by length (d for day, m for month, */
 /*  y for year, ? for separator) */
-static const char *Formats[] =
+static const char *const Formats[] =
 {
     "yyyy",
     "d?m?yy",
@@ -105,6 +105,8 @@ void ZxcvbnUnInit();
 
 /**********************************************************************************
  * The main password matching function. May be called multiple times.
+ * The dictionary data is only read, so it may be called from several threads
+ * at once, provided ZxcvbnInit() has returned before.
  * The parameters are:
  *  Passwd      The password to be tested. Null terminated string.
  *  UserDict    User supplied dictionary words to be considered particulary bad. Passed
@@ -0,0 +1,491 @@
+/*
+ *  Copyright (C) 2018 KeePassXC Team <team@keepassxc.org>
+ *
+ *  This program is free software: you can redistribute it and/or modify
+ *  it under the terms of the GNU General Public License as published by
+ *  the Free Software Foundation, either version 2 or (at your option)
+ *  version 3 of the License.
+ *
+ *  This program is distributed in the hope that it will be useful,
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *  GNU General Public License for more details.
+ *
+ *  You should have received a copy of the GNU General Public License
+ *  along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#include "TestBrowser.h"
+#include "TestGlobal.h"
+
+#include <QEventLoop>
+#include <QFutureWatcher>
+#include <QJsonDocument>
+#include <QJsonObject>
+#include <QLocalServer>
+#include <QLocalSocket>
+#include <QSemaphore>
+#include <QtConcurrent>
+
+#include "browser/BrowserClients.h"
+#include "browser/BrowserEntryConfig.h"
+#include "browser/BrowserService.h"
+#include "browser/BrowserSettings.h"
+#include "browser/NativeMessagingBase.h"
+#include "browser/NativeMessagingFrames.h"
+#include "browser/NativeMessagingHost.h"
+#include "core/Config.h"
+#include "core/Database.h"
+#include "core/Entry.h"
+#include "core/Group.h"
+#include "crypto/Crypto.h"
+
+QTEST_GUILESS_MAIN(TestBrowser)
+
+namespace
+{
+    Entry* createEntry(Group* group, const QString& title, const QString& url)
+    {
+        Entry* entry = new Entry();
+        entry->setUuid(Uuid::random());
+        entry->setTitle(title);
+        entry->setUrl(url);
+        entry->setGroup(group);
+        return entry;
+    }
+
+    void allowHost(Entry* entry, const QString& host)
+    {
+        BrowserEntryConfig config;
+        config.allow(host);
+        config.save(entry);
+    }
+
+    QJsonObject batchRequest(const QString& url, const QString& submitUrl = QString())
+    {
+        QJsonObject request;
+        request["url"] = url;
+        request["submitUrl"] = submitUrl;
+        return request;
+    }
+
+    /**
+     * Sends a message from clientID that does not need an open database.
+     */
+    QJsonObject sendMessage(BrowserClients& clients, const QString& clientID)
+    {
+        QJsonObject message;
+        message["clientID"] = clientID;
+        message["action"] = QString("change-public-keys");
+        return clients.readResponse(message);
+    }
+
+    QByteArray hostRequest(const QString& clientID, const QString& action)
+    {
+        QJsonObject message;
+        message["clientID"] = clientID;
+        message["action"] = action;
+        return QJsonDocument(message).toJson(QJsonDocument::Compact);
+    }
+
+    /**
+     * Sends count requests over a framed connection, with at most inFlight
+     * of them awaiting a reply, and returns the number of replies that
+     * arrived in request order.
+     */
+    int runFramedClient(const QString& serverName, const QByteArray& request, int count, int inFlight)
+    {
+        QLocalSocket socket;
+        socket.connectToServer(serverName);
+        if (!socket.waitForConnected(5000)) {
+            return 0;
+        }
+        socket.write(NativeMessagingFrames::handshake());
+
+        NativeMessagingFrames frames;
+        int sent = 0;
+        int received = 0;
+        while (received < count) {
+            while (sent < count && sent - received < inFlight) {
+                ++sent;
+                socket.write(NativeMessagingFrames::encode(static_cast<quint32>(sent), request));
+            }
+            socket.flush();
+            if (!socket.waitForReadyRead(5000)) {
+                break;
+            }
+
+            frames.append(socket.readAll());
+            quint32 requestId;
+            QByteArray payload;
+            while (frames.takeFrame(requestId, payload)) {
+                if (requestId != static_cast<quint32>(received + 1)) {
+                    return received;
+                }
+                ++received;
+            }
+        }
+        return received;
+    }
+} // namespace
+
+void TestBrowser::initTestCase()
+{
+    QVERIFY(Crypto::init());
+    Config::createTempFileInstance();
+    BrowserSettings::setSortByTitle(true);
+    BrowserSettings::setBestMatchOnly(false);
+}
+
+void TestBrowser::testSortEntries()
+{
+    Database db;
+    Group* root = db.rootGroup();
+    Entry* entryHost = createEntry(root, "b", "example.com");
+    Entry* entryBase = createEntry(root, "a", "https://example.com");
+    Entry* entryExact = createEntry(root, "c", "https://example.com/login");
+    Entry* entryOther = createEntry(root, "d", "https://example.com/other/");
+    Entry* entryBaseB = createEntry(root, "aa", "https://example.com/");
+
+    BrowserService service(nullptr);
+    QList<Entry*> entries = service.searchEntries(&db, "example.com");
+    QCOMPARE(entries.size(), 5);
+
+    const QList<Entry*> sorted = service.sortEntries(entries, "example.com", "https://example.com/login");
+    QCOMPARE(sorted.size(), 5);
+    QCOMPARE(sorted[0], entryExact);
+    // same priority, sorted by title
+    QCOMPARE(sorted[1], entryBase);
+    QCOMPARE(sorted[2], entryBaseB);
+    QCOMPARE(sorted[3], entryOther);
+    QCOMPARE(sorted[4], entryHost);
+}
+
+void TestBrowser::testSortEntriesUrlChanged()
+{
+    Database db;
+    Group* root = db.rootGroup();
+    Entry* entry1 = createEntry(root, "1", "https://example.com/login");
+    Entry* entry2 = createEntry(root, "2", "https://example.com/");
+
+    BrowserService service(nullptr);
+    QList<Entry*> entries = service.searchEntries(&db, "example.com");
+    QList<Entry*> sorted = service.sortEntries(entries, "example.com", "https://example.com/login");
+    QCOMPARE(sorted, QList<Entry*>() << entry1 << entry2);
+
+    // the cached URL of an entry must not outlive an edit
+    entry1->setUrl("https://example.com/other");
+    entry2->setUrl("https://example.com/login/");
+    entries = service.searchEntries(&db, "example.com");
+    sorted = service.sortEntries(entries, "example.com", "https://example.com/login");
+    QCOMPARE(sorted, QList<Entry*>() << entry2 << entry1);
+}
+
+void TestBrowser::testEntryUrlCacheBounded()
+{
+    Database db;
+    Group* root = db.rootGroup();
+    BrowserService service(nullptr);
+
+    // entries are never dropped one by one, the cache must not grow past its limit
+    for (int i = 0; i <= BrowserService::MaxCachedEntryUrls; ++i) {
+        Entry* entry = createEntry(root, "entry", "https://example.com/login");
+        QList<Entry*> entries = QList<Entry*>() << entry;
+        service.sortEntries(entries, "example.com", "https://example.com/login");
+        delete entry;
+    }
+    QVERIFY(service.m_entryUrls.size() <= BrowserService::MaxCachedEntryUrls);
+    QVERIFY(!service.m_entryUrls.isEmpty());
+
+    service.databaseLocked(nullptr);
+    QVERIFY(service.m_entryUrls.isEmpty());
+}
+
+void TestBrowser::benchmarkGetLogins()
+{
+    QByteArray env = qgetenv("BENCHMARK");
+
+    if (env.isEmpty() || env == "0" || env == "no") {
+        QSKIP("Benchmark skipped. Set env variable BENCHMARK=1 to enable.");
+    }
+
+    Database db;
+    Group* root = db.rootGroup();
+    for (int i = 0; i < 10000; ++i) {
+        createEntry(root,
+                    QString("Account %1").arg((i * 7919) % 10000),
+                    QString("https://example.com/%1/login").arg(i % 100));
+    }
+
+    BrowserService service(nullptr);
+    QBENCHMARK
+    {
+        QList<Entry*> entries = service.searchEntries(&db, "example.com");
+        QCOMPARE(service.sortEntries(entries, "example.com", "https://example.com/42/login").size(), 10000);
+    };
+}
+
+void TestBrowser::testFindMatchingEntriesBatch()
+{
+    Database db;
+    Group* root = db.rootGroup();
+    Entry* entryLogin = createEntry(root, "login", "https://example.com/login");
+    Entry* entryOther = createEntry(root, "other", "https://other.com");
+    allowHost(entryLogin, "example.com");
+    allowHost(entryOther, "other.com");
+
+    BrowserService service(nullptr);
+    service.m_currentDatabase = &db;
+
+    QJsonArray requests;
+    requests << batchRequest("https://example.com/login") << batchRequest("https://example.com/login")
+             << batchRequest("https://example.com/login", "https://example.com/submit") << batchRequest("")
+             << batchRequest("https://other.com") << batchRequest("https://unknown.org");
+
+    // duplicate pairs share a page and requests without an url are dropped, the order is kept
+    const QJsonObject batch = service.findMatchingEntriesBatch("id", requests, StringPairList());
+    QCOMPARE(batch["truncated"].toBool(), false);
+    QCOMPARE(batch["limit"].toInt(), BrowserService::MaxBatchRequests);
+    const QJsonArray result = batch["results"].toArray();
+    QCOMPARE(result.size(), 4);
+
+    const QJsonObject page = result[0].toObject();
+    QCOMPARE(page.keys(), QStringList() << "count" << "entries" << "requests" << "submitUrl" << "url");
+    QCOMPARE(page["requests"].toArray(), QJsonArray({0, 1}));
+    QCOMPARE(page["url"].toString(), QString("https://example.com/login"));
+    QCOMPARE(page["submitUrl"].toString(), QString());
+    QCOMPARE(page["count"].toInt(), 1);
+    QCOMPARE(page["entries"].toArray().size(), 1);
+    QCOMPARE(page["entries"].toArray()[0].toObject()["uuid"].toString(), entryLogin->uuid().toHex());
+
+    QCOMPARE(result[1].toObject()["url"].toString(), QString("https://example.com/login"));
+    QCOMPARE(result[1].toObject()["submitUrl"].toString(), QString("https://example.com/submit"));
+    QCOMPARE(result[1].toObject()["count"].toInt(), 1);
+    QCOMPARE(result[1].toObject()["requests"].toArray(), QJsonArray({2}));
+
+    QCOMPARE(result[2].toObject()["url"].toString(), QString("https://other.com"));
+    QCOMPARE(result[2].toObject()["requests"].toArray(), QJsonArray({4}));
+    QCOMPARE(result[2].toObject()["entries"].toArray()[0].toObject()["uuid"].toString(), entryOther->uuid().toHex());
+
+    QCOMPARE(result[3].toObject()["url"].toString(), QString("https://unknown.org"));
+    QCOMPARE(result[3].toObject()["count"].toInt(), 0);
+    QVERIFY(result[3].toObject()["entries"].toArray().isEmpty());
+
+    // only the first pages of an oversized batch are answered, later duplicates of them still are
+    QJsonArray oversized;
+    for (int i = 0; i <= BrowserService::MaxBatchRequests; ++i) {
+        oversized << batchRequest(QString("https://example.com/%1").arg(i));
+    }
+    oversized << batchRequest("https://example.com/0");
+    const QJsonObject cappedBatch = service.findMatchingEntriesBatch("id", oversized, StringPairList());
+    QCOMPARE(cappedBatch["truncated"].toBool(), true);
+    const QJsonArray capped = cappedBatch["results"].toArray();
+    QCOMPARE(capped.size(), BrowserService::MaxBatchRequests);
+    QCOMPARE(capped.last().toObject()["url"].toString(),
+             QString("https://example.com/%1").arg(BrowserService::MaxBatchRequests - 1));
+    QCOMPARE(capped.first().toObject()["requests"].toArray(), QJsonArray({0, BrowserService::MaxBatchRequests + 1}));
+}
+
+void TestBrowser::testFindMatchingEntriesBatchConfirm()
+{
+    Database db;
+    Group* root = db.rootGroup();
+    Entry* entryAllowed = createEntry(root, "allowed", "https://example.com/login");
+    allowHost(entryAllowed, "example.com");
+    createEntry(root, "unknown", "https://example.com/other");
+
+    BrowserService service(nullptr);
+    service.m_currentDatabase = &db;
+
+    QJsonArray requests;
+    requests << batchRequest("https://example.com/login");
+
+    QJsonArray result;
+    QSemaphore started;
+    QSemaphore finished;
+    auto find = [&]() {
+        started.release();
+        result = service.findMatchingEntriesBatch("id", requests, StringPairList())["results"].toArray();
+        finished.release();
+    };
+
+    // nothing to confirm, the worker answers without the GUI thread
+    BrowserSettings::setAlwaysAllowAccess(true);
+    QtConcurrent::run(find);
+    QVERIFY(finished.tryAcquire(1, 5000));
+    QVERIFY(started.tryAcquire());
+    QCOMPARE(result.size(), 1);
+    QCOMPARE(result[0].toObject()["count"].toInt(), 2);
+
+    // the unknown entry has to be confirmed, which only happens on the GUI thread;
+    // another dialog is already open, so the confirmation is refused
+    BrowserSettings::setAlwaysAllowAccess(false);
+    service.m_dialogActive = true;
+    QtConcurrent::run(find);
+    started.acquire();
+    QVERIFY(!finished.tryAcquire(1, 200));
+    QTRY_VERIFY(finished.tryAcquire());
+    QCOMPARE(result.size(), 1);
+    QCOMPARE(result[0].toObject()["count"].toInt(), 1);
+    QCOMPARE(result[0].toObject()["entries"].toArray()[0].toObject()["uuid"].toString(), entryAllowed->uuid().toHex());
+}
+
+void TestBrowser::testClientEviction()
+{
+    BrowserService service(nullptr);
+
+    BrowserClients clients(service, 2, 60 * 1000);
+    QCOMPARE(sendMessage(clients, "a").value("action").toString(), QString("change-public-keys"));
+    sendMessage(clients, "b");
+    sendMessage(clients, "a");
+    QCOMPARE(clients.clientCount(), 2);
+
+    // b is the least recently used client
+    sendMessage(clients, "c");
+    QCOMPARE(clients.clientCount(), 2);
+    QVERIFY(clients.hasClient("a"));
+    QVERIFY(!clients.hasClient("b"));
+    QVERIFY(clients.hasClient("c"));
+
+    // messages without a client id are ignored
+    QVERIFY(sendMessage(clients, "").isEmpty());
+    QCOMPARE(clients.clientCount(), 2);
+
+    BrowserClients idleClients(service, 10, 50);
+    sendMessage(idleClients, "a");
+    QTest::qWait(100);
+    sendMessage(idleClients, "b");
+    QCOMPARE(idleClients.clientCount(), 1);
+    QVERIFY(!idleClients.hasClient("a"));
+    QVERIFY(idleClients.hasClient("b"));
+}
+
+void TestBrowser::testNativeMessagingFrames()
+{
+    const QByteArray stream = NativeMessagingFrames::encode(1, "{\"action\":\"get-logins\"}")
+                              + NativeMessagingFrames::encode(7, QByteArray()) + NativeMessagingFrames::encode(2, "{}");
+
+    quint32 requestId;
+    QByteArray payload;
+
+    // split into single bytes
+    NativeMessagingFrames splitFrames;
+    QList<quint32> requestIds;
+    for (const char byte : stream) {
+        splitFrames.append(QByteArray(1, byte));
+        while (splitFrames.takeFrame(requestId, payload)) {
+            requestIds << requestId;
+        }
+    }
+    QCOMPARE(requestIds, QList<quint32>() << 1 << 7 << 2);
+    QVERIFY(!splitFrames.hasError());
+
+    // coalesced into one read
+    NativeMessagingFrames coalescedFrames;
+    coalescedFrames.append(stream);
+    QVERIFY(coalescedFrames.takeFrame(requestId, payload));
+    QCOMPARE(requestId, 1u);
+    QCOMPARE(payload, QByteArray("{\"action\":\"get-logins\"}"));
+    QVERIFY(coalescedFrames.takeFrame(requestId, payload));
+    QCOMPARE(requestId, 7u);
+    QVERIFY(payload.isEmpty());
+    QVERIFY(coalescedFrames.takeFrame(requestId, payload));
+    QCOMPARE(requestId, 2u);
+    QCOMPARE(payload, QByteArray("{}"));
+    QVERIFY(!coalescedFrames.takeFrame(requestId, payload));
+
+    // a frame that is too large can't be skipped
+    NativeMessagingFrames oversizedFrames;
+    oversizedFrames.append(NativeMessagingFrames::encode(3, QByteArray(NATIVE_MSG_MAX_LENGTH + 1, 'x')).left(16));
+    QVERIFY(!oversizedFrames.takeFrame(requestId, payload));
+    QVERIFY(oversizedFrames.hasError());
+
+    QVERIFY(!NativeMessagingFrames::handshake().startsWith('{'));
+}
+
+void TestBrowser::benchmarkLocalSocket_data()
+{
+    QTest::addColumn<int>("inFlight");
+    QTest::newRow("sequential") << 1;
+    QTest::newRow("pipelined") << 32;
+}
+
+void TestBrowser::testNativeMessagingHost()
+{
+    NativeMessagingHost host(nullptr, false);
+    QLocalServer server;
+    const QString serverName = QString("kpxc_test_%1").arg(QCoreApplication::applicationPid());
+    QLocalServer::removeServer(serverName);
+    QVERIFY(server.listen(serverName));
+    connect(&server, &QLocalServer::newConnection, [&server, &host]() {
+        host.addLocalConnection(server.nextPendingConnection());
+    });
+
+    QLocalSocket socket;
+    NativeMessagingFrames frames;
+    QList<quint32> replyIds;
+    QStringList replyActions;
+    connect(&socket, &QLocalSocket::readyRead, [&]() {
+        frames.append(socket.readAll());
+        quint32 requestId;
+        QByteArray payload;
+        while (frames.takeFrame(requestId, payload)) {
+            replyIds << requestId;
+            replyActions << BrowserClients::byteArrayToJson(payload).value("action").toString();
+        }
+    });
+    socket.connectToServer(serverName);
+    QVERIFY(socket.waitForConnected(5000));
+
+    // the handshake may be split across reads
+    const QByteArray handshake = NativeMessagingFrames::handshake();
+    socket.write(handshake.left(3));
+    socket.flush();
+    QTRY_COMPARE(host.m_clients.size(), 1);
+    QVERIFY(!host.m_clients.begin()->detected);
+
+    // get-databasehash is answered by the thread pool, change-public-keys right away,
+    // the replies must still be in request order
+    socket.write(handshake.mid(3) + NativeMessagingFrames::encode(1, hostRequest("a", "get-databasehash"))
+                 + NativeMessagingFrames::encode(2, hostRequest("a", "change-public-keys")));
+    socket.flush();
+    QTRY_COMPARE(replyIds.size(), 2);
+    QVERIFY(host.m_clients.begin()->frames);
+    QCOMPARE(replyIds, QList<quint32>() << 1 << 2);
+    QCOMPARE(replyActions, QStringList() << "get-databasehash" << "change-public-keys");
+}
+
+void TestBrowser::benchmarkLocalSocket()
+{
+    QByteArray env = qgetenv("BENCHMARK");
+
+    if (env.isEmpty() || env == "0" || env == "no") {
+        QSKIP("Benchmark skipped. Set env variable BENCHMARK=1 to enable.");
+    }
+
+    QFETCH(int, inFlight);
+
+    // KeePassXC's own host serves the connection, get-databasehash goes
+    // through the thread pool like every read-only request
+    NativeMessagingHost host(nullptr, false);
+    QLocalServer server;
+    const QString serverName = QString("kpxc_benchmark_%1").arg(QCoreApplication::applicationPid());
+    QLocalServer::removeServer(serverName);
+    QVERIFY(server.listen(serverName));
+    connect(&server, &QLocalServer::newConnection, [&server, &host]() {
+        host.addLocalConnection(server.nextPendingConnection());
+    });
+
+    // 1000 requests per iteration, divide by 1000 for the time per request
+    const int count = 1000;
+    const QByteArray request = hostRequest("benchmark", "get-databasehash");
+    QBENCHMARK
+    {
+        QFutureWatcher<int> watcher;
+        QEventLoop loop;
+        connect(&watcher, SIGNAL(finished()), &loop, SLOT(quit()));
+        watcher.setFuture(QtConcurrent::run(runFramedClient, serverName, request, count, inFlight));
+        loop.exec();
+        QCOMPARE(watcher.result(), count);
+    };
+}
@@ -0,0 +1,261 @@
+/*
+ *  Copyright (C) 2018 KeePassXC Team <team@keepassxc.org>
+ *
+ *  This program is free software: you can redistribute it and/or modify
+ *  it under the terms of the GNU General Public License as published by
+ *  the Free Software Foundation, either version 2 or (at your option)
+ *  version 3 of the License.
+ *
+ *  This program is distributed in the hope that it will be useful,
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *  GNU General Public License for more details.
+ *
+ *  You should have received a copy of the GNU General Public License
+ *  along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#include "TestCli.h"
+#include "TestGlobal.h"
+
+#include <QBuffer>
+#include <QJsonDocument>
+#include <QJsonObject>
+
+#include "cli/EntryImporter.h"
+#include "cli/EntryJsonWriter.h"
+#include "cli/Utils.h"
+#include "core/Database.h"
+#include "core/Entry.h"
+#include "core/Group.h"
+
+QTEST_GUILESS_MAIN(TestCli)
+
+namespace
+{
+    Entry* createEntry(Group* group, const QString& title)
+    {
+        Entry* entry = new Entry();
+        entry->setUuid(Uuid::random());
+        entry->setTitle(title);
+        entry->setGroup(group);
+        return entry;
+    }
+
+    QByteArray writeEntries(const QList<Entry*>& entries,
+                            EntryJsonWriter::OutputFormat format,
+                            const QStringList& fields,
+                            bool resolve = false)
+    {
+        QByteArray data;
+        QBuffer buffer(&data);
+        buffer.open(QIODevice::WriteOnly);
+        EntryJsonWriter writer(&buffer, format, fields, resolve);
+        for (const Entry* entry : entries) {
+            writer.writeEntry(entry);
+        }
+        writer.finish();
+        return data;
+    }
+
+    ImportRecord importRecord(const QString& path, const QString& uuid = QString())
+    {
+        ImportRecord record;
+        EntryImporter::setField(record, "path", path, "Root");
+        EntryImporter::setField(record, "uuid", uuid, "Root");
+        return record;
+    }
+} // namespace
+
+void TestCli::testSplitCommandString_data()
+{
+    QTest::addColumn<QString>("command");
+    QTest::addColumn<QStringList>("words");
+
+    QTest::newRow("empty") << QString() << QStringList();
+    QTest::newRow("blank") << QString(" \t ") << QStringList();
+    QTest::newRow("words") << QString("  show   entry ") << QStringList({"show", "entry"});
+    QTest::newRow("double quotes") << QString("show \"Two Words\"") << QStringList({"show", "Two Words"});
+    QTest::newRow("single quotes") << QString("show 'Two Words'") << QStringList({"show", "Two Words"});
+    QTest::newRow("escaped space") << QString("show Two\\ Words") << QStringList({"show", "Two Words"});
+    QTest::newRow("escaped quote") << QString("show \"say \\\"hi\\\"\"") << QStringList({"show", "say \"hi\""});
+    QTest::newRow("quote in quotes") << QString("show \"it's\" '\"a\"'") << QStringList({"show", "it's", "\"a\""});
+    QTest::newRow("no escapes in single quotes") << QString("show 'a\\b'") << QStringList({"show", "a\\b"});
+    QTest::newRow("empty word") << QString("add -u \"\" entry") << QStringList({"add", "-u", "", "entry"});
+    QTest::newRow("adjacent quotes") << QString("a\"b c\"'d e'") << QStringList({"ab cd e"});
+    QTest::newRow("unterminated quote") << QString("show \"Two Words") << QStringList({"show", "Two Words"});
+    QTest::newRow("trailing backslash") << QString("show a\\") << QStringList({"show", "a\\"});
+}
+
+void TestCli::testSplitCommandString()
+{
+    QFETCH(QString, command);
+    QFETCH(QStringList, words);
+
+    QCOMPARE(Utils::splitCommandString(command), words);
+}
+
+void TestCli::testEntryJsonWriterFraming()
+{
+    Database db;
+    Entry* entryA = createEntry(db.rootGroup(), "a");
+    Entry* entryB = createEntry(db.rootGroup(), "b");
+    const QStringList fields("Title");
+
+    // JSON is one array with an entry per line, NDJSON has no array
+    QCOMPARE(writeEntries({}, EntryJsonWriter::JsonFormat, fields), QByteArray("[]\n"));
+    QCOMPARE(writeEntries({entryA}, EntryJsonWriter::JsonFormat, fields), QByteArray("[\n{\"Title\":\"a\"}\n]\n"));
+    QCOMPARE(writeEntries({entryA, entryB}, EntryJsonWriter::JsonFormat, fields),
+             QByteArray("[\n{\"Title\":\"a\"},\n{\"Title\":\"b\"}\n]\n"));
+    QCOMPARE(writeEntries({}, EntryJsonWriter::NdjsonFormat, fields), QByteArray());
+    QCOMPARE(writeEntries({entryA, entryB}, EntryJsonWriter::NdjsonFormat, fields),
+             QByteArray("{\"Title\":\"a\"}\n{\"Title\":\"b\"}\n"));
+
+    // the destructor closes the array if finish() wasn't called
+    QByteArray data;
+    QBuffer buffer(&data);
+    buffer.open(QIODevice::WriteOnly);
+    {
+        EntryJsonWriter writer(&buffer, EntryJsonWriter::JsonFormat, fields);
+        writer.writeEntry(entryA);
+        QCOMPARE(writer.entryCount(), 1);
+    }
+    QCOMPARE(data, QByteArray("[\n{\"Title\":\"a\"}\n]\n"));
+
+    QCOMPARE(EntryJsonWriter::formatFromName("json"), EntryJsonWriter::JsonFormat);
+    QCOMPARE(EntryJsonWriter::formatFromName("ndjson"), EntryJsonWriter::NdjsonFormat);
+    QCOMPARE(EntryJsonWriter::formatFromName("text"), EntryJsonWriter::TextFormat);
+    QCOMPARE(EntryJsonWriter::formatFromName("xml"), EntryJsonWriter::InvalidFormat);
+}
+
+void TestCli::testEntryJsonWriterFields()
+{
+    Database db;
+    Group* group = new Group();
+    group->setUuid(Uuid::random());
+    group->setName("Group");
+    group->setParent(db.rootGroup());
+    Group* subgroup = new Group();
+    subgroup->setUuid(Uuid::random());
+    subgroup->setName("Sub");
+    subgroup->setParent(group);
+
+    Entry* rootEntry = createEntry(db.rootGroup(), "Root Entry");
+    Entry* entry = createEntry(subgroup, "Entry");
+    entry->setUsername("{TITLE}");
+    entry->attributes()->set("Custom", "a \"quoted\" \\ value");
+
+    // keys keep the order of the fields, attributes an entry doesn't have are null
+    const QStringList fields({"uuid", "path", "group", "Title", "UserName", "Custom", "Missing"});
+    const QByteArray data = writeEntries({rootEntry, entry}, EntryJsonWriter::NdjsonFormat, fields);
+    const QList<QByteArray> lines = data.trimmed().split('\n');
+    QCOMPARE(lines.size(), 2);
+    QCOMPARE(lines[0],
+             QByteArray("{\"uuid\":\"" + rootEntry->uuid().toHex().toLatin1() + "\",\"path\":\"/Root Entry\","
+                        "\"group\":\"/\",\"Title\":\"Root Entry\",\"UserName\":\"\",\"Custom\":null,\"Missing\":null}"));
+    QCOMPARE(lines[1],
+             QByteArray("{\"uuid\":\"" + entry->uuid().toHex().toLatin1() + "\",\"path\":\"/Group/Sub/Entry\","
+                        "\"group\":\"/Group/Sub\",\"Title\":\"Entry\",\"UserName\":\"{TITLE}\","
+                        "\"Custom\":\"a \\\"quoted\\\" \\\\ value\",\"Missing\":null}"));
+    QCOMPARE(QJsonDocument::fromJson(lines[1]).object()["Custom"].toString(), QString("a \"quoted\" \\ value"));
+
+    // repeated fields are written once, in the order they first appear
+    QCOMPARE(writeEntries({entry}, EntryJsonWriter::NdjsonFormat, {"UserName", "Title", "UserName"}),
+             QByteArray("{\"UserName\":\"{TITLE}\",\"Title\":\"Entry\"}\n"));
+    QCOMPARE(EntryJsonWriter::entryPath(entry), QString("/Group/Sub/Entry"));
+
+    // paths follow renamed groups
+    group->setName("Renamed");
+    QCOMPARE(EntryJsonWriter::entryPath(entry), QString("/Renamed/Sub/Entry"));
+
+    const QByteArray resolved = writeEntries({entry}, EntryJsonWriter::NdjsonFormat, {"UserName"}, true);
+    QCOMPARE(resolved, QByteArray("{\"UserName\":\"Entry\"}\n"));
+}
+
+void TestCli::testSplitGroupPath()
+{
+    QCOMPARE(EntryImporter::splitGroupPath("", "Root"), QStringList());
+    QCOMPARE(EntryImporter::splitGroupPath("/", "Root"), QStringList());
+    QCOMPARE(EntryImporter::splitGroupPath("A/B", "Root"), QStringList({"A", "B"}));
+    QCOMPARE(EntryImporter::splitGroupPath("//A//B/", "Root"), QStringList({"A", "B"}));
+
+    // the CSV export starts paths with the name of the root group
+    QCOMPARE(EntryImporter::splitGroupPath("Root", "Root"), QStringList());
+    QCOMPARE(EntryImporter::splitGroupPath("Root/A", "Root"), QStringList({"A"}));
+    // a leading slash makes the path relative to the root group
+    QCOMPARE(EntryImporter::splitGroupPath("/Root/A", "Root"), QStringList({"Root", "A"}));
+    QCOMPARE(EntryImporter::splitGroupPath("A/Root", "Root"), QStringList({"A", "Root"}));
+
+    // path includes the title, group doesn't, other fields are attributes
+    ImportRecord record;
+    EntryImporter::setField(record, "Path", "Root/A/Title", "Root");
+    EntryImporter::setField(record, "USERNAME", "user", "Root");
+    EntryImporter::setField(record, "Custom", "value", "Root");
+    QCOMPARE(record.groupNames, QStringList({"A"}));
+    QCOMPARE(record.attributes.size(), 3);
+    QCOMPARE(record.attributes[0], qMakePair(QString("Title"), QString("Title")));
+    QCOMPARE(record.attributes[1], qMakePair(QString("UserName"), QString("user")));
+    QCOMPARE(record.attributes[2], qMakePair(QString("Custom"), QString("value")));
+}
+
+void TestCli::testEntryImporterGroups()
+{
+    Database db;
+    db.rootGroup()->setName("Root");
+    Group* existing = new Group();
+    existing->setUuid(Uuid::random());
+    existing->setName("A");
+    existing->setParent(db.rootGroup());
+
+    EntryImporter importer(&db, EntryImporter::DedupeNone, nullptr);
+    importer.importRecord(importRecord("/Top Entry"));
+    importer.importRecord(importRecord("/A/B/Deep Entry"));
+    importer.importRecord(importRecord("/A/B/Second Entry"));
+    importer.importRecord(importRecord("/C/New Entry"));
+    QCOMPARE(importer.importedCount(), 4);
+    QCOMPARE(importer.skippedCount(), 0);
+
+    // existing groups are reused, missing ones are created once
+    QCOMPARE(db.rootGroup()->children().size(), 2);
+    QCOMPARE(existing->children().size(), 1);
+    Group* created = existing->children().first();
+    QCOMPARE(created->name(), QString("B"));
+    QCOMPARE(created->entries().size(), 2);
+    QCOMPARE(db.rootGroup()->findEntryByPath("/Top Entry")->group(), db.rootGroup());
+    QCOMPARE(db.rootGroup()->findEntryByPath("/A/B/Deep Entry")->group(), created);
+    QCOMPARE(db.rootGroup()->findGroupByPath("/C/")->entries().size(), 1);
+}
+
+void TestCli::testEntryImporterDedupe()
+{
+    Database db;
+    db.rootGroup()->setName("Root");
+    Entry* existing = createEntry(db.rootGroup(), "Entry");
+    const QString uuid = existing->uuid().toHex();
+    const QString otherUuid = Uuid::random().toHex();
+
+    // the same path is skipped, also within the import
+    EntryImporter byPath(&db, EntryImporter::DedupePath, nullptr);
+    byPath.importRecord(importRecord("/Entry", otherUuid));
+    byPath.importRecord(importRecord("/Other"));
+    byPath.importRecord(importRecord("Root/Other"));
+    QCOMPARE(byPath.importedCount(), 1);
+    QCOMPARE(byPath.skippedCount(), 2);
+
+    // the same uuid is skipped, the same path isn't
+    EntryImporter byUuid(&db, EntryImporter::DedupeUuid, nullptr);
+    byUuid.importRecord(importRecord("/Renamed", uuid));
+    byUuid.importRecord(importRecord("/Entry", otherUuid));
+    QCOMPARE(byUuid.importedCount(), 1);
+    QCOMPARE(byUuid.skippedCount(), 1);
+    QCOMPARE(db.rootGroup()->findEntryByUuid(Uuid::fromHex(otherUuid))->title(), QString("Entry"));
+
+    // without dedupe everything is imported, a uuid that is taken is replaced
+    EntryImporter none(&db, EntryImporter::DedupeNone, nullptr);
+    none.importRecord(importRecord("/Entry", uuid));
+    QCOMPARE(none.importedCount(), 1);
+    QCOMPARE(db.rootGroup()->entries().size(), 4);
+    for (const Entry* entry : db.rootGroup()->entries()) {
+        QVERIFY(entry == existing || entry->uuid() != existing->uuid());
+    }
+}
@@ -0,0 +1,211 @@
+/*
+ *  Copyright (C) 2018 KeePassXC Team <team@keepassxc.org>
+ *
+ *  This program is free software: you can redistribute it and/or modify
+ *  it under the terms of the GNU General Public License as published by
+ *  the Free Software Foundation, either version 2 or (at your option)
+ *  version 3 of the License.
+ *
+ *  This program is distributed in the hope that it will be useful,
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *  GNU General Public License for more details.
+ *
+ *  You should have received a copy of the GNU General Public License
+ *  along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+#include "TestCliStartup.h"
+#include "TestGlobal.h"
+
+#include <QProcess>
+#include <QTemporaryDir>
+
+#include "cli/Command.h"
+#include "config-keepassx-tests.h"
+#include "core/Database.h"
+#include "core/Entry.h"
+#include "core/Group.h"
+#include "crypto/Crypto.h"
+#include "crypto/kdf/Kdf.h"
+#include "format/KeePass2Writer.h"
+#include "keys/PasswordKey.h"
+
+QTEST_GUILESS_MAIN(TestCliStartup)
+
+void TestCliStartup::initTestCase()
+{
+    QVERIFY(Crypto::init());
+
+    // tiny database with a single round of the key derivation, so that
+    // the measurements are dominated by the process startup
+    Database db;
+    CompositeKey key;
+    key.addKey(PasswordKey("a"));
+    db.setKey(key);
+    QSharedPointer<Kdf> kdf = db.kdf();
+    kdf->setRounds(1);
+    db.changeKdf(kdf);
+
+    Entry* entry = new Entry();
+    entry->setUuid(Uuid::random());
+    entry->setTitle("Sample Entry");
+    entry->setUsername("User Name");
+    entry->setPassword("Password");
+    entry->setGroup(db.rootGroup());
+
+    QVERIFY(m_dbFile.open());
+    KeePass2Writer writer;
+    QVERIFY(writer.writeDatabase(&m_dbFile, &db));
+    m_dbFile.close();
+}
+
+void TestCliStartup::testVersion()
+{
+    QByteArray output;
+    QCOMPARE(runCli({"--version"}, QByteArray(), &output), 0);
+    QVERIFY(!output.trimmed().isEmpty());
+}
+
+void TestCliStartup::testShow()
+{
+    QByteArray output;
+    QCOMPARE(runCli({"show", m_dbFile.fileName(), "Sample Entry"}, "a\n", &output), 0);
+    QVERIFY(output.contains("UserName: User Name"));
+}
+
+void TestCliStartup::testCanRunInSession()
+{
+    const QString path = m_dbFile.fileName();
+    QVERIFY(Command::getCommand("show")->canRunInSession({"show", path, "Sample Entry"}));
+    QVERIFY(!Command::getCommand("clip")->canRunInSession({"clip", path, "Sample Entry"}));
+
+    // prompting for the password needs the terminal, also in compacted options
+    Command* add = Command::getCommand("add");
+    QVERIFY(add->canRunInSession({"add", "-g", path, "Entry"}));
+    QVERIFY(!add->canRunInSession({"add", "-p", path, "Entry"}));
+    QVERIFY(!add->canRunInSession({"add", "-gp", path, "Entry"}));
+    QVERIFY(!add->canRunInSession({"add", "--password-prompt", path, "Entry"}));
+
+    // -t takes a value, so -tp sets the title "p"
+    Command* edit = Command::getCommand("edit");
+    QVERIFY(edit->canRunInSession({"edit", "-tp", path, "Sample Entry"}));
+    QVERIFY(!edit->canRunInSession({"edit", "-pt", "Title", path, "Sample Entry"}));
+}
+
+void TestCliStartup::testSession()
+{
+    QTemporaryDir dir;
+    QVERIFY(dir.isValid());
+    const QString path = dir.path() + "/session.kdbx";
+    QVERIFY(QFile::copy(m_dbFile.fileName(), path));
+
+    QProcess session;
+    session.start(KEEPASSXC_CLI_PATH, {"session", "start", "--save-interval", "0", path});
+    QVERIFY(session.waitForStarted());
+    session.write("a\n");
+    session.closeWriteChannel();
+
+    QByteArray started;
+    while (!started.contains("Session started") && session.waitForReadyRead(5000)) {
+        started.append(session.readAllStandardOutput());
+    }
+    QVERIFY(started.contains("Session started"));
+
+    // forwarded commands don't ask for the password
+    QByteArray output;
+    QCOMPARE(runCli({"add", "-u", "New User", path, "New Entry"}, QByteArray(), &output), 0);
+    QVERIFY(output.contains("Successfully added entry New Entry."));
+    QCOMPARE(runCli({"show", path, "New Entry"}, QByteArray(), &output), 0);
+    QVERIFY(output.contains("UserName: New User"));
+
+    QCOMPARE(runCli({"session", "stop", path}, QByteArray(), &output), 0);
+    QVERIFY(output.contains("Session stopped."));
+    QVERIFY(session.waitForFinished());
+    QCOMPARE(session.exitStatus(), QProcess::NormalExit);
+    QCOMPARE(session.exitCode(), 0);
+
+    // the session wrote the entry, and this time show has to unlock the database
+    QCOMPARE(runCli({"session", "save", path}), 1);
+    QCOMPARE(runCli({"show", path, "New Entry"}, "a\n", &output), 0);
+    QVERIFY(output.contains("UserName: New User"));
+}
+
+void TestCliStartup::testOpen()
+{
+    QTemporaryDir dir;
+    QVERIFY(dir.isValid());
+    const QString path = dir.path() + "/open.kdbx";
+    QVERIFY(QFile::copy(m_dbFile.fileName(), path));
+
+    // the password and the commands come from the same input
+    QByteArray output;
+    QCOMPARE(runCli({"open", path},
+                    "a\n"
+                    "# comments and empty lines are skipped\n"
+                    "\n"
+                    "add -u \"New User\" 'Two Words'\n"
+                    "show Two\\ Words\n"
+                    "invalid\n",
+                    &output),
+             1);
+    QVERIFY(output.contains("Successfully added entry Two Words."));
+    QVERIFY(output.contains("UserName: New User"));
+
+    // the changes are written at the end of the input even though a command failed
+    QCOMPARE(runCli({"show", path, "Two Words"}, "a\n", &output), 0);
+    QVERIFY(output.contains("UserName: New User"));
+
+    // save writes right away, quit writes and ignores the rest of the input
+    QCOMPARE(runCli({"open", path}, "a\nrm 'Two Words'\nsave\nadd Second\nquit\nadd Third\n", &output), 0);
+    QVERIFY(output.contains("Successfully saved the database."));
+    QCOMPARE(runCli({"show", path, "Two Words"}, "a\n"), 1);
+    QCOMPARE(runCli({"show", path, "Second"}, "a\n"), 0);
+    QCOMPARE(runCli({"show", path, "Third"}, "a\n"), 1);
+}
+
+void TestCliStartup::benchmarkVersion()
+{
+    QByteArray env = qgetenv("BENCHMARK");
+
+    if (env.isEmpty() || env == "0" || env == "no") {
+        QSKIP("Benchmark skipped. Set env variable BENCHMARK=1 to enable.");
+    }
+
+    QBENCHMARK
+    {
+        QCOMPARE(runCli({"--version"}), 0);
+    }
+}
+
+void TestCliStartup::benchmarkShow()
+{
+    QByteArray env = qgetenv("BENCHMARK");
+
+    if (env.isEmpty() || env == "0" || env == "no") {
+        QSKIP("Benchmark skipped. Set env variable BENCHMARK=1 to enable.");
+    }
+
+    QBENCHMARK
+    {
+        QCOMPARE(runCli({"show", m_dbFile.fileName(), "Sample Entry"}, "a\n"), 0);
+    }
+}
+
+int TestCliStartup::runCli(const QStringList& arguments, const QByteArray& input, QByteArray* output)
+{
+    QProcess process;
+    process.start(KEEPASSXC_CLI_PATH, arguments);
+    if (!process.waitForStarted()) {
+        return -1;
+    }
+    process.write(input);
+    process.closeWriteChannel();
+    if (!process.waitForFinished() || process.exitStatus() != QProcess::NormalExit) {
+        return -1;
+    }
+
+    if (output) {
+        *output = process.readAllStandardOutput();
+    }
+    return process.exitCode();
+}
@@ -343,3 +343,14 @@ void TestCsvParser::testUnicode()
     QVERIFY(t.at(0).at(2) == "3śAż");
     QVERIFY(t.at(0).at(3) == "żac");
 }
+
+void TestCsvParser::testBuffer()
+{
+    QBuffer buffer;
+    buffer.setData("\"Group\",\"Title\"\n\"Root/a\",\"b\"\n");
+    QVERIFY(parser->parse(&buffer));
+    t = parser->getCsvTable();
+    QCOMPARE(t.size(), 2);
+    QCOMPARE(t.at(1).at(0), QString("Root/a"));
+    QCOMPARE(t.at(1).at(1), QString("b"));
+}
@@ -59,6 +59,7 @@ private slots:
     void testQuoted();
     void testMultiline();
     void testColumns();
+    void testBuffer();
 
 private:
     QScopedPointer<QTemporaryFile> file;
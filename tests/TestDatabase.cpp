@@ -19,10 +19,19 @@
 #include "TestDatabase.h"
 #include "TestGlobal.h"
 
+#include <QPointer>
+#include <QSemaphore>
 #include <QSignalSpy>
 #include <QTemporaryFile>
+#include <QUrl>
+#include <QtConcurrent>
 
 #include "config-keepassx-tests.h"
+#include "core/DatabaseAccess.h"
+#include "core/DatabaseDelta.h"
+#include "core/EntrySearcher.h"
+#include "core/Group.h"
+#include "core/HostIndex.h"
 #include "core/Metadata.h"
 #include "crypto/Crypto.h"
 #include "format/KeePass2Writer.h"
@@ -109,3 +118,222 @@ void TestDatabase::testEmptyRecycleBinWithHierarchicalData()
 
     delete db;
 }
+
+void TestDatabase::testDeltaReload()
+{
+    Database* db = new Database();
+    Group* group1 = new Group();
+    group1->setUuid(Uuid::random());
+    group1->setName("group1");
+    group1->setParent(db->rootGroup());
+    Group* group2 = new Group();
+    group2->setUuid(Uuid::random());
+    group2->setName("group2");
+    group2->setParent(db->rootGroup());
+
+    Entry* entry1 = new Entry();
+    entry1->setUuid(Uuid::random());
+    entry1->setTitle("entry1");
+    entry1->setGroup(group1);
+    Entry* entry2 = new Entry();
+    entry2->setUuid(Uuid::random());
+    entry2->setTitle("entry2");
+    entry2->setGroup(group1);
+    QPointer<Entry> entry3 = new Entry();
+    entry3->setUuid(Uuid::random());
+    entry3->setTitle("entry3");
+    entry3->setGroup(group2);
+
+    // the reloaded file is a copy of the database with changes made by someone else
+    Database* reloadedDb = new Database();
+    reloadedDb->setRootGroup(db->rootGroup()->clone(Entry::CloneIncludeHistory, Group::CloneIncludeEntries));
+    Group* reloadedGroup2 = reloadedDb->rootGroup()->findChildByUuid(group2->uuid());
+    Group* reloadedGroup3 = new Group();
+    reloadedGroup3->setUuid(Uuid::random());
+    reloadedGroup3->setName("group3");
+    reloadedGroup3->setParent(reloadedDb->rootGroup());
+    reloadedGroup2->setParent(reloadedGroup3);
+
+    Entry* reloadedEntry1 = reloadedDb->resolveEntry(entry1->uuid());
+    reloadedEntry1->beginUpdate();
+    reloadedEntry1->setTitle("entry1 changed");
+    reloadedEntry1->endUpdate();
+    reloadedDb->resolveEntry(entry2->uuid())->setGroup(reloadedGroup2);
+    delete reloadedDb->resolveEntry(entry3->uuid());
+    Entry* reloadedEntry4 = new Entry();
+    reloadedEntry4->setUuid(Uuid::random());
+    reloadedEntry4->setTitle("entry4");
+    reloadedEntry4->setGroup(reloadedGroup3);
+    reloadedDb->metadata()->setName("reloaded");
+
+    QSignalSpy spyNameChanged(db->metadata(), SIGNAL(nameTextChanged()));
+    QSignalSpy spyGroupAdded(db, SIGNAL(groupAboutToAdd(Group*, int)));
+    QSignalSpy spyGroupMoved(db, SIGNAL(groupAboutToMove(Group*, Group*, int)));
+    QSignalSpy spyGroupRemoved(db, SIGNAL(groupAboutToRemove(Group*)));
+    QSignalSpy spyEntryDataChanged(group1, SIGNAL(entryDataChanged(Entry*)));
+    QSignalSpy spyEntryRemoved(group1, SIGNAL(entryAboutToRemove(Entry*)));
+
+    DatabaseDelta delta(reloadedDb, db);
+    QVERIFY(delta.apply());
+
+    QCOMPARE(spyGroupAdded.count(), 1);
+    QCOMPARE(spyGroupMoved.count(), 1);
+    QCOMPARE(spyGroupRemoved.count(), 0);
+    QCOMPARE(spyEntryDataChanged.count(), 1);
+    QCOMPARE(spyEntryRemoved.count(), 1);
+    QCOMPARE(spyNameChanged.count(), 1);
+    QCOMPARE(db->metadata()->name(), QString("reloaded"));
+
+    // unchanged objects keep their identity
+    QCOMPARE(db->resolveEntry(entry1->uuid()), entry1);
+    QCOMPARE(entry1->title(), QString("entry1 changed"));
+    QCOMPARE(entry1->historyItems().size(), 1);
+    QCOMPARE(entry1->timeInfo().lastModificationTime(), reloadedEntry1->timeInfo().lastModificationTime());
+    QCOMPARE(entry2->group(), group2);
+    QVERIFY(entry3.isNull());
+
+    Group* group3 = db->resolveGroup(reloadedGroup3->uuid());
+    QVERIFY(group3);
+    QCOMPARE(group2->parentGroup(), group3);
+    QCOMPARE(group3->entries().size(), 1);
+    QCOMPARE(group3->entries().first()->title(), QString("entry4"));
+    QCOMPARE(group3->timeInfo().lastModificationTime(), reloadedGroup3->timeInfo().lastModificationTime());
+
+    // applying the same file again is a no-op
+    DatabaseDelta secondDelta(reloadedDb, db);
+    QVERIFY(secondDelta.apply());
+    QCOMPARE(secondDelta.changeCount(), 0);
+
+    // a different database can't be applied
+    Database* otherDb = new Database();
+    DatabaseDelta otherDelta(otherDb, db);
+    QVERIFY(!otherDelta.apply());
+
+    delete otherDb;
+    delete reloadedDb;
+    delete db;
+}
+
+void TestDatabase::testHostIndex()
+{
+    Database db;
+    Group* root = db.rootGroup();
+
+    Entry* urlEntry = new Entry();
+    urlEntry->setUuid(Uuid::random());
+    urlEntry->setTitle("Example login");
+    urlEntry->setUrl("https://Login.Example.com/path?query");
+    urlEntry->setGroup(root);
+
+    Entry* titleEntry = new Entry();
+    titleEntry->setUuid(Uuid::random());
+    titleEntry->setTitle("example.com");
+    titleEntry->setGroup(root);
+
+    Group* hiddenGroup = new Group();
+    hiddenGroup->setUuid(Uuid::random());
+    hiddenGroup->setSearchingEnabled(Group::Disable);
+    hiddenGroup->setParent(root);
+    Entry* hiddenEntry = new Entry();
+    hiddenEntry->setUuid(Uuid::random());
+    hiddenEntry->setUrl("https://example.com");
+    hiddenEntry->setGroup(hiddenGroup);
+
+    HostIndex* index = db.hostIndex();
+    QCOMPARE(index->entries("login.example.com"), QList<Entry*>() << urlEntry);
+    QCOMPARE(index->entries("example.com"), QList<Entry*>() << titleEntry);
+    QVERIFY(index->entries("other.example.com").isEmpty());
+    QVERIFY(index->isValid());
+
+    // edits update the index in place and are visible on the next lookup
+    urlEntry->setUrl("https://example.com");
+    QVERIFY(index->isValid());
+    QVERIFY(index->entries("login.example.com").isEmpty());
+    QCOMPARE(index->entries("example.com"), QList<Entry*>() << urlEntry << titleEntry);
+
+    hiddenGroup->setSearchingEnabled(Group::Inherit);
+    QCOMPARE(index->entries("example.com"), QList<Entry*>() << urlEntry << titleEntry << hiddenEntry);
+
+    delete titleEntry;
+    QVERIFY(index->isValid());
+    QCOMPARE(index->entries("example.com"), QList<Entry*>() << urlEntry << hiddenEntry);
+
+    // a title that is part of the host name matches if the search finds the
+    // entry, here through its URL
+    Entry* partialTitleEntry = new Entry();
+    partialTitleEntry->setUuid(Uuid::random());
+    partialTitleEntry->setTitle("example");
+    partialTitleEntry->setUrl("https://www.example.org/login");
+    partialTitleEntry->setGroup(root);
+    QCOMPARE(index->entries("www.example.org"), QList<Entry*>() << partialTitleEntry);
+    QCOMPARE(index->entries("example.org"), QList<Entry*>() << partialTitleEntry);
+
+    // or through the name of one of its groups
+    Group* mailGroup = new Group();
+    mailGroup->setUuid(Uuid::random());
+    mailGroup->setName("mail.example.net");
+    mailGroup->setParent(root);
+    Entry* groupNameEntry = new Entry();
+    groupNameEntry->setUuid(Uuid::random());
+    groupNameEntry->setTitle("example.net");
+    groupNameEntry->setGroup(mailGroup);
+    QCOMPARE(index->entries("mail.example.net"), QList<Entry*>() << groupNameEntry);
+    mailGroup->setName("mail");
+    QVERIFY(index->entries("mail.example.net").isEmpty());
+
+    // the host of a Title or URL with a scheme may be a suffix of the host name
+    QCOMPARE(index->entries("login.example.com"), QList<Entry*>());
+    urlEntry->setNotes("login.example.com");
+    QCOMPARE(index->entries("login.example.com"), QList<Entry*>() << urlEntry);
+
+    // the result is the one of the previous search and filter
+    const QStringList hostnames = QStringList() << "example.com" << "login.example.com" << "www.example.org"
+                                                << "example.org" << "mail.example.net" << "example.net";
+    for (const QString& hostname : hostnames) {
+        QList<Entry*> expected;
+        for (Entry* entry : EntrySearcher().search(hostname, root, Qt::CaseInsensitive)) {
+            const QString title = entry->title();
+            const QString url = entry->url();
+            if ((!title.isEmpty() && hostname.contains(title)) || (!url.isEmpty() && hostname.contains(url))
+                || (!QUrl(title).scheme().isEmpty() && hostname.endsWith(QUrl(title).host()))
+                || (!QUrl(url).scheme().isEmpty() && hostname.endsWith(QUrl(url).host()))) {
+                expected.append(entry);
+            }
+        }
+        QCOMPARE(index->entries(hostname), expected);
+    }
+}
+
+void TestDatabase::testDatabaseAccess()
+{
+    QSemaphore started;
+    QSemaphore finished;
+    auto read = [&started, &finished]() {
+        started.release();
+        DatabaseAccess::ReadLocker locker;
+        finished.release();
+    };
+
+    // nothing holds the write lock while the GUI thread is idle
+    QtConcurrent::run(read).waitForFinished();
+    QVERIFY(started.tryAcquire());
+    QVERIFY(finished.tryAcquire());
+
+    QFuture<void> future;
+    {
+        DatabaseAccess::WriteLocker locker;
+        {
+            // nested lockers on the GUI thread must not deadlock
+            DatabaseAccess::WriteLocker nestedLocker;
+            DatabaseAccess::ReadLocker readLocker;
+        }
+
+        // the reader has started but can't get past the read lock
+        future = QtConcurrent::run(read);
+        started.acquire();
+        QVERIFY(!finished.tryAcquire());
+        QVERIFY(!future.isFinished());
+    }
+    future.waitForFinished();
+    QVERIFY(finished.tryAcquire());
+}
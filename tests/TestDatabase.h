@@ -31,6 +31,9 @@ private slots:
     void testEmptyRecycleBinOnNotCreated();
     void testEmptyRecycleBinOnEmpty();
     void testEmptyRecycleBinWithHierarchicalData();
+    void testDeltaReload();
+    void testHostIndex();
+    void testDatabaseAccess();
 };
 
 #endif // KEEPASSX_TESTDATABASE_H
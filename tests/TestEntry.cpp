@@ -21,6 +21,7 @@
 #include "TestEntry.h"
 #include "TestGlobal.h"
 #include "crypto/Crypto.h"
+#include "totp/totp.h"
 
 QTEST_GUILESS_MAIN(TestEntry)
 
@@ -557,3 +558,177 @@ void TestEntry::testResolveClonedEntry()
     QCOMPARE(cclone4->resolveMultiplePlaceholders(cclone4->username()), original->username());
     QCOMPARE(cclone4->resolveMultiplePlaceholders(cclone4->password()), original->password());
 }
+
+void TestEntry::testAttributes()
+{
+    QScopedPointer<Entry> entry(new Entry());
+    EntryAttributes* attributes = entry->attributes();
+
+    attributes->set("b", "custom b");
+    attributes->set("Aa", "custom Aa", true);
+    attributes->set("Z", "custom Z");
+    entry->setTitle("title");
+    entry->setPassword("password");
+    attributes->set(EntryAttributes::PasswordKey, entry->password(), true);
+
+    // keys are sorted with the default attributes interleaved
+    QCOMPARE(attributes->keys(),
+             QList<QString>() << "Aa"
+                              << "Notes"
+                              << "Password"
+                              << "Title"
+                              << "URL"
+                              << "UserName"
+                              << "Z"
+                              << "b");
+    QCOMPARE(attributes->customKeys(), QList<QString>() << "Aa" << "Z" << "b");
+
+    QCOMPARE(entry->title(), QString("title"));
+    QCOMPARE(attributes->value(EntryAttributes::TitleKey), QString("title"));
+    QCOMPARE(attributes->value("b"), QString("custom b"));
+    QVERIFY(attributes->value("missing").isNull());
+    QVERIFY(attributes->hasKey(EntryAttributes::NotesKey));
+    QVERIFY(!attributes->hasKey("missing"));
+    QVERIFY(attributes->isProtected(EntryAttributes::PasswordKey));
+    QVERIFY(attributes->isProtected("Aa"));
+    QVERIFY(!attributes->isProtected("b"));
+    QVERIFY(attributes->containsValue("custom Z"));
+    QVERIFY(!attributes->containsValue("missing"));
+
+    attributes->rename("Aa", "c");
+    QCOMPARE(attributes->customKeys(), QList<QString>() << "Z" << "b" << "c");
+    QVERIFY(attributes->isProtected("c"));
+    QCOMPARE(attributes->value("c"), QString("custom Aa"));
+
+    attributes->remove("Z");
+    QCOMPARE(attributes->customKeys(), QList<QString>() << "b" << "c");
+
+    EntryAttributes copy;
+    QVERIFY(copy.areCustomKeysDifferent(attributes));
+    copy.copyCustomKeysFrom(attributes);
+    QVERIFY(!copy.areCustomKeysDifferent(attributes));
+    QVERIFY(copy != *attributes);
+    copy.copyDataFrom(attributes);
+    QVERIFY(copy == *attributes);
+    QCOMPARE(copy.attributesSize(), attributes->attributesSize());
+
+    attributes->clear();
+    QCOMPARE(attributes->keys().size(), EntryAttributes::DefaultAttributes.size());
+    QCOMPARE(entry->title(), QString(""));
+    QVERIFY(!attributes->isProtected(EntryAttributes::PasswordKey));
+}
+
+void TestEntry::testAttributesCopyOnWrite()
+{
+    QScopedPointer<Entry> entry(new Entry());
+    entry->setTitle("title");
+    entry->attributes()->set("custom", "value", true);
+
+    QScopedPointer<Entry> clone(entry->clone(Entry::CloneNoFlags));
+    QVERIFY(*clone->attributes() == *entry->attributes());
+
+    clone->setTitle("changed title");
+    clone->attributes()->set("custom", "changed value", true);
+    clone->attributes()->set("added", "value");
+    QCOMPARE(entry->title(), QString("title"));
+    QCOMPARE(entry->attributes()->value("custom"), QString("value"));
+    QVERIFY(!entry->attributes()->hasKey("added"));
+    QCOMPARE(clone->title(), QString("changed title"));
+    QCOMPARE(clone->attributes()->value("custom"), QString("changed value"));
+
+    entry->beginUpdate();
+    entry->attributes()->rename("custom", "renamed");
+    QVERIFY(entry->endUpdate());
+    QCOMPARE(entry->historyItems().size(), 1);
+
+    const Entry* historyItem = entry->historyItems().first();
+    QVERIFY(historyItem->attributes()->hasKey("custom"));
+    QVERIFY(!historyItem->attributes()->hasKey("renamed"));
+    QVERIFY(entry->attributes()->isProtected("renamed"));
+    QCOMPARE(entry->attributes()->value("renamed"), QString("value"));
+}
+
+void TestEntry::testAttachmentsCopyOnWrite()
+{
+    QScopedPointer<Entry> entry(new Entry());
+    entry->attachments()->set("a", QByteArray("attachment a"));
+
+    QScopedPointer<Entry> clone(entry->clone(Entry::CloneNoFlags));
+    QVERIFY(*clone->attachments() == *entry->attachments());
+
+    clone->attachments()->set("a", QByteArray("changed"));
+    clone->attachments()->set("b", QByteArray("attachment b"));
+    QCOMPARE(entry->attachments()->value("a"), QByteArray("attachment a"));
+    QVERIFY(!entry->attachments()->hasKey("b"));
+    QCOMPARE(clone->attachments()->value("a"), QByteArray("changed"));
+
+    entry->beginUpdate();
+    entry->attachments()->remove("a");
+    QVERIFY(entry->endUpdate());
+    QCOMPARE(entry->historyItems().size(), 1);
+
+    const Entry* historyItem = entry->historyItems().first();
+    QCOMPARE(historyItem->attachments()->value("a"), QByteArray("attachment a"));
+    QVERIFY(entry->attachments()->isEmpty());
+}
+
+void TestEntry::testTotpSettings()
+{
+    QScopedPointer<Entry> entry(new Entry());
+    QVERIFY(!entry->hasTotp());
+    QCOMPARE(entry->totpStep(), Totp::defaultStep);
+    QCOMPARE(entry->totpDigits(), Totp::defaultDigits);
+
+    entry->attributes()->set("TOTP Seed", "gezdgnbvgy3tqojqgezdgnbvgy3tqojq", true);
+    entry->attributes()->set("TOTP Settings", "60;8");
+    QCOMPARE(entry->totpStep(), quint8(60));
+    QCOMPARE(entry->totpDigits(), quint8(8));
+    QCOMPARE(entry->totpSeed(), QString("gezdgnbvgy3tqojqgezdgnbvgy3tqojq"));
+
+    // the settings of an otp string are known without calling totpSeed() first
+    entry.reset(new Entry());
+    entry->attributes()->set("otp", "key=gezdgnbvgy3tqojqgezdgnbvgy3tqojq&step=45&size=8", true);
+    QCOMPARE(entry->totpStep(), quint8(45));
+    QCOMPARE(entry->totpDigits(), quint8(8));
+    QCOMPARE(entry->totpSeed(), QString("gezdgnbvgy3tqojqgezdgnbvgy3tqojq"));
+    QCOMPARE(entry->totpStep(), quint8(45));
+
+    entry->attributes()->remove("otp");
+    QCOMPARE(entry->totpStep(), Totp::defaultStep);
+    QCOMPARE(entry->totpDigits(), Totp::defaultDigits);
+}
+
+void TestEntry::benchmarkAttributeAccessors()
+{
+    QByteArray env = qgetenv("BENCHMARK");
+
+    if (env.isEmpty() || env == "0" || env == "no") {
+        QSKIP("Benchmark skipped. Set env variable BENCHMARK=1 to enable.");
+    }
+
+    QList<Entry*> entries;
+    for (int i = 0; i < 1000; ++i) {
+        Entry* entry = new Entry();
+        entry->setTitle(QString("Title %1").arg(i));
+        entry->setUsername(QString("user%1").arg(i));
+        entry->setPassword(QString("password%1").arg(i));
+        entry->setUrl(QString("https://example%1.com").arg(i));
+        entry->setNotes(QString("Notes %1").arg(i));
+        for (int j = 0; j < 5; ++j) {
+            entry->attributes()->set(QString("Custom %1").arg(j), QString::number(j));
+        }
+        entries << entry;
+    }
+
+    int size = 0;
+    QBENCHMARK
+    {
+        for (const Entry* entry : asConst(entries)) {
+            size += entry->title().size() + entry->username().size() + entry->password().size()
+                    + entry->url().size() + entry->notes().size();
+        }
+    };
+    QVERIFY(size > 0);
+
+    qDeleteAll(entries);
+}
@@ -37,6 +37,11 @@ private slots:
     void testResolveReferencePlaceholders();
     void testResolveNonIdPlaceholdersToUuid();
     void testResolveClonedEntry();
+    void testAttributes();
+    void testAttributesCopyOnWrite();
+    void testAttachmentsCopyOnWrite();
+    void testTotpSettings();
+    void benchmarkAttributeAccessors();
 };
 
 #endif // KEEPASSX_TESTENTRY_H
@@ -22,6 +22,7 @@
 #include <QSignalSpy>
 
 #include "core/Metadata.h"
+#include "core/PathIndex.h"
 #include "crypto/Crypto.h"
 
 QTEST_GUILESS_MAIN(TestGroup)
@@ -740,3 +741,266 @@ void TestGroup::testAddEntryWithPath()
 
     delete db;
 }
+
+void TestGroup::testPathIndexUpdates()
+{
+    QScopedPointer<Database> db(new Database());
+
+    Group* group1 = new Group();
+    group1->setName("group1");
+    group1->setParent(db->rootGroup());
+
+    Group* group2 = new Group();
+    group2->setName("group2");
+    group2->setParent(db->rootGroup());
+
+    Entry* entry = db->rootGroup()->addEntryWithPath("/group1/entry1");
+    QVERIFY(entry != nullptr);
+    QCOMPARE(db->rootGroup()->findEntryByPath("group1/entry1"), entry);
+    QCOMPARE(db->rootGroup()->findEntry(entry->uuid().toHex()), entry);
+    QCOMPARE(db->rootGroup()->findEntry("entry1"), entry);
+
+    // Renaming the group changes the path of the entry
+    group1->setName("renamed");
+    QVERIFY(db->rootGroup()->findGroupByPath("/group1/") == nullptr);
+    QCOMPARE(db->rootGroup()->findGroupByPath("/renamed/"), group1);
+    QVERIFY(db->rootGroup()->findEntryByPath("/group1/entry1") == nullptr);
+    QCOMPARE(db->rootGroup()->findEntryByPath("/renamed/entry1"), entry);
+
+    // Moving the group nests its path below the new parent
+    group1->setParent(group2);
+    QVERIFY(db->rootGroup()->findEntryByPath("/renamed/entry1") == nullptr);
+    QCOMPARE(db->rootGroup()->findEntryByPath("/group2/renamed/entry1"), entry);
+    QCOMPARE(db->rootGroup()->findGroupByPath("group2/renamed"), group1);
+
+    // Moving and renaming the entry
+    entry->setGroup(db->rootGroup());
+    entry->setTitle("entry2");
+    QVERIFY(db->rootGroup()->findEntryByPath("/group2/renamed/entry1") == nullptr);
+    QVERIFY(db->rootGroup()->findEntry("entry1") == nullptr);
+    QCOMPARE(db->rootGroup()->findEntryByPath("/entry2"), entry);
+    QCOMPARE(db->rootGroup()->findEntry("entry2"), entry);
+
+    // Lookups relative to a subgroup are not served by the index
+    Entry* nested = db->rootGroup()->addEntryWithPath("group2/renamed/entry3");
+    QVERIFY(nested != nullptr);
+    QCOMPARE(group2->findEntryByPath("renamed/entry3"), nested);
+    QCOMPARE(group2->findGroupByPath("renamed", "/"), group1);
+
+    // Deleted entries and groups disappear from the index
+    Uuid uuid = entry->uuid();
+    delete entry;
+    QVERIFY(db->rootGroup()->findEntryByPath("entry2") == nullptr);
+    QVERIFY(db->rootGroup()->findEntryByUuid(uuid) == nullptr);
+
+    delete group2;
+    QVERIFY(db->rootGroup()->findGroupByPath("/group2/renamed/") == nullptr);
+    QVERIFY(db->rootGroup()->findEntry("entry3") == nullptr);
+
+    // Edits that don't touch a path keep the index, renames update it in place
+    PathIndex* index = db->pathIndex();
+    Group* group3 = new Group();
+    group3->setName("group3");
+    group3->setParent(db->rootGroup());
+    Entry* entry4 = db->rootGroup()->addEntryWithPath("group3/entry4");
+    QCOMPARE(db->rootGroup()->findEntryByPath("group3/entry4"), entry4);
+    QVERIFY(index->isValid());
+
+    entry4->setPassword("password");
+    entry4->setNotes("notes");
+    QVERIFY(index->isValid());
+
+    entry4->setTitle("entry5");
+    QVERIFY(index->isValid());
+    QVERIFY(db->rootGroup()->findEntryByPath("group3/entry4") == nullptr);
+    QCOMPARE(db->rootGroup()->findEntryByPath("group3/entry5"), entry4);
+
+    group3->setName("group4");
+    QVERIFY(index->isValid());
+    QVERIFY(db->rootGroup()->findGroupByPath("group3") == nullptr);
+    QCOMPARE(db->rootGroup()->findGroupByPath("group4"), group3);
+    QCOMPARE(db->rootGroup()->findEntryByPath("group4/entry5"), entry4);
+
+    entry4->setGroup(db->rootGroup());
+    QVERIFY(index->isValid());
+    QCOMPARE(db->rootGroup()->findEntryByPath("entry5"), entry4);
+}
+
+void TestGroup::testPathIndexUuidChange()
+{
+    QScopedPointer<Database> db(new Database());
+
+    Entry* entry = db->rootGroup()->addEntryWithPath("/group1/entry1");
+    QVERIFY(entry != nullptr);
+    Uuid oldUuid = entry->uuid();
+    QCOMPARE(db->rootGroup()->findEntryByUuid(oldUuid), entry);
+    QVERIFY(db->pathIndex()->isValid());
+
+    Uuid newUuid = Uuid::random();
+    entry->setUuid(newUuid);
+    QVERIFY(db->rootGroup()->findEntryByUuid(oldUuid) == nullptr);
+    QCOMPARE(db->rootGroup()->findEntryByUuid(newUuid), entry);
+    QCOMPARE(db->rootGroup()->findEntry(newUuid.toHex()), entry);
+    QCOMPARE(db->rootGroup()->findEntryByPath("/group1/entry1"), entry);
+}
+
+void TestGroup::testPathIndexDuplicates()
+{
+    QScopedPointer<Database> db(new Database());
+    PathIndex* index = db->pathIndex();
+
+    Group* group1 = new Group();
+    group1->setName("group1");
+    group1->setParent(db->rootGroup());
+
+    Entry* nested = db->rootGroup()->addEntryWithPath("group1/login");
+    QCOMPARE(db->rootGroup()->findEntry("login"), nested);
+
+    // repeated titles keep the index valid, entries of a group come before
+    // those of its subgroups
+    QList<Entry*> entries;
+    for (int i = 0; i < 10; ++i) {
+        entries << db->rootGroup()->addEntryWithPath("login");
+        QVERIFY(index->isValid());
+    }
+    QCOMPARE(db->rootGroup()->findEntry("login"), entries.first());
+    QCOMPARE(db->rootGroup()->findEntryByPath("login"), entries.first());
+    QCOMPARE(db->rootGroup()->findEntryByPath("group1/login"), nested);
+
+    delete entries.first();
+    QCOMPARE(db->rootGroup()->findEntry("login"), entries.at(1));
+
+    // the first of two groups with the same name wins
+    Group* group2 = new Group();
+    group2->setName("group1");
+    group2->setParent(db->rootGroup());
+    QCOMPARE(db->rootGroup()->findGroupByPath("group1"), group1);
+    group1->setName("other");
+    QCOMPARE(db->rootGroup()->findGroupByPath("group1"), group2);
+}
+
+void TestGroup::testWalk()
+{
+    Database* db = new Database();
+
+    Group* group1 = new Group();
+    group1->setName("group1");
+    group1->setParent(db->rootGroup());
+
+    Group* group2 = new Group();
+    group2->setName("group2");
+    group2->setParent(group1);
+
+    Group* group3 = new Group();
+    group3->setName("group3");
+    group3->setParent(db->rootGroup());
+
+    Entry* entry1 = new Entry();
+    entry1->setTitle("entry1");
+    entry1->setGroup(group1);
+
+    Entry* entry2 = new Entry();
+    entry2->setTitle("entry2");
+    entry2->setGroup(group2);
+
+    Entry* entry3 = new Entry();
+    entry3->setTitle("entry3");
+    entry3->setGroup(group3);
+
+    entry1->beginUpdate();
+    entry1->setTitle("entry1 renamed");
+    entry1->endUpdate();
+    QCOMPARE(entry1->historyItems().size(), 1);
+
+    QList<Group*> groups;
+    bool stopped = db->rootGroup()->walkGroups([&groups](Group* group) {
+        groups.append(group);
+        return false;
+    });
+    QVERIFY(!stopped);
+    QCOMPARE(groups, QList<Group*>() << db->rootGroup() << group1 << group2 << group3);
+    QCOMPARE(groups, db->rootGroup()->groupsRecursive(true));
+
+    QList<Entry*> entries;
+    stopped = db->rootGroup()->walkEntries([&entries](Entry* entry) {
+        entries.append(entry);
+        return false;
+    });
+    QVERIFY(!stopped);
+    QCOMPARE(entries, QList<Entry*>() << entry1 << entry2 << entry3);
+
+    entries.clear();
+    db->rootGroup()->walkEntries(
+        [&entries](Entry* entry) {
+            entries.append(entry);
+            return false;
+        },
+        true);
+    QCOMPARE(entries.size(), 4);
+    QCOMPARE(entries, db->rootGroup()->entriesRecursive(true));
+
+    // the traversal ends as soon as the visitor returns true
+    int visited = 0;
+    stopped = db->rootGroup()->walkEntries([&visited, entry2](Entry* entry) {
+        ++visited;
+        return entry == entry2;
+    });
+    QVERIFY(stopped);
+    QCOMPARE(visited, 2);
+
+    visited = 0;
+    stopped = db->rootGroup()->walkGroups(
+        [&visited](const Group*) {
+            ++visited;
+            return true;
+        },
+        false);
+    QVERIFY(stopped);
+    QCOMPARE(visited, 1);
+
+    delete db;
+}
+
+void TestGroup::benchmarkWalkDeepTree()
+{
+    QByteArray env = qgetenv("BENCHMARK");
+
+    if (env.isEmpty() || env == "0" || env == "no") {
+        QSKIP("Benchmark skipped. Set env variable BENCHMARK=1 to enable.");
+    }
+
+    Database* db = new Database();
+
+    // ten levels of three child groups each holding a single entry
+    QList<Group*> level;
+    level << db->rootGroup();
+    for (int depth = 0; depth < 10; ++depth) {
+        QList<Group*> nextLevel;
+        for (Group* parent : asConst(level)) {
+            for (int i = 0; i < 3 && nextLevel.size() < 5000; ++i) {
+                Group* group = new Group();
+                group->setUuid(Uuid::random());
+                group->setName(QString("group%1").arg(i));
+                group->setParent(parent);
+
+                Entry* entry = new Entry();
+                entry->setUuid(Uuid::random());
+                entry->setTitle(QString("entry%1").arg(depth));
+                entry->setGroup(group);
+
+                nextLevel << group;
+            }
+        }
+        level = nextLevel;
+    }
+
+    Uuid uuid = level.last()->entries().first()->uuid();
+
+    QBENCHMARK
+    {
+        bool found = db->rootGroup()->walkEntries([&uuid](const Entry* entry) { return entry->uuid() == uuid; });
+        QVERIFY(found);
+    };
+
+    delete db;
+}
@@ -40,6 +40,11 @@ private slots:
     void testPrint();
     void testLocate();
     void testAddEntryWithPath();
+    void testPathIndexUpdates();
+    void testPathIndexUuidChange();
+    void testPathIndexDuplicates();
+    void testWalk();
+    void benchmarkWalkDeepTree();
 };
 
 #endif // KEEPASSX_TESTGROUP_H
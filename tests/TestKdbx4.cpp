@@ -20,6 +20,7 @@
 
 #include "config-keepassx-tests.h"
 #include "core/Metadata.h"
+#include "format/KdbxFingerprint.h"
 #include "format/KdbxXmlReader.h"
 #include "format/KdbxXmlWriter.h"
 #include "format/KeePass2.h"
@@ -426,3 +427,40 @@ QSharedPointer<Kdf> TestKdbx4::fastKdf(QSharedPointer<Kdf> kdf)
 
     return kdf;
 }
+
+void TestKdbx4::testFingerprint()
+{
+    QScopedPointer<Database> db(new Database());
+    CompositeKey key;
+    key.addKey(PasswordKey("test"));
+    db->setKey(key);
+    db->changeKdf(fastKdf(KeePass2::uuidToKdf(KeePass2::KDF_ARGON2)));
+
+    KeePass2Writer writer;
+    QBuffer buffer;
+    buffer.open(QBuffer::ReadWrite);
+    QVERIFY(writer.writeDatabase(&buffer, db.data()));
+
+    KdbxFingerprint fingerprint = KdbxFingerprint::fromDevice(&buffer);
+    QVERIFY(fingerprint.isValid());
+    QCOMPARE(fingerprint.size(), buffer.size());
+
+    // the same bytes written again have the same fingerprint
+    QBuffer copy;
+    copy.setData(buffer.data());
+    copy.open(QBuffer::ReadOnly);
+    QVERIFY(KdbxFingerprint::fromDevice(&copy) == fingerprint);
+
+    // every save randomizes the header
+    QBuffer resaved;
+    resaved.open(QBuffer::ReadWrite);
+    QVERIFY(writer.writeDatabase(&resaved, db.data()));
+    QVERIFY(KdbxFingerprint::fromDevice(&resaved) != fingerprint);
+
+    QBuffer invalid;
+    invalid.setData(QByteArray(64, 'x'));
+    invalid.open(QBuffer::ReadOnly);
+    KdbxFingerprint invalidFingerprint = KdbxFingerprint::fromDevice(&invalid);
+    QVERIFY(!invalidFingerprint.isValid());
+    QVERIFY(invalidFingerprint != invalidFingerprint);
+}
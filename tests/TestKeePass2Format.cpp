@@ -20,7 +20,9 @@
 
 #include "core/Metadata.h"
 #include "crypto/Crypto.h"
+#include "format/KdbxXmlCache.h"
 #include "format/KdbxXmlReader.h"
+#include "format/KeePass2Reader.h"
 #include "keys/PasswordKey.h"
 
 #include "FailDevice.h"
@@ -634,3 +636,120 @@ void TestKeePass2Format::testDuplicateAttachments()
     QCOMPARE(db->rootGroup()->entries()[2]->attachments()->value("c2"), attachment2);
     QCOMPARE(db->rootGroup()->entries()[2]->attachments()->value("c3"), attachment3);
 }
+
+/**
+ * Test that saving again after a change reuses the fragments of untouched
+ * entries and still produces a consistent database.
+ */
+void TestKeePass2Format::testKdbxIncrementalSave()
+{
+    QScopedPointer<Database> db(new Database());
+    db->setKey(CompositeKey());
+
+    auto group = new Group();
+    group->setUuid(Uuid::random());
+    group->setName("group");
+    group->setParent(db->rootGroup());
+
+    auto entry1 = new Entry();
+    entry1->setUuid(Uuid::random());
+    entry1->setGroup(db->rootGroup());
+    entry1->setPassword("password1");
+    entry1->attributes()->set("secret", "protected1", true);
+    entry1->attachments()->set("a", QByteArray("attachment1"));
+
+    auto entry2 = new Entry();
+    entry2->setUuid(Uuid::random());
+    entry2->setGroup(group);
+    entry2->setPassword("password2");
+    entry2->attachments()->set("b", QByteArray("attachment2"));
+
+    QBuffer buffer;
+    buffer.open(QBuffer::ReadWrite);
+    bool hasError = false;
+    QString errorString;
+    writeKdbx(&buffer, db.data(), hasError, errorString);
+    if (hasError) {
+        QFAIL(qPrintable(QString("Error while writing database: %1").arg(errorString)));
+    }
+
+    QCOMPARE(db->xmlCache()->entries.value(entry1).revision, entry1->revision());
+    QCOMPARE(db->xmlCache()->entries.value(entry2).revision, entry2->revision());
+    QCOMPARE(db->xmlCache()->groups.value(group).revision, group->revision());
+
+    const quint64 entry1Revision = entry1->revision();
+    entry2->setPassword("password3");
+    entry2->attachments()->set("c", QByteArray("attachment3"));
+    QCOMPARE(entry1->revision(), entry1Revision);
+    QVERIFY(db->xmlCache()->entries.value(entry2).revision != entry2->revision());
+
+    QBuffer buffer2;
+    buffer2.open(QBuffer::ReadWrite);
+    writeKdbx(&buffer2, db.data(), hasError, errorString);
+    if (hasError) {
+        QFAIL(qPrintable(QString("Error while writing database: %1").arg(errorString)));
+    }
+    QCOMPARE(db->xmlCache()->entries.value(entry2).revision, entry2->revision());
+
+    buffer2.seek(0);
+    QScopedPointer<Database> readDb;
+    readKdbx(&buffer2, CompositeKey(), readDb, hasError, errorString);
+    if (hasError) {
+        QFAIL(qPrintable(QString("Error while reading database: %1").arg(errorString)));
+    }
+    QVERIFY(readDb.data());
+
+    Entry* readEntry1 = readDb->rootGroup()->entries().at(0);
+    QCOMPARE(readEntry1->password(), QString("password1"));
+    QCOMPARE(readEntry1->attributes()->value("secret"), QString("protected1"));
+    QCOMPARE(readEntry1->attachments()->value("a"), QByteArray("attachment1"));
+
+    Group* readGroup = readDb->rootGroup()->children().at(0);
+    QCOMPARE(readGroup->name(), QString("group"));
+    Entry* readEntry2 = readGroup->entries().at(0);
+    QCOMPARE(readEntry2->password(), QString("password3"));
+    QCOMPARE(readEntry2->attachments()->value("b"), QByteArray("attachment2"));
+    QCOMPARE(readEntry2->attachments()->value("c"), QByteArray("attachment3"));
+}
+
+void TestKeePass2Format::testKdbxXmlOutput()
+{
+    CompositeKey key;
+    key.addKey(PasswordKey("test"));
+
+    KeePass2Reader reader;
+    reader.setSaveXml(true);
+    m_kdbxTargetBuffer.seek(0);
+    QScopedPointer<Database> db(reader.readDatabase(&m_kdbxTargetBuffer, key));
+    QVERIFY(db);
+    const QByteArray xmlData = reader.xmlData();
+
+    // streamed output is the same XML, without building the database
+    QBuffer xmlBuffer;
+    xmlBuffer.open(QIODevice::WriteOnly);
+    KeePass2Reader streamReader;
+    streamReader.setXmlOutput(&xmlBuffer);
+    m_kdbxTargetBuffer.seek(0);
+    QVERIFY(!streamReader.readDatabase(&m_kdbxTargetBuffer, key));
+    QVERIFY2(!streamReader.hasError(), qPrintable(streamReader.errorString()));
+    QCOMPARE(xmlBuffer.data(), xmlData);
+    QVERIFY(!xmlBuffer.data().contains("protectedTest"));
+
+    QBuffer plainBuffer;
+    plainBuffer.open(QIODevice::WriteOnly);
+    KeePass2Reader plainReader;
+    plainReader.setXmlOutput(&plainBuffer, true);
+    m_kdbxTargetBuffer.seek(0);
+    QVERIFY(!plainReader.readDatabase(&m_kdbxTargetBuffer, key));
+    QVERIFY2(!plainReader.hasError(), qPrintable(plainReader.errorString()));
+    QVERIFY(plainBuffer.data().contains("protectedTest"));
+
+    // the unprotected XML can be read back without the inner stream key
+    bool hasError;
+    QString errorString;
+    plainBuffer.close();
+    plainBuffer.open(QIODevice::ReadOnly);
+    QScopedPointer<Database> plainDb(readXml(&plainBuffer, true, hasError, errorString));
+    QVERIFY2(!hasError, qPrintable(errorString));
+    QCOMPARE(plainDb->rootGroup()->entries().at(0)->attributes()->value("test"), QString("protectedTest"));
+}
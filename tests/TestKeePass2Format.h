@@ -63,6 +63,8 @@ private slots:
     void testKdbxNonAsciiPasswords();
     void testKdbxDeviceFailure();
     void testDuplicateAttachments();
+    void testKdbxIncrementalSave();
+    void testKdbxXmlOutput();
 
 protected:
     virtual void initTestCaseImpl() = 0;
@@ -37,6 +37,24 @@
 QTEST_GUILESS_MAIN(TestKeys)
 Q_DECLARE_METATYPE(FileKey::Type);
 
+namespace
+{
+    /**
+     * AES-KDF that counts how often a key was actually transformed.
+     */
+    class CountingKdf : public AesKdf
+    {
+    public:
+        bool transform(const QByteArray& raw, QByteArray& result) const override
+        {
+            ++transformCount;
+            return AesKdf::transform(raw, result);
+        }
+
+        mutable int transformCount = 0;
+    };
+} // namespace
+
 void TestKeys::initTestCase()
 {
     QVERIFY(Crypto::init());
@@ -233,7 +251,10 @@ void TestKeys::benchmarkTransformKey()
 
     QBENCHMARK
     {
-        Q_UNUSED(compositeKey.transform(kdf, result));
+        // use a fresh key, the last transformation of a key is cached
+        CompositeKey freshKey;
+        freshKey.addKey(pwKey);
+        Q_UNUSED(freshKey.transform(kdf, result));
     };
 }
 
@@ -318,3 +339,50 @@ void TestKeys::testCompositeKeyComponents()
     db2.reset(reader.readDatabase(&buffer, compositeKeyDec4));
     QVERIFY(reader.hasError());
 }
+
+void TestKeys::testTransformCache()
+{
+    CompositeKey compositeKey;
+    compositeKey.addKey(PasswordKey("password"));
+
+    CountingKdf kdf;
+    kdf.setRounds(1000);
+    kdf.setSeed(QByteArray(32, '\x4B'));
+
+    QByteArray result;
+    QVERIFY(compositeKey.transform(kdf, result));
+    QCOMPARE(kdf.transformCount, 1);
+
+    QByteArray cachedResult;
+    QVERIFY(compositeKey.transform(kdf, cachedResult));
+    QCOMPARE(kdf.transformCount, 1);
+    QCOMPARE(cachedResult, result);
+
+    // copies of the key share the last transformation
+    CompositeKey copiedKey(compositeKey);
+    QVERIFY(copiedKey.transform(kdf, cachedResult));
+    QCOMPARE(kdf.transformCount, 1);
+    QCOMPARE(cachedResult, result);
+
+    // a new seed, new parameters or another key need a new transformation
+    kdf.setSeed(QByteArray(32, '\x4C'));
+    QVERIFY(compositeKey.transform(kdf, cachedResult));
+    QCOMPARE(kdf.transformCount, 2);
+    QVERIFY(cachedResult != result);
+
+    kdf.setSeed(QByteArray(32, '\x4B'));
+    kdf.setRounds(1001);
+    QVERIFY(compositeKey.transform(kdf, cachedResult));
+    QCOMPARE(kdf.transformCount, 3);
+    QVERIFY(cachedResult != result);
+
+    kdf.setRounds(1000);
+    CompositeKey otherKey;
+    otherKey.addKey(PasswordKey("other password"));
+    QVERIFY(otherKey.transform(kdf, cachedResult));
+    QCOMPARE(kdf.transformCount, 4);
+    QVERIFY(cachedResult != result);
+
+    QVERIFY(compositeKey.transform(kdf, cachedResult));
+    QCOMPARE(cachedResult, result);
+}
@@ -18,6 +18,10 @@
 #include "TestMerge.h"
 #include "TestGlobal.h"
 
+#include <QPointer>
+#include <QScopedPointer>
+
+#include "core/Merger.h"
 #include "core/Metadata.h"
 #include "crypto/Crypto.h"
 
@@ -105,6 +109,9 @@ void TestMerge::testResolveConflictNewer()
     entry1->setPassword("password");
     entry1->endUpdate();
 
+    QPointer<Entry> replacedEntry = dbDestination->rootGroup()->findEntry("entry1");
+    QVERIFY(replacedEntry);
+
     dbDestination->merge(dbSource);
 
     // sanity check
@@ -117,6 +124,9 @@ void TestMerge::testResolveConflictNewer()
     QVERIFY(entry1->group() != nullptr);
     QCOMPARE(entry1->password(), QString("password"));
 
+    // the replaced entry is deleted, not kept as a hidden child of its group
+    QVERIFY(replacedEntry.isNull());
+
     // When updating an entry, it should not end up in the
     // deleted objects.
     for (DeletedObject deletedObject : dbDestination->deletedObjects()) {
@@ -560,6 +570,118 @@ void TestMerge::testResolveGroupConflictOlder()
     delete dbSource;
 }
 
+/**
+ * Planning a merge reports the changes without touching
+ * the destination, applying the plan then performs them.
+ */
+void TestMerge::testMergePlan()
+{
+    QScopedPointer<Database> dbDestination(createTestDatabase());
+
+    QScopedPointer<Database> dbSource(new Database());
+    dbSource->setRootGroup(dbDestination->rootGroup()->clone(Entry::CloneNoFlags, Group::CloneIncludeEntries));
+
+    // Make sure the changes have a different timestamp.
+    QTest::qSleep(1);
+
+    Entry* entry1 = dbSource->rootGroup()->findEntry("entry1");
+    QVERIFY(entry1 != nullptr);
+    entry1->beginUpdate();
+    entry1->setPassword("password");
+    entry1->endUpdate();
+
+    Group* group2 = dbSource->rootGroup()->findChildByName("group2");
+    QVERIFY(group2 != nullptr);
+    Entry* entry2 = dbSource->rootGroup()->findEntry("entry2");
+    QVERIFY(entry2 != nullptr);
+    entry2->setGroup(group2);
+
+    Group* group3 = new Group();
+    group3->setName("group3");
+    group3->setUuid(Uuid::random());
+    group3->setParent(dbSource->rootGroup());
+
+    Entry* entry3 = new Entry();
+    entry3->setUuid(Uuid::random());
+    entry3->setTitle("entry3");
+    entry3->setGroup(group3);
+
+    Merger merger(dbSource.data(), dbDestination.data());
+    Merger::ChangeSet changeSet = merger.plan();
+
+    QCOMPARE(changeSet.count(Merger::EntryUpdated), 1);
+    QCOMPARE(changeSet.count(Merger::EntryMoved), 1);
+    QCOMPARE(changeSet.count(Merger::GroupAdded), 1);
+    QCOMPARE(changeSet.count(Merger::EntryAdded), 1);
+    QCOMPARE(changeSet.count(Merger::EntryDuplicated), 0);
+    QCOMPARE(changeSet.count(Merger::GroupMoved), 0);
+
+    // the destination is left untouched
+    QCOMPARE(dbDestination->rootGroup()->entriesRecursive().size(), 2);
+    QVERIFY(dbDestination->rootGroup()->findChildByName("group3") == nullptr);
+    QVERIFY(dbDestination->rootGroup()->findEntry("entry1")->password().isEmpty());
+    QCOMPARE(dbDestination->rootGroup()->findEntry("entry2")->group()->name(), QString("group1"));
+
+    QVERIFY(merger.apply(changeSet));
+
+    QCOMPARE(dbDestination->rootGroup()->entriesRecursive().size(), 3);
+    QCOMPARE(dbDestination->rootGroup()->findEntry("entry1")->password(), QString("password"));
+    QCOMPARE(dbDestination->rootGroup()->findEntry("entry2")->group()->name(), QString("group2"));
+    Group* mergedGroup3 = dbDestination->rootGroup()->findChildByName("group3");
+    QVERIFY(mergedGroup3 != nullptr);
+    QCOMPARE(mergedGroup3->entries().size(), 1);
+
+    // nothing left to do
+    QVERIFY(merger.plan().isEmpty());
+}
+
+void TestMerge::benchmarkMerge()
+{
+    QByteArray env = qgetenv("BENCHMARK");
+
+    if (env.isEmpty() || env == "0" || env == "no") {
+        QSKIP("Benchmark skipped. Set env variable BENCHMARK=1 to enable.");
+    }
+
+    QScopedPointer<Database> dbDestination(new Database());
+    for (int i = 0; i < 100; ++i) {
+        Group* group = new Group();
+        group->setName(QString("group%1").arg(i));
+        group->setUuid(Uuid::random());
+        group->setParent(dbDestination->rootGroup());
+
+        for (int j = 0; j < 100; ++j) {
+            Entry* entry = new Entry();
+            entry->setGroup(group);
+            entry->setUuid(Uuid::random());
+            entry->setTitle(QString("entry%1").arg(j));
+        }
+    }
+
+    QScopedPointer<Database> dbSource(new Database());
+    dbSource->setRootGroup(dbDestination->rootGroup()->clone(Entry::CloneNoFlags, Group::CloneIncludeEntries));
+
+    // Make sure the changes have a different timestamp.
+    QTest::qSleep(1);
+
+    // update every tenth entry and move some entries to another group in the source
+    QList<Entry*> sourceEntries = dbSource->rootGroup()->entriesRecursive();
+    for (int i = 0; i < sourceEntries.size(); i += 10) {
+        sourceEntries[i]->setPassword(QString("password%1").arg(i));
+    }
+    Group* targetGroup = dbSource->rootGroup()->children().first();
+    for (int i = 5; i < sourceEntries.size(); i += 100) {
+        sourceEntries[i]->setGroup(targetGroup);
+    }
+
+    QBENCHMARK
+    {
+        dbDestination->merge(dbSource.data());
+    };
+
+    QCOMPARE(dbDestination->rootGroup()->entriesRecursive().size(), sourceEntries.size());
+}
+
 Database* TestMerge::createTestDatabase()
 {
     Database* db = new Database();
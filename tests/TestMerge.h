@@ -42,6 +42,8 @@ private slots:
     void testUpdateGroupLocation();
     void testMergeAndSync();
     void testMergeCustomIcons();
+    void testMergePlan();
+    void benchmarkMerge();
 
 private:
     Database* createTestDatabase();
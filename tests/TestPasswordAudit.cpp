@@ -0,0 +1,156 @@
+/*
+ *  Copyright (C) 2018 KeePassXC Team <team@keepassxc.org>
+ *
+ *  This program is free software: you can redistribute it and/or modify
+ *  it under the terms of the GNU General Public License as published by
+ *  the Free Software Foundation, either version 2 or (at your option)
+ *  version 3 of the License.
+ *
+ *  This program is distributed in the hope that it will be useful,
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *  GNU General Public License for more details.
+ *
+ *  You should have received a copy of the GNU General Public License
+ *  along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#include "TestPasswordAudit.h"
+#include "TestGlobal.h"
+
+#include <QScopedPointer>
+
+#include "core/Entry.h"
+#include "core/Group.h"
+#include "core/PasswordAudit.h"
+#include "crypto/Crypto.h"
+
+QTEST_GUILESS_MAIN(TestPasswordAudit)
+
+namespace
+{
+    Entry* addEntry(Group* group, const QString& title, const QString& password)
+    {
+        Entry* entry = new Entry();
+        entry->setTitle(title);
+        entry->setPassword(password);
+        entry->setGroup(group);
+        return entry;
+    }
+} // namespace
+
+void TestPasswordAudit::initTestCase()
+{
+    QVERIFY(Crypto::init());
+}
+
+void TestPasswordAudit::testWeakAndReused()
+{
+    QScopedPointer<Group> root(new Group());
+    Group* group = new Group();
+    group->setParent(root.data());
+
+    Entry* weak = addEntry(root.data(), "weak", "password");
+    Entry* strong = addEntry(root.data(), "strong", "Wd9#kq2$Lm7!xZ4&vB1pQ");
+    Entry* shared1 = addEntry(root.data(), "shared1", "9t!Fh3@wKz8^rNc5&Yq2");
+    Entry* shared2 = addEntry(group, "shared2", "9t!Fh3@wKz8^rNc5&Yq2");
+    addEntry(group, "empty", "");
+
+    PasswordAudit audit;
+    audit.audit(root.data());
+
+    QCOMPARE(audit.passwordCount(), 4);
+    QCOMPARE(audit.uniquePasswordCount(), 3);
+    QCOMPARE(audit.weakCount(), 1);
+    QCOMPARE(audit.reusedCount(), 2);
+    QCOMPARE(audit.expiredCount(), 0);
+
+    const QList<PasswordAudit::Result> results = audit.results();
+    QCOMPARE(results.size(), 3);
+    QCOMPARE(results[0].entry, weak);
+    QVERIFY(results[0].weak);
+    QVERIFY(results[0].entropy < PasswordAudit::DefaultWeakEntropy);
+    QCOMPARE(results[1].entry, shared1);
+    QCOMPARE(results[1].reuseCount, 1);
+    QVERIFY(!results[1].weak);
+    QCOMPARE(results[2].entry, shared2);
+    QCOMPARE(results[2].reuseCount, 1);
+
+    for (const PasswordAudit::Result& result : results) {
+        QVERIFY(result.entry != strong);
+    }
+}
+
+void TestPasswordAudit::testExpired()
+{
+    QScopedPointer<Group> root(new Group());
+    Entry* entry = addEntry(root.data(), "expired", "Wd9#kq2$Lm7!xZ4&vB1pQ");
+    entry->setExpires(true);
+    entry->setExpiryTime(QDateTime::currentDateTimeUtc().addDays(-1));
+    addEntry(root.data(), "current", "9t!Fh3@wKz8^rNc5&Yq2");
+
+    PasswordAudit audit;
+    audit.audit(root.data());
+
+    QCOMPARE(audit.expiredCount(), 1);
+    QCOMPARE(audit.results().size(), 1);
+    QCOMPARE(audit.results().first().entry, entry);
+    QVERIFY(audit.results().first().expired);
+    QVERIFY(!audit.results().first().weak);
+}
+
+void TestPasswordAudit::testHistory()
+{
+    QScopedPointer<Group> root(new Group());
+    Entry* entry = addEntry(root.data(), "entry", "Wd9#kq2$Lm7!xZ4&vB1pQ");
+    Entry* other = addEntry(root.data(), "other", "9t!Fh3@wKz8^rNc5&Yq2");
+
+    // the history of an entry repeating its current password is not reuse
+    Entry* sameItem = entry->clone(Entry::CloneNoFlags);
+    entry->addHistoryItem(sameItem);
+    Entry* otherItem = entry->clone(Entry::CloneNoFlags);
+    otherItem->setPassword(other->password());
+    entry->addHistoryItem(otherItem);
+
+    PasswordAudit audit;
+    audit.audit(root.data());
+    QCOMPARE(audit.passwordCount(), 2);
+    QVERIFY(audit.results().isEmpty());
+
+    audit.setIncludeHistory(true);
+    audit.audit(root.data());
+    QCOMPARE(audit.passwordCount(), 4);
+    QCOMPARE(audit.uniquePasswordCount(), 2);
+
+    const QList<PasswordAudit::Result> results = audit.results();
+    QCOMPARE(results.size(), 2);
+    QCOMPARE(results[0].entry, otherItem);
+    QCOMPARE(results[0].owner, entry);
+    QCOMPARE(results[0].reuseCount, 1);
+    QCOMPARE(results[1].entry, other);
+    QCOMPARE(results[1].reuseCount, 1);
+}
+
+void TestPasswordAudit::benchmarkAudit()
+{
+    QByteArray env = qgetenv("BENCHMARK");
+
+    if (env.isEmpty() || env == "0" || env == "no") {
+        QSKIP("Benchmark skipped. Set env variable BENCHMARK=1 to enable.");
+    }
+
+    // 100k passwords, 10k of them used by two entries
+    QScopedPointer<Group> root(new Group());
+    for (int i = 0; i < 100000; ++i) {
+        const int n = i % 90000;
+        addEntry(root.data(), QString("entry%1").arg(i), QString("Xq%1#vL%2!").arg(n).arg(n * 7919));
+    }
+
+    PasswordAudit audit;
+    QBENCHMARK_ONCE
+    {
+        audit.audit(root.data());
+    }
+    QCOMPARE(audit.passwordCount(), 100000);
+    QCOMPARE(audit.uniquePasswordCount(), 90000);
+}
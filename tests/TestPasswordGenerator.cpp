@@ -0,0 +1,208 @@
+/*
+ *  Copyright (C) 2018 KeePassXC Team <team@keepassxc.org>
+ *
+ *  This program is free software: you can redistribute it and/or modify
+ *  it under the terms of the GNU General Public License as published by
+ *  the Free Software Foundation, either version 2 or (at your option)
+ *  version 3 of the License.
+ *
+ *  This program is distributed in the hope that it will be useful,
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *  GNU General Public License for more details.
+ *
+ *  You should have received a copy of the GNU General Public License
+ *  along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+#include "TestPasswordGenerator.h"
+#include "TestGlobal.h"
+
+#include <QSet>
+#include <cstring>
+
+#include "core/PasswordGenerator.h"
+
+QTEST_GUILESS_MAIN(TestPasswordGenerator)
+
+void TestPasswordGenerator::initTestCase()
+{
+    m_backend = new RandomBackendSeeded();
+
+    Random::createWithBackend(m_backend);
+}
+
+void TestPasswordGenerator::testGeneratePasswords()
+{
+    const QList<PasswordGenerator::GeneratorFlags> flagsList = {
+        PasswordGenerator::DefaultFlags, PasswordGenerator::GeneratorFlags(0), PasswordGenerator::ExcludeLookAlike};
+
+    for (PasswordGenerator::GeneratorFlags flags : flagsList) {
+        PasswordGenerator generator;
+        generator.setLength(20);
+        generator.setCharClasses(PasswordGenerator::LowerLetters | PasswordGenerator::UpperLetters
+                                 | PasswordGenerator::Numbers | PasswordGenerator::SpecialCharacters
+                                 | PasswordGenerator::EASCII);
+        generator.setFlags(flags);
+        QVERIFY(generator.isValid());
+
+        // the batch reads the same random numbers in the same order,
+        // so it has to produce exactly the same passwords
+        m_backend->setSeed(42);
+        QStringList expected;
+        for (int i = 0; i < 1000; ++i) {
+            expected.append(generator.generatePassword());
+        }
+
+        m_backend->setSeed(42);
+        const QStringList passwords = generator.generatePasswords(1000);
+        QCOMPARE(passwords, expected);
+    }
+
+    PasswordGenerator generator;
+    generator.setLength(8);
+    generator.setCharClasses(PasswordGenerator::DefaultCharset);
+    generator.setFlags(PasswordGenerator::DefaultFlags);
+    QVERIFY(generator.generatePasswords(0).isEmpty());
+    QCOMPARE(generator.generatePasswords(1).size(), 1);
+    QCOMPARE(generator.generatePasswords(1).first().size(), 8);
+}
+
+void TestPasswordGenerator::testCharFromEveryGroup()
+{
+    PasswordGenerator generator;
+    generator.setLength(4);
+    generator.setCharClasses(PasswordGenerator::LowerLetters | PasswordGenerator::UpperLetters
+                             | PasswordGenerator::Numbers | PasswordGenerator::SpecialCharacters);
+    generator.setFlags(PasswordGenerator::DefaultFlags);
+
+    m_backend->setSeed(1);
+    const QStringList passwords = generator.generatePasswords(10000);
+    QCOMPARE(passwords.size(), 10000);
+    for (const QString& password : passwords) {
+        QCOMPARE(password.size(), 4);
+        int lower = 0, upper = 0, numbers = 0, special = 0;
+        for (QChar ch : password) {
+            QVERIFY(ch != 'l' && ch != 'I' && ch != 'O' && ch != '0' && ch != '1' && ch != '|');
+            if (ch.isLower()) {
+                ++lower;
+            } else if (ch.isUpper()) {
+                ++upper;
+            } else if (ch.isDigit()) {
+                ++numbers;
+            } else {
+                QVERIFY(ch.unicode() >= 33 && ch.unicode() <= 126);
+                ++special;
+            }
+        }
+        QCOMPARE(lower, 1);
+        QCOMPARE(upper, 1);
+        QCOMPARE(numbers, 1);
+        QCOMPARE(special, 1);
+    }
+}
+
+void TestPasswordGenerator::testCharDistribution()
+{
+    PasswordGenerator generator;
+    generator.setLength(10);
+    generator.setCharClasses(PasswordGenerator::Numbers);
+    generator.setFlags(0);
+
+    m_backend->setSeed(2);
+    const QStringList passwords = generator.generatePasswords(100000);
+
+    QVector<int> counts(10, 0);
+    for (const QString& password : passwords) {
+        for (QChar ch : password) {
+            QVERIFY(ch.isDigit());
+            ++counts[ch.digitValue()];
+        }
+    }
+
+    // chi-square with 9 degrees of freedom, 27.88 is the 0.1% critical value
+    const double expected = 100000 * 10 / 10.0;
+    double chiSquare = 0;
+    for (int count : counts) {
+        chiSquare += (count - expected) * (count - expected) / expected;
+    }
+    QVERIFY2(chiSquare < 27.88, qPrintable(QString::number(chiSquare)));
+}
+
+void TestPasswordGenerator::testShuffleDistribution()
+{
+    // one lowercase letter and one number, the shuffle has to put the
+    // number in either position with the same probability
+    PasswordGenerator generator;
+    generator.setLength(2);
+    generator.setCharClasses(PasswordGenerator::LowerLetters | PasswordGenerator::Numbers);
+    generator.setFlags(PasswordGenerator::CharFromEveryGroup);
+
+    m_backend->setSeed(3);
+    const QStringList passwords = generator.generatePasswords(100000);
+
+    int numberFirst = 0;
+    QSet<QString> unique;
+    for (const QString& password : passwords) {
+        QVERIFY(password[0].isDigit() != password[1].isDigit());
+        if (password[0].isDigit()) {
+            ++numberFirst;
+        }
+        unique.insert(password);
+    }
+
+    // standard deviation is sqrt(100000 * 0.5 * 0.5) ~ 158, allow 4 of them
+    QVERIFY2(qAbs(numberFirst - 50000) < 632, qPrintable(QString::number(numberFirst)));
+    // 26 letters * 10 numbers * 2 orders
+    QCOMPARE(unique.size(), 520);
+}
+
+void TestPasswordGenerator::benchmarkGeneratePasswords()
+{
+    QByteArray env = qgetenv("BENCHMARK");
+
+    if (env.isEmpty() || env == "0" || env == "no") {
+        QSKIP("Benchmark skipped. Set env variable BENCHMARK=1 to enable.");
+    }
+
+    PasswordGenerator generator;
+    generator.setLength(PasswordGenerator::DefaultLength);
+    generator.setCharClasses(PasswordGenerator::DefaultCharset);
+    generator.setFlags(PasswordGenerator::DefaultFlags);
+
+    QBENCHMARK_ONCE
+    {
+        QCOMPARE(generator.generatePasswords(100000).size(), 100000);
+    }
+}
+
+RandomBackendSeeded::RandomBackendSeeded()
+    : m_state(0)
+    , m_word(0)
+    , m_wordBytes(0)
+{
+}
+
+void RandomBackendSeeded::randomize(void* data, int len)
+{
+    // splitmix64, not suitable for anything but tests; the stream of bytes
+    // doesn't depend on how it is split up into calls
+    char* charData = reinterpret_cast<char*>(data);
+    for (int i = 0; i < len; i++) {
+        if (m_wordBytes == 0) {
+            quint64 z = (m_state += Q_UINT64_C(0x9E3779B97F4A7C15));
+            z = (z ^ (z >> 30)) * Q_UINT64_C(0xBF58476D1CE4E5B9);
+            z = (z ^ (z >> 27)) * Q_UINT64_C(0x94D049BB133111EB);
+            m_word = z ^ (z >> 31);
+            m_wordBytes = 8;
+        }
+        charData[i] = static_cast<char>(m_word & 0xFF);
+        m_word >>= 8;
+        --m_wordBytes;
+    }
+}
+
+void RandomBackendSeeded::setSeed(quint64 seed)
+{
+    m_state = seed;
+    m_wordBytes = 0;
+}
@@ -0,0 +1,57 @@
+/*
+ *  Copyright (C) 2018 KeePassXC Team <team@keepassxc.org>
+ *
+ *  This program is free software: you can redistribute it and/or modify
+ *  it under the terms of the GNU General Public License as published by
+ *  the Free Software Foundation, either version 2 or (at your option)
+ *  version 3 of the License.
+ *
+ *  This program is distributed in the hope that it will be useful,
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *  GNU General Public License for more details.
+ *
+ *  You should have received a copy of the GNU General Public License
+ *  along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+#ifndef KEEPASSX_TESTPASSWORDGENERATOR_H
+#define KEEPASSX_TESTPASSWORDGENERATOR_H
+
+#include "crypto/Random.h"
+
+#include <QObject>
+
+/**
+ * Deterministic random stream, so that the same bytes can be fed to
+ * different generator code paths.
+ */
+class RandomBackendSeeded : public RandomBackend
+{
+public:
+    RandomBackendSeeded();
+    void randomize(void* data, int len) override;
+    void setSeed(quint64 seed);
+
+private:
+    quint64 m_state;
+    quint64 m_word;
+    int m_wordBytes;
+};
+
+class TestPasswordGenerator : public QObject
+{
+    Q_OBJECT
+
+private slots:
+    void initTestCase();
+    void testGeneratePasswords();
+    void testCharFromEveryGroup();
+    void testCharDistribution();
+    void testShuffleDistribution();
+    void benchmarkGeneratePasswords();
+
+private:
+    RandomBackendSeeded* m_backend;
+};
+
+#endif // KEEPASSX_TESTPASSWORDGENERATOR_H
@@ -19,6 +19,9 @@
 #include "TestGlobal.h"
 #include "core/Endian.h"
 #include "core/Global.h"
+#include "crypto/Crypto.h"
+
+#include <gcrypt.h>
 
 QTEST_GUILESS_MAIN(TestRandom)
 
@@ -69,13 +72,97 @@ void TestRandom::testUIntRange()
     QCOMPARE(randomGen()->randomUIntRange(100, 200), 142U);
 }
 
+void TestRandom::testBuffer()
+{
+    QByteArray nextBytes;
+    nextBytes.append(Endian::sizedIntToBytes(42, QSysInfo::ByteOrder));
+    nextBytes.append(Endian::sizedIntToBytes(117, QSysInfo::ByteOrder));
+    nextBytes.append(Endian::sizedIntToBytes(QUINT32_MAX, QSysInfo::ByteOrder));
+    nextBytes.append(Endian::sizedIntToBytes(5, QSysInfo::ByteOrder));
+    m_backend->setNextBytes(nextBytes);
+
+    randomGen()->setBufferSize(16);
+    QCOMPARE(randomGen()->bufferSize(), 16);
+
+    // a single refill serves all numbers, rejected ones included
+    QCOMPARE(randomGen()->randomUInt(100), 42U);
+    QCOMPARE(randomGen()->randomUInt(100), 17U);
+    QCOMPARE(randomGen()->randomUInt(100), 5U);
+    QCOMPARE(m_backend->calls(), 1);
+
+    // larger requests bypass the buffer
+    nextBytes = QByteArray(8, '\x7f');
+    m_backend->setNextBytes(nextBytes);
+    QCOMPARE(randomGen()->randomArray(8), nextBytes);
+    QCOMPARE(m_backend->calls(), 1);
+
+    // the rest of a wiped buffer is never handed out
+    nextBytes.clear();
+    nextBytes.append(Endian::sizedIntToBytes(1, QSysInfo::ByteOrder));
+    nextBytes.append(Endian::sizedIntToBytes(2, QSysInfo::ByteOrder));
+    nextBytes.append(Endian::sizedIntToBytes(3, QSysInfo::ByteOrder));
+    nextBytes.append(Endian::sizedIntToBytes(4, QSysInfo::ByteOrder));
+    m_backend->setNextBytes(nextBytes);
+    QCOMPARE(randomGen()->randomUInt(100), 1U);
+    randomGen()->wipeBuffers();
+    m_backend->setNextBytes(nextBytes);
+    QCOMPARE(randomGen()->randomUInt(100), 1U);
+    QCOMPARE(m_backend->calls(), 1);
+
+    randomGen()->setBufferSize(0);
+}
+
+void TestRandom::benchmarkUInt_data()
+{
+    QTest::addColumn<int>("bufferSize");
+    QTest::newRow("Unbuffered") << 0;
+    QTest::newRow("Buffered") << static_cast<int>(Random::DefaultBufferSize);
+}
+
+void TestRandom::benchmarkUInt()
+{
+    QByteArray env = qgetenv("BENCHMARK");
+
+    if (env.isEmpty() || env == "0" || env == "no") {
+        QSKIP("Benchmark skipped. Set env variable BENCHMARK=1 to enable.");
+    }
+
+    QFETCH(int, bufferSize);
+
+    if (!Crypto::initalized()) {
+        QVERIFY(Crypto::init());
+    }
+    m_backend->setUseGcrypt(true);
+    randomGen()->setBufferSize(bufferSize);
+
+    quint32 sum = 0;
+    QBENCHMARK
+    {
+        for (int i = 0; i < 100000; ++i) {
+            sum += randomGen()->randomUInt(62);
+        }
+    }
+    Q_UNUSED(sum);
+
+    randomGen()->setBufferSize(0);
+    m_backend->setUseGcrypt(false);
+}
+
 RandomBackendTest::RandomBackendTest()
     : m_bytesIndex(0)
+    , m_useGcrypt(false)
+    , m_calls(0)
 {
 }
 
 void RandomBackendTest::randomize(void* data, int len)
 {
+    if (m_useGcrypt) {
+        gcry_randomize(data, len, GCRY_STRONG_RANDOM);
+        return;
+    }
+
+    ++m_calls;
     QVERIFY(len <= (m_nextBytes.size() - m_bytesIndex));
 
     char* charData = reinterpret_cast<char*>(data);
@@ -91,4 +178,15 @@ void RandomBackendTest::setNextBytes(const QByteArray& nextBytes)
 {
     m_nextBytes = nextBytes;
     m_bytesIndex = 0;
+    m_calls = 0;
+}
+
+void RandomBackendTest::setUseGcrypt(bool useGcrypt)
+{
+    m_useGcrypt = useGcrypt;
+}
+
+int RandomBackendTest::calls() const
+{
+    return m_calls;
 }
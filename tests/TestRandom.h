@@ -28,10 +28,14 @@ public:
     RandomBackendTest();
     void randomize(void* data, int len) override;
     void setNextBytes(const QByteArray& nextBytes);
+    void setUseGcrypt(bool useGcrypt);
+    int calls() const;
 
 private:
     QByteArray m_nextBytes;
     int m_bytesIndex;
+    bool m_useGcrypt;
+    int m_calls;
 };
 
 class TestRandom : public QObject
@@ -42,6 +46,9 @@ private slots:
     void initTestCase();
     void testUInt();
     void testUIntRange();
+    void testBuffer();
+    void benchmarkUInt_data();
+    void benchmarkUInt();
 
 private:
     RandomBackendTest* m_backend;
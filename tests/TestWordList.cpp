@@ -0,0 +1,141 @@
+/*
+ *  Copyright (C) 2018 KeePassXC Team <team@keepassxc.org>
+ *
+ *  This program is free software: you can redistribute it and/or modify
+ *  it under the terms of the GNU General Public License as published by
+ *  the Free Software Foundation, either version 2 or (at your option)
+ *  version 3 of the License.
+ *
+ *  This program is distributed in the hope that it will be useful,
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *  GNU General Public License for more details.
+ *
+ *  You should have received a copy of the GNU General Public License
+ *  along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#include "TestWordList.h"
+#include "TestGlobal.h"
+
+#include <QBuffer>
+#include <QTemporaryFile>
+
+#include "core/PassphraseGenerator.h"
+#include "core/WordList.h"
+#include "crypto/Crypto.h"
+
+QTEST_GUILESS_MAIN(TestWordList)
+
+void TestWordList::initTestCase()
+{
+    QVERIFY(Crypto::init());
+
+    for (int i = 0; i < 5000; ++i) {
+        m_words << QString("word%1").arg(i);
+    }
+    m_words << QString::fromUtf8("\xc3\xbcber");
+}
+
+void TestWordList::testTextWordList()
+{
+    QTemporaryFile file;
+    QVERIFY(file.open());
+    // blank lines and carriage returns are skipped
+    file.write(m_words.mid(0, 10).join("\r\n").toUtf8() + "\n\n");
+    file.write(m_words.mid(10).join("\n").toUtf8());
+    file.close();
+
+    QSharedPointer<const WordList> wordList = WordList::load(file.fileName());
+    QVERIFY(wordList);
+    QVERIFY(!wordList->isMapped());
+    QCOMPARE(wordList->size(), m_words.size());
+    for (int i = 0; i < m_words.size(); ++i) {
+        QCOMPARE(wordList->word(i), m_words.at(i));
+    }
+
+    // loaded once for all generators
+    QCOMPARE(WordList::load(file.fileName()), wordList);
+}
+
+void TestWordList::testCompiledWordList()
+{
+    QTemporaryFile textFile;
+    QVERIFY(textFile.open());
+    textFile.write(m_words.join("\n").toUtf8());
+    textFile.close();
+
+    QSharedPointer<const WordList> textWordList = WordList::load(textFile.fileName());
+    QVERIFY(textWordList);
+
+    QTemporaryFile compiledFile;
+    QVERIFY(compiledFile.open());
+    QVERIFY(textWordList->writeCompiled(&compiledFile));
+    compiledFile.close();
+
+    QSharedPointer<const WordList> wordList = WordList::load(compiledFile.fileName());
+    QVERIFY(wordList);
+    QVERIFY(wordList->isMapped());
+    QCOMPARE(wordList->size(), m_words.size());
+    for (int i = 0; i < m_words.size(); ++i) {
+        QCOMPARE(wordList->word(i), m_words.at(i));
+    }
+}
+
+void TestWordList::testInvalidWordList()
+{
+    QVERIFY(!WordList::load("/nonexistent/wordlist"));
+
+    QTemporaryFile textFile;
+    QVERIFY(textFile.open());
+    textFile.write(m_words.mid(0, 100).join("\n").toUtf8());
+    textFile.close();
+    QSharedPointer<const WordList> textWordList = WordList::load(textFile.fileName());
+    QVERIFY(textWordList);
+
+    QBuffer buffer;
+    buffer.open(QIODevice::WriteOnly);
+    QVERIFY(textWordList->writeCompiled(&buffer));
+
+    // an offset pointing past the end of the words
+    QByteArray data = buffer.data();
+    data[16 + 4 * 50] = '\xff';
+    data[16 + 4 * 50 + 1] = '\xff';
+
+    QTemporaryFile compiledFile;
+    QVERIFY(compiledFile.open());
+    compiledFile.write(data);
+    compiledFile.close();
+    QVERIFY(!WordList::load(compiledFile.fileName()));
+
+    // truncated offsets table
+    QTemporaryFile truncatedFile;
+    QVERIFY(truncatedFile.open());
+    truncatedFile.write(buffer.data().left(100));
+    truncatedFile.close();
+    QVERIFY(!WordList::load(truncatedFile.fileName()));
+}
+
+void TestWordList::testGeneratePassphrases()
+{
+    QTemporaryFile file;
+    QVERIFY(file.open());
+    file.write(m_words.join("\n").toUtf8());
+    file.close();
+
+    PassphraseGenerator generator;
+    generator.setWordCount(4);
+    generator.setWordSeparator("-");
+    generator.setWordList(file.fileName());
+    QVERIFY(generator.isValid());
+
+    const QStringList passphrases = generator.generatePassphrases(100);
+    QCOMPARE(passphrases.size(), 100);
+    for (const QString& passphrase : passphrases) {
+        const QStringList words = passphrase.split("-");
+        QCOMPARE(words.size(), 4);
+        for (const QString& word : words) {
+            QVERIFY(m_words.contains(word));
+        }
+    }
+}
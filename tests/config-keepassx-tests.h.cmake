@@ -4,6 +4,7 @@
 #define KEEPASSX_CONFIG_TESTS_H
 
 #define KEEPASSX_TEST_DATA_DIR "${KEEPASSX_TEST_DATA_DIR}"
+#define KEEPASSXC_CLI_PATH "${KEEPASSXC_CLI_PATH}"
 
 #cmakedefine WITH_XC_AUTOTYPE
 #cmakedefine WITH_XC_YUBIKEY